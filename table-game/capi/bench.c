@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2017, Ivan
+ * 
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//!
+//! \file bench.c
+//! \brief Measures cost of one embedded solve: board creation, solving,
+//! reading every sequence and releasing, averaged over many calls.
+//! Usage: tg-bench PUZZLE_FILE [ITERATIONS]
+//!
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "table_game.h"
+
+static double Now (void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static char * ReadFile (const char * filename, size_t * length)
+{
+    FILE * file = fopen(filename, "rb");
+    if (file == NULL)
+    {
+        return NULL;
+    }
+
+    size_t capacity = 4096;
+    char * text = malloc(capacity);
+    *length = 0;
+    size_t red;
+    while ((text != NULL) &&
+           (red = fread(text + *length, 1, capacity - *length, file)) > 0)
+    {
+        *length += red;
+        if (*length == capacity)
+        {
+            capacity *= 2;
+            char * bigger = realloc(text, capacity);
+            if (bigger == NULL)
+            {
+                free(text);
+            }
+            text = bigger;
+        }
+    }
+    fclose(file);
+    return text;
+}
+
+int main (int argc, char ** argv)
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "Usage: %s PUZZLE_FILE [ITERATIONS]\n", argv[0]);
+        return 2;
+    }
+    long iterations = (argc > 2) ? atol(argv[2]) : 1000;
+    if (iterations <= 0)
+    {
+        iterations = 1;
+    }
+
+    size_t length = 0;
+    char * text = ReadFile(argv[1], &length);
+    if (text == NULL)
+    {
+        fprintf(stderr, "Cannot read %s\n", argv[1]);
+        return 2;
+    }
+
+    uint8_t moves[1024];
+    size_t sequences = 0;
+    double solve_time = 0;
+    double start = Now();
+
+    for (long i=0; i<iterations; ++i)
+    {
+        char error[256];
+        tg_board * board = NULL;
+        tg_status status = tg_board_create(text, length, &board,
+                                           error, sizeof(error));
+        if (status != TG_OK)
+        {
+            fprintf(stderr, "%s: %s\n", tg_status_string(status), error);
+            free(text);
+            return 1;
+        }
+
+        tg_result * result = NULL;
+        double solve_start = Now();
+        status = tg_solve(board, NULL, &result);
+        solve_time += Now() - solve_start;
+        if (result == NULL)
+        {
+            fprintf(stderr, "%s\n", tg_status_string(status));
+            tg_board_free(board);
+            free(text);
+            return 1;
+        }
+
+        sequences = tg_result_count(result);
+        for (size_t j=0; j<sequences; ++j)
+        {
+            size_t written = 0;
+            tg_result_get(result, j, moves, sizeof(moves), &written);
+        }
+
+        tg_result_free(result);
+        tg_board_free(board);
+    }
+
+    double total = Now() - start;
+    free(text);
+
+    printf("iterations: %ld\n", iterations);
+    printf("sequences: %zu\n", sequences);
+    printf("per call, us: %.3f\n", total * 1e6 / (double)iterations);
+    printf("solve, us: %.3f\n", solve_time * 1e6 / (double)iterations);
+    printf("overhead, us: %.3f\n",
+           (total - solve_time) * 1e6 / (double)iterations);
+    return 0;
+}
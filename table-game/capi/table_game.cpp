@@ -0,0 +1,481 @@
+/*
+ * Copyright (c) 2017, Ivan
+ * 
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "table_game.h"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "file_ops.h"
+#include "input.h"
+#include "table.h"
+#include "tablebase.h"
+#include "thread_pool.h"
+#include "tg_utils.h"
+
+struct tg_board
+{
+    explicit tg_board (const input_data_t & data)
+        : in(data)
+    {}
+
+    InputData in; //!< validated puzzle
+};
+
+struct tg_tablebase
+{
+    explicit tg_tablebase (const std::string & filename)
+        : tablebase(filename)
+    {}
+
+    Tablebase tablebase; //!< mapped tablebase file
+};
+
+struct tg_result
+{
+    tg_status status; //!< solving status
+    size_t count;     //!< moves sequences count
+    size_t length;    //!< moves in every sequence
+    std::vector <uint8_t> moves; //!< all the sequences one after another
+};
+
+namespace
+{
+
+//!
+//! \brief CopyError Copy error description to caller buffer, truncating it
+//!
+void CopyError (const std::string & message, char * error, size_t error_size)
+{
+    if ((error == nullptr) || (error_size == 0))
+    {
+        return;
+    }
+    size_t length = std::min(message.size(), error_size - 1);
+    std::memcpy(error, message.data(), length);
+    error[length] = '\0';
+}
+
+//!
+//! \brief CreateBoard Validate parsed numbers and create board
+//!
+tg_status CreateBoard (const input_data_t & data, tg_board ** board,
+                       char * error, size_t error_size)
+{
+    tg_board * created = new tg_board(data);
+    if (created->in.GetDataStatus() != InputData::Status::Ok)
+    {
+        CopyError(created->in.GetErrorString(), error, error_size);
+        delete created;
+        return TG_INVALID_INPUT;
+    }
+    *board = created;
+    return TG_OK;
+}
+
+//!
+//! \brief ReadOptions Merge caller options over defaults. Fields beyond
+//! caller structure size keep default values
+//!
+tg_status ReadOptions (const tg_options * options, tg_options & merged)
+{
+    tg_options_init(&merged);
+    if (options == nullptr)
+    {
+        return TG_OK;
+    }
+    if (options->size < sizeof(options->size))
+    {
+        return TG_INVALID_ARGUMENT;
+    }
+
+    std::memcpy(&merged, options, std::min(options->size, sizeof(merged)));
+    merged.size = sizeof(merged);
+
+    switch (merged.algorithm)
+    {
+    case TG_ALGORITHM_AUTO:
+    case TG_ALGORITHM_SEARCH:
+        return TG_OK;
+    case TG_ALGORITHM_TABLEBASE:
+        return (merged.tablebase == nullptr) ? TG_INVALID_ARGUMENT : TG_OK;
+    }
+    return TG_INVALID_ARGUMENT;
+}
+
+//!
+//! \brief Solve Solve one puzzle with already checked options
+//!
+tg_status Solve (const tg_board & board, const tg_options & options,
+                 tg_result ** result)
+{
+    const Tablebase * tablebase = nullptr;
+    if ((options.algorithm != TG_ALGORITHM_SEARCH) &&
+        (options.tablebase != nullptr) &&
+        options.tablebase->tablebase.Matches(board.in))
+    {
+        tablebase = &options.tablebase->tablebase;
+    }
+    if ((options.algorithm == TG_ALGORITHM_TABLEBASE) && (tablebase == nullptr))
+    {
+        return TG_INVALID_ARGUMENT;
+    }
+
+    GameTable table (board.in);
+    table.SetTablebase(tablebase);
+    table.SetSearchLimits({options.max_moves, options.max_states});
+    table.CalculateMoves();
+
+    tg_result * created = new tg_result;
+    const auto & moves = table.GetMoves();
+    created->count = moves.size();
+    created->length = moves.empty() ? 0 : moves.front().size();
+    created->moves.reserve(created->count * created->length);
+    for (const auto & sequence : moves)
+    {
+        for (auto move : sequence)
+        {
+            created->moves.push_back(static_cast<uint8_t>(move));
+        }
+    }
+
+    if (! moves.empty())
+    {
+        created->status = TG_OK;
+    }
+    else
+    {
+        created->status = table.IsLimitReached() ? TG_LIMIT_REACHED
+                                                 : TG_NO_SOLUTION;
+    }
+
+    *result = created;
+    return created->status;
+}
+
+//!
+//! \brief SolveNoThrow Solve one puzzle, converting exceptions to status
+//!
+tg_status SolveNoThrow (const tg_board & board, const tg_options & options,
+                        tg_result ** result)
+{
+    try
+    {
+        return Solve(board, options, result);
+    }
+    catch (const std::bad_alloc &)
+    {
+        return TG_NO_MEMORY;
+    }
+    catch (...)
+    {
+        return TG_INTERNAL_ERROR;
+    }
+}
+
+} // namespace
+
+unsigned tg_api_version()
+{
+    return TG_API_VERSION;
+}
+
+const char * tg_status_string(tg_status status)
+{
+    switch (status)
+    {
+    case TG_OK:
+        return "Puzzle is solved";
+    case TG_NO_SOLUTION:
+        return "Puzzle has no solution";
+    case TG_LIMIT_REACHED:
+        return "Search limit is reached";
+    case TG_INVALID_INPUT:
+        return "Input data is invalid";
+    case TG_INVALID_ARGUMENT:
+        return "Invalid argument";
+    case TG_OUT_OF_RANGE:
+        return "Index is out of range";
+    case TG_BUFFER_TOO_SMALL:
+        return "Buffer is too small";
+    case TG_CANNOT_OPEN:
+        return "File cannot be opened";
+    case TG_NO_MEMORY:
+        return "Out of memory";
+    case TG_INTERNAL_ERROR:
+        return "Internal error";
+    }
+    return "Unknown status";
+}
+
+void tg_options_init(tg_options *options)
+{
+    if (options == nullptr)
+    {
+        return;
+    }
+    options->size = sizeof(tg_options);
+    options->algorithm = TG_ALGORITHM_AUTO;
+    options->threads = 0;
+    options->max_moves = 0;
+    options->max_states = 0;
+    options->tablebase = nullptr;
+}
+
+tg_status tg_board_create(const char *text, size_t length, tg_board **board,
+                          char *error, size_t error_size)
+{
+    if ((board == nullptr) || ((text == nullptr) && (length != 0)))
+    {
+        return TG_INVALID_ARGUMENT;
+    }
+    *board = nullptr;
+
+    try
+    {
+        input_data_t data;
+        const char * end = text + length;
+        if (ParseCoordinates(text, end, data) != end)
+        {
+            CopyError("Input data contains not a number.", error, error_size);
+            return TG_INVALID_INPUT;
+        }
+        return CreateBoard(data, board, error, error_size);
+    }
+    catch (const std::bad_alloc &)
+    {
+        return TG_NO_MEMORY;
+    }
+    catch (...)
+    {
+        return TG_INTERNAL_ERROR;
+    }
+}
+
+tg_status tg_board_create_from_values(const uint32_t *values, size_t count,
+                                      tg_board **board,
+                                      char *error, size_t error_size)
+{
+    if ((board == nullptr) || ((values == nullptr) && (count != 0)))
+    {
+        return TG_INVALID_ARGUMENT;
+    }
+    *board = nullptr;
+
+    try
+    {
+        return CreateBoard(input_data_t(values, values + count), board,
+                           error, error_size);
+    }
+    catch (const std::bad_alloc &)
+    {
+        return TG_NO_MEMORY;
+    }
+    catch (...)
+    {
+        return TG_INTERNAL_ERROR;
+    }
+}
+
+void tg_board_free(tg_board *board)
+{
+    delete board;
+}
+
+tg_status tg_tablebase_open(const char *filename, tg_tablebase **tablebase)
+{
+    if ((filename == nullptr) || (tablebase == nullptr))
+    {
+        return TG_INVALID_ARGUMENT;
+    }
+    *tablebase = nullptr;
+
+    try
+    {
+        tg_tablebase * opened = new tg_tablebase(filename);
+        if (opened->tablebase.GetStatus() != Tablebase::Status::Ok)
+        {
+            delete opened;
+            return TG_CANNOT_OPEN;
+        }
+        *tablebase = opened;
+        return TG_OK;
+    }
+    catch (const std::bad_alloc &)
+    {
+        return TG_NO_MEMORY;
+    }
+    catch (...)
+    {
+        return TG_INTERNAL_ERROR;
+    }
+}
+
+void tg_tablebase_free(tg_tablebase *tablebase)
+{
+    delete tablebase;
+}
+
+tg_status tg_solve(const tg_board *board, const tg_options *options,
+                   tg_result **result)
+{
+    if ((board == nullptr) || (result == nullptr))
+    {
+        return TG_INVALID_ARGUMENT;
+    }
+    *result = nullptr;
+
+    tg_options merged;
+    tg_status status = ReadOptions(options, merged);
+    if (status != TG_OK)
+    {
+        return status;
+    }
+    return SolveNoThrow(*board, merged, result);
+}
+
+tg_status tg_solve_batch(const tg_board * const *boards, size_t count,
+                         const tg_options *options, tg_result **results)
+{
+    if (((boards == nullptr) || (results == nullptr)) && (count != 0))
+    {
+        return TG_INVALID_ARGUMENT;
+    }
+    for (size_t i=0; i<count; ++i)
+    {
+        if (boards[i] == nullptr)
+        {
+            return TG_INVALID_ARGUMENT;
+        }
+        results[i] = nullptr;
+    }
+
+    tg_options merged;
+    tg_status status = ReadOptions(options, merged);
+    if ((status != TG_OK) || (count == 0))
+    {
+        return status;
+    }
+
+    try
+    {
+        std::vector <tg_status> statuses (count, TG_OK);
+        {
+            ThreadPool pool (std::min<size_t>(merged.threads, count));
+            for (size_t i=0; i<count; ++i)
+            {
+                pool.Submit([&, i] ()
+                {
+                    statuses[i] = SolveNoThrow(*boards[i], merged, &results[i]);
+                });
+            }
+            pool.Wait();
+        }
+
+        // puzzle statuses are kept by results, only failures are reported
+        for (size_t i=0; i<count; ++i)
+        {
+            if (results[i] == nullptr)
+            {
+                status = statuses[i];
+                break;
+            }
+        }
+    }
+    catch (const std::bad_alloc &)
+    {
+        status = TG_NO_MEMORY;
+    }
+    catch (...)
+    {
+        status = TG_INTERNAL_ERROR;
+    }
+
+    if (status != TG_OK)
+    {
+        for (size_t i=0; i<count; ++i)
+        {
+            tg_result_free(results[i]);
+            results[i] = nullptr;
+        }
+    }
+    return status;
+}
+
+tg_status tg_result_status(const tg_result *result)
+{
+    return (result == nullptr) ? TG_INVALID_ARGUMENT : result->status;
+}
+
+size_t tg_result_count(const tg_result *result)
+{
+    return (result == nullptr) ? 0 : result->count;
+}
+
+size_t tg_result_length(const tg_result *result)
+{
+    return (result == nullptr) ? 0 : result->length;
+}
+
+tg_status tg_result_get(const tg_result *result, size_t index,
+                        uint8_t *moves, size_t capacity, size_t *length)
+{
+    if ((result == nullptr) || ((moves == nullptr) && (capacity != 0)))
+    {
+        return TG_INVALID_ARGUMENT;
+    }
+    if (index >= result->count)
+    {
+        return TG_OUT_OF_RANGE;
+    }
+    if (length != nullptr)
+    {
+        *length = result->length;
+    }
+    if (capacity < result->length)
+    {
+        return TG_BUFFER_TOO_SMALL;
+    }
+    if (result->length != 0)
+    {
+        std::memcpy(moves, result->moves.data() + index * result->length,
+                    result->length);
+    }
+    return TG_OK;
+}
+
+void tg_result_free(tg_result *result)
+{
+    delete result;
+}
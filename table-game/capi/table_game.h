@@ -0,0 +1,261 @@
+/*
+ * Copyright (c) 2017, Ivan
+ * 
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TG_CAPI_TABLE_GAME_H
+#define TG_CAPI_TABLE_GAME_H
+
+//!
+//! \file table_game.h
+//! \brief Plain C interface of the solver, exported by libtablegame.
+//! Every structure is either opaque or starts with its own size, so the
+//! binary interface stays the same when fields are added. Functions never
+//! throw, errors are reported by %tg_status codes
+//!
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(TG_BUILDING_LIBRARY) && defined(__GNUC__)
+#define TG_API __attribute__((visibility("default")))
+#else
+#define TG_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//!
+//! \brief TG_API_VERSION Version of the interface described by this header
+//!
+#define TG_API_VERSION 1
+
+//!
+//! \brief The tg_status enum Result codes of all the functions
+//!
+typedef enum tg_status
+{
+    TG_OK = 0,               //!< success, puzzle is solved
+    TG_NO_SOLUTION = 1,      //!< input is valid, but game can not be won
+    TG_LIMIT_REACHED = 2,    //!< search was stopped by %tg_options limits
+    TG_INVALID_INPUT = 3,    //!< puzzle failed validation
+    TG_INVALID_ARGUMENT = 4, //!< null pointer or bad option passed
+    TG_OUT_OF_RANGE = 5,     //!< result index is too big
+    TG_BUFFER_TOO_SMALL = 6, //!< caller buffer can not hold the moves
+    TG_CANNOT_OPEN = 7,      //!< file is missing or damaged
+    TG_NO_MEMORY = 8,        //!< allocation failed
+    TG_INTERNAL_ERROR = 9    //!< unexpected failure inside the library
+} tg_status;
+
+//!
+//! \brief The tg_direction enum Values of moves written by %tg_result_get
+//!
+typedef enum tg_direction
+{
+    TG_NORTH = 0,
+    TG_WEST = 1,
+    TG_SOUTH = 2,
+    TG_EAST = 3
+} tg_direction;
+
+//!
+//! \brief The tg_algorithm enum How puzzle is solved
+//!
+typedef enum tg_algorithm
+{
+    TG_ALGORITHM_AUTO = 0,     //!< tablebase if it matches board, else search
+    TG_ALGORITHM_SEARCH = 1,   //!< always search, tablebase is ignored
+    TG_ALGORITHM_TABLEBASE = 2 //!< tablebase is required to match the board
+} tg_algorithm;
+
+typedef struct tg_board tg_board;         //!< parsed and validated puzzle
+typedef struct tg_result tg_result;       //!< moves sequences of one puzzle
+typedef struct tg_tablebase tg_tablebase; //!< opened tablebase file
+
+//!
+//! \brief The tg_options struct Solving options. Always fill it by
+//! %tg_options_init before changing fields
+//!
+typedef struct tg_options
+{
+    size_t size;               //!< sizeof(tg_options) of the caller
+    tg_algorithm algorithm;    //!< solving algorithm
+    unsigned threads;          //!< workers of %tg_solve_batch, 0 - all cores
+    size_t max_moves;          //!< longest solution searched, 0 - no limit
+    size_t max_states;         //!< visited states bound, 0 - no limit
+    const tg_tablebase * tablebase; //!< tablebase to be used, may be NULL
+} tg_options;
+
+//!
+//! \brief tg_api_version Version of the loaded library
+//! \return TG_API_VERSION the library was built with
+//!
+TG_API unsigned tg_api_version (void);
+
+//!
+//! \brief tg_status_string Human readable description of status
+//! \param status status code
+//! \return static string, never NULL
+//!
+TG_API const char * tg_status_string (tg_status status);
+
+//!
+//! \brief tg_options_init Fill options with defaults: automatic algorithm,
+//! all cores, no limits, no tablebase
+//! \param options options to be filled
+//!
+TG_API void tg_options_init (tg_options * options);
+
+//!
+//! \brief tg_board_create Parse puzzle from text buffer in the input file
+//! format and validate it
+//! \param text buffer with whitespace separated numbers, not required to be
+//! null terminated
+//! \param length buffer length in bytes
+//! \param board created board, NULL on failure. Free by %tg_board_free
+//! \param error buffer for error description, may be NULL
+//! \param error_size size of error buffer
+//! \return TG_OK or TG_INVALID_INPUT
+//!
+TG_API tg_status tg_board_create (const char * text, size_t length,
+                                  tg_board ** board,
+                                  char * error, size_t error_size);
+
+//!
+//! \brief tg_board_create_from_values Same as %tg_board_create for already
+//! parsed numbers
+//! \param values puzzle numbers in the input file order
+//! \param count numbers count
+//! \param board created board, NULL on failure. Free by %tg_board_free
+//! \param error buffer for error description, may be NULL
+//! \param error_size size of error buffer
+//! \return TG_OK or TG_INVALID_INPUT
+//!
+TG_API tg_status tg_board_create_from_values (const uint32_t * values,
+                                              size_t count, tg_board ** board,
+                                              char * error, size_t error_size);
+
+//!
+//! \brief tg_board_free Release board, NULL is ignored
+//! \param board board to be released
+//!
+TG_API void tg_board_free (tg_board * board);
+
+//!
+//! \brief tg_tablebase_open Open tablebase file built by
+//! `table_game --build-tablebase`
+//! \param filename path to tablebase
+//! \param tablebase opened tablebase, NULL on failure. Free by
+//! %tg_tablebase_free after all the solving using it is finished
+//! \return TG_OK or TG_CANNOT_OPEN
+//!
+TG_API tg_status tg_tablebase_open (const char * filename,
+                                    tg_tablebase ** tablebase);
+
+//!
+//! \brief tg_tablebase_free Release tablebase, NULL is ignored
+//! \param tablebase tablebase to be released
+//!
+TG_API void tg_tablebase_free (tg_tablebase * tablebase);
+
+//!
+//! \brief tg_solve Find all the shortest moves sequences of the puzzle.
+//! Safe to be called from several threads at once
+//! \param board puzzle to be solved
+//! \param options solving options, NULL for defaults
+//! \param result created result, also for TG_NO_SOLUTION and
+//! TG_LIMIT_REACHED, when it has no sequences. Free by %tg_result_free
+//! \return TG_OK, TG_NO_SOLUTION, TG_LIMIT_REACHED or error
+//!
+TG_API tg_status tg_solve (const tg_board * board, const tg_options * options,
+                           tg_result ** result);
+
+//!
+//! \brief tg_solve_batch Solve several puzzles using %tg_options threads
+//! \param boards puzzles to be solved
+//! \param count puzzles count
+//! \param options solving options, NULL for defaults
+//! \param results array of count results filled in boards order, status of
+//! every puzzle is given by %tg_result_status
+//! \return TG_OK if all the results were created, error otherwise
+//!
+TG_API tg_status tg_solve_batch (const tg_board * const * boards, size_t count,
+                                 const tg_options * options,
+                                 tg_result ** results);
+
+//!
+//! \brief tg_result_status Status of solving, same as returned by %tg_solve
+//! \param result solving result
+//! \return solving status
+//!
+TG_API tg_status tg_result_status (const tg_result * result);
+
+//!
+//! \brief tg_result_count Count of found moves sequences
+//! \param result solving result
+//! \return sequences count, 0 if puzzle is not solved
+//!
+TG_API size_t tg_result_count (const tg_result * result);
+
+//!
+//! \brief tg_result_length Moves count of every found sequence, all of them
+//! have the same length
+//! \param result solving result
+//! \return moves count, 0 if puzzle is not solved
+//!
+TG_API size_t tg_result_length (const tg_result * result);
+
+//!
+//! \brief tg_result_get Copy one moves sequence to caller buffer as
+//! %tg_direction values
+//! \param result solving result
+//! \param index sequence index, less than %tg_result_count
+//! \param moves caller buffer, may be NULL if capacity is 0
+//! \param capacity buffer size
+//! \param length moves count of the sequence, set also when buffer is too
+//! small. May be NULL
+//! \return TG_OK, TG_OUT_OF_RANGE or TG_BUFFER_TOO_SMALL
+//!
+TG_API tg_status tg_result_get (const tg_result * result, size_t index,
+                                uint8_t * moves, size_t capacity,
+                                size_t * length);
+
+//!
+//! \brief tg_result_free Release result, NULL is ignored
+//! \param result result to be released
+//!
+TG_API void tg_result_free (tg_result * result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TG_CAPI_TABLE_GAME_H
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2017, Ivan
+ * 
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "arena.h"
+
+#include <cstdint>
+
+namespace
+{
+
+//! \brief current_arena current arena of the thread
+thread_local Arena * current_arena = nullptr;
+
+}
+
+Arena::Arena(size_t chunk_size)
+    : current_(0)
+    , offset_(0)
+    , used_(0)
+    , chunk_size_(chunk_size)
+{
+}
+
+Arena::~Arena()
+{
+    for (auto chunk : chunks_)
+    {
+        ::operator delete(chunk.data);
+    }
+}
+
+void *Arena::Allocate(size_t size, size_t alignment)
+{
+    while (current_ < chunks_.size())
+    {
+        Chunk & chunk = chunks_[current_];
+        std::uintptr_t base = reinterpret_cast<std::uintptr_t>(chunk.data);
+        std::uintptr_t aligned = (base + offset_ + alignment - 1) & ~(alignment - 1);
+        size_t start = aligned - base;
+
+        if (start + size <= chunk.size)
+        {
+            offset_ = start + size;
+            return chunk.data + start;
+        }
+
+        // chunk is full, go to the next one
+        used_ += offset_;
+        offset_ = 0;
+        ++current_;
+    }
+
+    // no more chunks, take new one from global heap
+    size_t chunk_size = chunks_.empty() ? chunk_size_ : chunks_.back().size * 2;
+    while (chunk_size < size + alignment)
+    {
+        chunk_size *= 2;
+    }
+
+    Chunk chunk = { static_cast<char*>(::operator new(chunk_size)), chunk_size };
+    chunks_.push_back(chunk);
+    current_ = chunks_.size() - 1;
+
+    return Allocate(size, alignment);
+}
+
+void Arena::Release()
+{
+    current_ = 0;
+    offset_ = 0;
+    used_ = 0;
+}
+
+size_t Arena::GetUsed() const
+{
+    return used_ + offset_;
+}
+
+size_t Arena::GetReserved() const
+{
+    size_t reserved = 0;
+    for (auto chunk : chunks_)
+    {
+        reserved += chunk.size;
+    }
+    return reserved;
+}
+
+Arena *Arena::GetCurrent()
+{
+    return current_arena;
+}
+
+Arena::Scope::Scope(Arena *arena)
+    : previous_(current_arena)
+{
+    current_arena = arena;
+}
+
+Arena::Scope::~Scope()
+{
+    current_arena = previous_;
+}
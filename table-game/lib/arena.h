@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) 2017, Ivan
+ * 
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TG_ARENA_H
+#define TG_ARENA_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+//!
+//! \brief The Arena class Monotonic memory arena. Memory is taken from big
+//! chunks by moving a pointer and is never freed piece by piece: everything
+//! allocated from the arena is dropped at once by %Release(). Chunks are kept
+//! and reused by next allocations.
+//!
+//! Every thread has its current arena (none by default), see %Scope.
+//!
+class Arena
+{
+public:
+    //!
+    //! \brief Arena Create empty arena. No memory is taken until first
+    //! allocation
+    //! \param chunk_size size of the first chunk. Every next chunk is twice
+    //! bigger than previous one
+    //!
+    explicit Arena (size_t chunk_size = 64 * 1024);
+    ~Arena ();
+
+    Arena (const Arena &) = delete;
+    Arena & operator= (const Arena &) = delete;
+
+    //!
+    //! \brief Allocate Take memory block from the arena
+    //! \param size block size
+    //! \param alignment block alignment, power of two
+    //! \return pointer to the block
+    //!
+    void * Allocate (size_t size, size_t alignment);
+
+    //!
+    //! \brief Release Drop all allocated blocks in one operation.
+    //! Objects placed in the arena must be destroyed before. Memory is kept
+    //! for next allocations
+    //!
+    void Release ();
+
+    //!
+    //! \brief GetUsed Amount of memory given out since last release
+    //! \return bytes used
+    //!
+    size_t GetUsed () const;
+
+    //!
+    //! \brief GetReserved Amount of memory held by the arena
+    //! \return bytes reserved
+    //!
+    size_t GetReserved () const;
+
+    //!
+    //! \brief GetCurrent Current arena of calling thread
+    //! \return current arena, nullptr if global heap is used
+    //!
+    static Arena * GetCurrent ();
+
+    //!
+    //! \brief The Scope class Makes arena current for calling thread while
+    //! scope is alive. Previous current arena is restored on exit.
+    //! nullptr scope switches back to global heap
+    //!
+    class Scope
+    {
+    public:
+        //!
+        //! \brief Scope make arena current
+        //! \param arena arena to use, nullptr for global heap
+        //!
+        explicit Scope (Arena * arena);
+        ~Scope ();
+
+        Scope (const Scope &) = delete;
+        Scope & operator= (const Scope &) = delete;
+
+    private:
+        //! \brief previous_ arena to be restored
+        Arena * previous_;
+    };
+
+private:
+    //!
+    //! \brief The Chunk struct Memory block arena allocates from
+    //!
+    struct Chunk
+    {
+        char * data;  //!< block of memory
+        size_t size;  //!< block size
+    };
+
+    //! \brief chunks_ all chunks held by the arena
+    std::vector <Chunk> chunks_;
+
+    //! \brief current_ index of the chunk allocations are taken from
+    size_t current_;
+
+    //! \brief offset_ first free byte in current chunk
+    size_t offset_;
+
+    //! \brief used_ bytes in chunks filled before the current one
+    size_t used_;
+
+    //! \brief chunk_size_ size of the first chunk
+    size_t chunk_size_;
+};
+
+//!
+//! \brief The ArenaAllocator class STL allocator taking memory from an
+//! arena. Arena is chosen at run time: default constructed allocator and
+//! every container copy use current arena of the thread (see
+//! %Arena::Scope), same as polymorphic allocators fall back to default
+//! memory resource. Without arena global heap is used.
+//!
+//! Deallocation from arena is no-op, memory comes back on %Arena::Release()
+//!
+template <typename T>
+class ArenaAllocator
+{
+public:
+    //! \brief value_type allocated type
+    using value_type = T;
+
+    //! containers moved or swapped take allocator with them
+    using propagate_on_container_move_assignment = std::true_type;
+    //! containers moved or swapped take allocator with them
+    using propagate_on_container_swap = std::true_type;
+
+    //!
+    //! \brief ArenaAllocator allocator bound to current arena of the thread
+    //!
+    ArenaAllocator () : arena_(Arena::GetCurrent()) {}
+
+    //!
+    //! \brief ArenaAllocator allocator bound to specified arena
+    //! \param arena arena, nullptr for global heap
+    //!
+    explicit ArenaAllocator (Arena * arena) : arena_(arena) {}
+
+    //!
+    //! \brief ArenaAllocator rebind allocator to other type
+    //! \param other allocator to take arena from
+    //!
+    template <typename U>
+    ArenaAllocator (const ArenaAllocator <U> & other) : arena_(other.GetArena()) {}
+
+    //!
+    //! \brief allocate memory for n objects
+    //! \param n objects count
+    //! \return memory block
+    //!
+    T * allocate (size_t n)
+    {
+        if (arena_ == nullptr)
+        {
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+        return static_cast<T*>(arena_->Allocate(n * sizeof(T), alignof(T)));
+    }
+
+    //!
+    //! \brief deallocate return memory to global heap. Arena memory is
+    //! released only with whole arena
+    //! \param p memory block
+    //!
+    void deallocate (T * p, size_t)
+    {
+        if (arena_ == nullptr)
+        {
+            ::operator delete(p);
+        }
+    }
+
+    //!
+    //! \brief select_on_container_copy_construction copies of containers
+    //! are placed in current arena, not in the arena of the original
+    //! \return allocator for the copy
+    //!
+    ArenaAllocator select_on_container_copy_construction () const
+    {
+        return ArenaAllocator();
+    }
+
+    //!
+    //! \brief GetArena arena allocator is bound to
+    //! \return arena, nullptr for global heap
+    //!
+    Arena * GetArena () const { return arena_; }
+
+private:
+    //! \brief arena_ memory source, nullptr for global heap
+    Arena * arena_;
+};
+
+template <typename T, typename U>
+inline bool
+operator== (const ArenaAllocator <T> & l, const ArenaAllocator <U> & r)
+{
+    return l.GetArena() == r.GetArena();
+}
+
+template <typename T, typename U>
+inline bool
+operator!= (const ArenaAllocator <T> & l, const ArenaAllocator <U> & r)
+{
+    return l.GetArena() != r.GetArena();
+}
+
+#endif // TG_ARENA_H
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2017, Ivan
+ * 
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "async_solve.h"
+
+SolveHandle::SolveHandle()
+{
+}
+
+bool SolveHandle::IsValid() const
+{
+    return state_ != nullptr;
+}
+
+void SolveHandle::Cancel()
+{
+    state_->cancel = true;
+}
+
+bool SolveHandle::IsDone() const
+{
+    std::lock_guard <std::mutex> lock (state_->mutex);
+    return state_->done;
+}
+
+bool SolveHandle::WaitFor(std::chrono::milliseconds timeout) const
+{
+    std::unique_lock <std::mutex> lock (state_->mutex);
+    State * state = state_.get();
+    return state_->done_condition.wait_for(lock, timeout,
+                                           [state] () { return state->done; });
+}
+
+const SolveResult &SolveHandle::Get() const
+{
+    std::unique_lock <std::mutex> lock (state_->mutex);
+    State * state = state_.get();
+    state_->done_condition.wait(lock, [state] () { return state->done; });
+    // result is not changed after it is done
+    return state_->result;
+}
+
+SolveHandle SolveAsync(ThreadPool &pool, const input_data_t &data,
+                       const AsyncSolveOptions *options)
+{
+    SolveHandle handle;
+    handle.state_ = std::make_shared <SolveHandle::State> ();
+    handle.state_->cancel = false;
+    handle.state_->done = false;
+
+    AsyncSolveOptions copy = AsyncSolveOptions();
+    if (options != nullptr)
+    {
+        copy = *options;
+    }
+
+    std::shared_ptr <SolveHandle::State> state = handle.state_;
+    pool.Submit([state, data, copy] ()
+    {
+        SolveResult result;
+        if (state->cancel)
+        {
+            // cancelled while waiting for worker
+            result.status = SolveResult::Status::Cancelled;
+        }
+        else
+        {
+            SolveOptions solve = SolveOptions();
+            solve.cache = copy.cache;
+            solve.graph_cache = copy.graph_cache;
+            solve.tablebase = copy.tablebase;
+            solve.cancel = &state->cancel;
+            solve.progress = copy.progress;
+            solve.progress_interval = copy.progress_interval;
+            result = SolvePuzzle(data, &solve);
+        }
+
+        {
+            std::lock_guard <std::mutex> lock (state->mutex);
+            state->result = std::move(result);
+            state->done = true;
+        }
+        state->done_condition.notify_all();
+
+        if (copy.done)
+        {
+            copy.done(state->result);
+        }
+    });
+    return handle;
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2017, Ivan
+ * 
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TG_ASYNC_SOLVE_H
+#define TG_ASYNC_SOLVE_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include "move_graph_cache.h"
+#include "solution_cache.h"
+#include "solver.h"
+#include "table.h"
+#include "tablebase.h"
+#include "thread_pool.h"
+#include "tg_types.h"
+
+//!
+//! \brief The AsyncSolveOptions struct Options of %SolveAsync
+//!
+struct AsyncSolveOptions
+{
+    SolutionCache * cache;          //!< solution cache, may be null
+    MoveGraphCache * graph_cache;   //!< move graphs cache, may be null
+    const Tablebase * tablebase;    //!< tablebase, may be null
+    //! \brief progress called on worker thread, may be empty
+    GameTable::progress_callback_t progress;
+    //! \brief progress_interval minimal time between progress reports
+    std::chrono::milliseconds progress_interval;
+    //! \brief done called on worker thread when result is ready, may be empty
+    std::function <void (const SolveResult &)> done;
+};
+
+//!
+//! \brief The SolveHandle class Puzzle being solved by worker. Copies of
+//! handle refer to the same solving. Dropping all the handles does not stop
+//! solving, call %Cancel() for that
+//!
+class SolveHandle
+{
+public:
+    //!
+    //! \brief SolveHandle Create handle not bound to any solving, see
+    //! %SolveAsync
+    //!
+    SolveHandle ();
+
+    //!
+    //! \brief IsValid Check if handle is bound to solving
+    //! \return true if handle was given by %SolveAsync
+    //!
+    bool IsValid () const;
+
+    //!
+    //! \brief Cancel Ask worker to stop. Search stops within a few
+    //! hundreds of expanded states, result status is then Cancelled unless
+    //! solving was already finished
+    //!
+    void Cancel ();
+
+    //!
+    //! \brief IsDone Check if result is ready
+    //! \return true if result is ready
+    //!
+    bool IsDone () const;
+
+    //!
+    //! \brief WaitFor Wait for result at most given time
+    //! \param timeout time to wait
+    //! \return true if result is ready
+    //!
+    bool WaitFor (std::chrono::milliseconds timeout) const;
+
+    //!
+    //! \brief Get Wait for result
+    //! \return solving result
+    //!
+    const SolveResult & Get () const;
+
+private:
+    //!
+    //! \brief The State struct Shared by handles and worker
+    //!
+    struct State
+    {
+        std::atomic <bool> cancel;  //!< cancel flag given to search
+        std::mutex mutex;           //!< guards %done and %result
+        std::condition_variable done_condition; //!< signaled when done
+        bool done;                  //!< result is ready
+        SolveResult result;         //!< solving result
+    };
+
+    std::shared_ptr <State> state_; //!< solving state, null if not bound
+
+    friend SolveHandle SolveAsync (ThreadPool & pool, const input_data_t & data,
+                                   const AsyncSolveOptions * options);
+};
+
+//!
+//! \brief SolveAsync Solve puzzle on the pool, same way as %SolvePuzzle
+//! \param pool workers to solve on. Must outlive solving
+//! \param data puzzle coordinates, same as in input file
+//! \param options caches, progress and completion callbacks, none by
+//! default. Caches and tablebase must outlive solving
+//! \return handle to wait for result or cancel solving
+//!
+SolveHandle SolveAsync (ThreadPool & pool, const input_data_t & data,
+                        const AsyncSolveOptions * options = nullptr);
+
+#endif // TG_ASYNC_SOLVE_H
@@ -60,7 +60,7 @@ Ball::CollisionResult Ball::CollisionWith(const BoardCell &cell, Direction move_
     }
 }
 
-ball_id_t Ball::GetId()
+ball_id_t Ball::GetId() const
 {
     return id_;
 }
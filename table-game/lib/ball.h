@@ -75,7 +75,7 @@ public:
     //! \brief GetId gives ball id attached to ball
     //! \return ball id
     //!
-    ball_id_t GetId ();
+    ball_id_t GetId () const;
 
 private:
     //!
@@ -0,0 +1,373 @@
+/*
+ * Copyright (c) 2017, Ivan
+ * 
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "batch.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "difficulty.h"
+#include "file_ops.h"
+#include "solve_scheduler.h"
+#include "solver.h"
+#include "thread_pool.h"
+
+namespace
+{
+
+//!
+//! \brief IsDelimiter Check if line holds only puzzle delimiter, surrounding
+//! whitespaces are allowed
+//!
+bool IsDelimiter (const char * begin, const char * end)
+{
+    while ((begin != end) && std::isspace(static_cast<unsigned char>(*begin)))
+        ++begin;
+    while ((begin != end) && std::isspace(static_cast<unsigned char>(*(end - 1))))
+        --end;
+
+    return (static_cast<size_t>(end - begin) == PUZZLE_DELIMITER.size()) &&
+           std::equal(begin, end, PUZZLE_DELIMITER.begin());
+}
+
+//!
+//! \brief ReadFile Read whole file into the string
+//!
+bool ReadFile (const std::string & filename, std::string & contents)
+{
+    std::ifstream file (filename, std::ios_base::in | std::ios_base::binary);
+    if (!file.is_open())
+    {
+        return false;
+    }
+
+    contents.assign(std::istreambuf_iterator <char> (file),
+                    std::istreambuf_iterator <char> ());
+    return true;
+}
+
+}
+
+void SplitPuzzles(const char *begin, const char *end,
+                  const std::string &prefix, puzzles_t &puzzles)
+{
+    std::vector <input_data_t> found;
+    const char * puzzle_start = begin;
+    const char * line_start = begin;
+
+    while (line_start != end)
+    {
+        const char * line_end = std::find(line_start, end, '\n');
+        if (IsDelimiter(line_start, line_end))
+        {
+            found.emplace_back();
+            ParseCoordinates(puzzle_start, line_start, found.back());
+            puzzle_start = (line_end == end) ? end : line_end + 1;
+        }
+        line_start = (line_end == end) ? end : line_end + 1;
+    }
+    found.emplace_back();
+    ParseCoordinates(puzzle_start, end, found.back());
+
+    found.erase(std::remove_if(found.begin(), found.end(),
+                               [] (const input_data_t & d) { return d.empty(); }),
+                found.end());
+
+    if ((found.size() == 1) && !prefix.empty())
+    {
+        puzzles.push_back(Puzzle{prefix, std::move(found.front())});
+        return;
+    }
+
+    size_t n = 1;
+    for (auto & data : found)
+    {
+        std::string id = prefix.empty() ? std::to_string(n)
+                                        : prefix + ":" + std::to_string(n);
+        puzzles.push_back(Puzzle{id, std::move(data)});
+        ++n;
+    }
+}
+
+bool ReadPuzzles(const std::string &path, puzzles_t &puzzles)
+{
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0)
+    {
+        return false;
+    }
+
+    std::string contents;
+    if (!S_ISDIR(st.st_mode))
+    {
+        if (!ReadFile(path, contents))
+        {
+            return false;
+        }
+        SplitPuzzles(contents.data(), contents.data() + contents.size(),
+                     "", puzzles);
+        return true;
+    }
+
+    DIR * dir = opendir(path.c_str());
+    if (dir == NULL)
+    {
+        return false;
+    }
+
+    std::vector <std::string> names;
+    while (struct dirent * entry = readdir(dir))
+    {
+        std::string name (entry->d_name);
+        if (name.empty() || (name[0] == '.'))
+        {
+            continue;
+        }
+
+        struct stat file_st;
+        if ((stat((path + "/" + name).c_str(), &file_st) == 0) &&
+            S_ISREG(file_st.st_mode))
+        {
+            names.push_back(name);
+        }
+    }
+    closedir(dir);
+
+    std::sort(names.begin(), names.end());
+    for (const auto & name : names)
+    {
+        if (ReadFile(path + "/" + name, contents))
+        {
+            SplitPuzzles(contents.data(), contents.data() + contents.size(),
+                         name, puzzles);
+        }
+    }
+    return true;
+}
+
+BatchSolver::BatchSolver(size_t workers, Order order)
+    : workers_(workers)
+    , order_(order)
+    , cache_(nullptr)
+    , graph_cache_(nullptr)
+    , tablebase_(nullptr)
+    , slice_(0)
+    , schedule_(Schedule::Input)
+    , report_(nullptr)
+{
+}
+
+void BatchSolver::SetCache(SolutionCache *cache)
+{
+    cache_ = cache;
+}
+
+void BatchSolver::SetMoveGraphCache(MoveGraphCache *graph_cache)
+{
+    graph_cache_ = graph_cache;
+}
+
+void BatchSolver::SetTablebase(const Tablebase *tablebase)
+{
+    tablebase_ = tablebase;
+}
+
+void BatchSolver::SetTimeSlice(size_t slice)
+{
+    slice_ = slice;
+}
+
+void BatchSolver::SetSchedule(Schedule schedule)
+{
+    schedule_ = schedule;
+}
+
+void BatchSolver::SetTimingReport(std::ostream *report)
+{
+    report_ = report;
+}
+
+void BatchSolver::Solve(const puzzles_t &puzzles, std::ostream &os)
+{
+    Run(puzzles.size(), [&puzzles] (size_t i)
+    {
+        return puzzles[i].id;
+    }, [&puzzles] (size_t i)
+    {
+        return InputData(puzzles[i].data);
+    }, os);
+}
+
+void BatchSolver::Solve(const CorpusReader &corpus, std::ostream &os)
+{
+    Run(corpus.GetCount(), [] (size_t i)
+    {
+        return std::to_string(i + 1);
+    }, [&corpus] (size_t i)
+    {
+        return corpus.GetPuzzle(i);
+    }, os);
+}
+
+void BatchSolver::Run(size_t count,
+                      const std::function<std::string (size_t)> &name,
+                      const std::function<InputData (size_t)> &puzzle,
+                      std::ostream &os)
+{
+    std::mutex output_mutex;
+    std::vector <std::string> results (count);
+    std::vector <bool> ready (count, false);
+    size_t next_to_print = 0;
+
+    auto print = [&] (size_t i, const SolveResult & result)
+    {
+        std::ostringstream formatted;
+        formatted << "# " << name(i) << "\n" << result;
+        std::string text = formatted.str();
+
+        std::lock_guard <std::mutex> lock (output_mutex);
+        if (order_ == Order::Completion)
+        {
+            os << text << std::flush;
+            return;
+        }
+
+        // print every result which is ready and not blocked by previous
+        results[i] = std::move(text);
+        ready[i] = true;
+        while ((next_to_print < results.size()) && ready[next_to_print])
+        {
+            os << results[next_to_print];
+            results[next_to_print].clear();
+            ++next_to_print;
+        }
+        os << std::flush;
+    };
+
+    // there is no sense to start more workers than tasks
+    size_t workers = (workers_ == 0) ? std::thread::hardware_concurrency()
+                                     : workers_;
+    workers = std::min(workers, std::max <size_t> (count, 1));
+
+    // predictions are made only when they are used
+    std::vector <double> costs (count, 0);
+    if ((schedule_ != Schedule::Input) || (report_ != nullptr))
+    {
+        ThreadPool pool (workers);
+        for (size_t i=0; i<count; ++i)
+        {
+            pool.Submit([&, i] ()
+            {
+                costs[i] = EstimateDifficulty(puzzle(i)).cost;
+            });
+        }
+        pool.Wait();
+    }
+
+    std::vector <size_t> schedule (count);
+    for (size_t i=0; i<count; ++i)
+    {
+        schedule[i] = i;
+    }
+    if (schedule_ != Schedule::Input)
+    {
+        bool shortest = (schedule_ == Schedule::ShortestFirst);
+        std::stable_sort(schedule.begin(), schedule.end(),
+                         [&costs, shortest] (size_t l, size_t r)
+        {
+            return shortest ? (costs[l] < costs[r]) : (costs[r] < costs[l]);
+        });
+    }
+
+    using clock_t = std::chrono::steady_clock;
+    std::vector <double> times (count, 0);
+    auto elapsed = [] (clock_t::time_point since)
+    {
+        return std::chrono::duration <double, std::milli> (clock_t::now() - since).count();
+    };
+
+    if (slice_ != 0)
+    {
+        SolveScheduler scheduler (workers, slice_);
+        scheduler.SetCache(cache_);
+        scheduler.SetMoveGraphCache(graph_cache_);
+        scheduler.SetTablebase(tablebase_);
+        clock_t::time_point start = clock_t::now();
+        for (size_t i : schedule)
+        {
+            scheduler.Submit(puzzle(i), [&, i] (const SolveResult & result)
+            {
+                times[i] = elapsed(start);
+                print(i, result);
+            });
+        }
+        scheduler.Wait();
+    }
+    else
+    {
+        SolveOptions options = SolveOptions();
+        options.cache = cache_;
+        options.graph_cache = graph_cache_;
+        options.tablebase = tablebase_;
+
+        ThreadPool pool (workers);
+        for (size_t i : schedule)
+        {
+            pool.Submit([&, i] ()
+            {
+                clock_t::time_point start = clock_t::now();
+                SolveResult result = SolvePuzzle(puzzle(i), &options);
+                times[i] = elapsed(start);
+                print(i, result);
+            });
+        }
+        pool.Wait();
+    }
+
+    if (report_ != nullptr)
+    {
+        for (size_t i=0; i<count; ++i)
+        {
+            *report_ << name(i) << " " << costs[i] << " " << times[i] << "\n";
+        }
+        *report_ << "# rank correlation " << RankCorrelation(costs, times)
+                 << std::endl;
+    }
+}
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2017, Ivan
+ * 
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TG_BATCH_H
+#define TG_BATCH_H
+
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "corpus.h"
+#include "input.h"
+#include "solution_cache.h"
+#include "move_graph_cache.h"
+#include "tablebase.h"
+#include "tg_types.h"
+
+//!
+//! \brief The Puzzle struct One puzzle of the batch
+//!
+struct Puzzle
+{
+    std::string id; //!< puzzle identifier printed with its result
+    input_data_t data; //!< puzzle coordinates
+};
+
+//!
+//! \brief puzzles_t puzzles of the batch in input order
+//!
+using puzzles_t = std::vector <Puzzle>;
+
+//!
+//! \brief PUZZLE_DELIMITER line separating puzzles in multi-puzzle file
+//!
+const std::string PUZZLE_DELIMITER = "---";
+
+//!
+//! \brief SplitPuzzles Parse buffer holding one or several puzzles separated
+//! by %PUZZLE_DELIMITER lines. Empty puzzles are skipped.
+//! Puzzles are named "<prefix>:<n>", n starting from 1; if there is only one
+//! puzzle and prefix is not empty, puzzle is named by prefix
+//! \param begin start of the buffer
+//! \param end end of the buffer
+//! \param prefix name prefix
+//! \param puzzles parsed puzzles are appended here
+//!
+void SplitPuzzles (const char * begin, const char * end,
+                   const std::string & prefix, puzzles_t & puzzles);
+
+//!
+//! \brief ReadPuzzles Read batch of puzzles from multi-puzzle file or from
+//! every file of directory. Files of directory are taken in name order and
+//! named by file name, puzzles of the single file are named by number
+//! \param path file or directory name
+//! \param puzzles read puzzles are appended here
+//! \return false if path can not be read
+//!
+bool ReadPuzzles (const std::string & path, puzzles_t & puzzles);
+
+//!
+//! \brief The BatchSolver class Solves batch of puzzles on a thread pool.
+//! Each result is printed as "# <id>" line followed by result lines
+//!
+class BatchSolver
+{
+public:
+    //!
+    //! \brief The Order enum Describes order of printed results
+    //!
+    enum class Order
+    {
+        Completion, //!< print results as soon as puzzles are solved
+        Input       //!< print results in input order
+    };
+
+    //!
+    //! \brief The Schedule enum Describes order in which puzzles are given to
+    //! workers. Puzzles are ordered by %EstimateDifficulty prediction
+    //!
+    enum class Schedule
+    {
+        Input,         //!< solve puzzles in input order
+        ShortestFirst, //!< solve easy puzzles first, lowers mean waiting time
+        LongestFirst   //!< solve hard puzzles first, lowers time of whole batch
+    };
+
+    //!
+    //! \brief BatchSolver Create solver
+    //! \param workers number of worker threads, 0 to use all hardware threads
+    //! \param order order of printed results
+    //!
+    BatchSolver (size_t workers, Order order);
+
+    //!
+    //! \brief SetCache Use solution cache for all the puzzles
+    //! \param cache solution cache, null to solve every puzzle
+    //!
+    void SetCache (SolutionCache * cache);
+
+    //!
+    //! \brief SetMoveGraphCache Use move graphs cache for all the puzzles
+    //! \param graph_cache move graphs cache, null to build every graph
+    //!
+    void SetMoveGraphCache (MoveGraphCache * graph_cache);
+
+    //!
+    //! \brief SetTablebase Use tablebase for puzzles of its board
+    //! \param tablebase tablebase, null to search every puzzle
+    //!
+    void SetTablebase (const Tablebase * tablebase);
+
+    //!
+    //! \brief SetTimeSlice Solve all the puzzles at once by time slices,
+    //! see %SolveScheduler, instead of giving every puzzle to one worker
+    //! until it is solved
+    //! \param slice search states expanded by one slice, 0 to solve puzzles
+    //! one by one
+    //!
+    void SetTimeSlice (size_t slice);
+
+    //!
+    //! \brief SetSchedule Set order in which puzzles are solved
+    //! \param schedule solving order, %Schedule::Input by default
+    //!
+    void SetSchedule (Schedule schedule);
+
+    //!
+    //! \brief SetTimingReport Print predicted cost and actual solving time of
+    //! every puzzle after the batch is solved, as "<id> <cost> <ms>" lines in
+    //! input order followed by "# rank correlation <r>" line. With time
+    //! slices actual time is counted from the start of the batch
+    //! \param report report stream, null to make no report
+    //!
+    void SetTimingReport (std::ostream * report);
+
+    //!
+    //! \brief Solve Solve all the puzzles and print results
+    //! \param puzzles puzzles to be solved
+    //! \param os output stream
+    //!
+    void Solve (const puzzles_t & puzzles, std::ostream & os);
+
+    //!
+    //! \brief Solve Solve all the puzzles of binary corpus and print results.
+    //! Puzzles are named by number, starting from 1
+    //! \param corpus opened corpus
+    //! \param os output stream
+    //!
+    void Solve (const CorpusReader & corpus, std::ostream & os);
+
+private:
+    size_t workers_; //!< number of worker threads
+    Order order_; //!< order of printed results
+    SolutionCache * cache_; //!< solution cache, may be null
+    MoveGraphCache * graph_cache_; //!< move graphs cache, may be null
+    const Tablebase * tablebase_; //!< tablebase, may be null
+    size_t slice_; //!< time slice, 0 if puzzles are solved one by one
+    Schedule schedule_; //!< order in which puzzles are solved
+    std::ostream * report_; //!< timing report stream, may be null
+
+    //!
+    //! \brief Run Solve puzzles and print their results
+    //! \param count number of puzzles
+    //! \param name gives printable name of puzzle by its index
+    //! \param puzzle gives coordinates of puzzle by its index
+    //! \param os output stream
+    //!
+    void Run (size_t count, const std::function <std::string (size_t)> & name,
+              const std::function <InputData (size_t)> & puzzle,
+              std::ostream & os);
+};
+
+#endif // TG_BATCH_H
@@ -0,0 +1,316 @@
+/*
+ * Copyright (c) 2017, Ivan
+ * 
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "corpus.h"
+
+#include <cstring>
+#include <fstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "file_ops.h"
+
+namespace
+{
+
+const char CORPUS_MAGIC[8] = {'T', 'G', 'C', 'O', 'R', 'P', 'U', 'S'};
+const size_t HEADER_SIZE = 24;
+
+void PutUint (std::vector <std::uint8_t> & out, std::uint64_t value, size_t bytes)
+{
+    for (size_t i=0; i<bytes; ++i)
+    {
+        out.push_back(static_cast <std::uint8_t> (value >> (8 * i)));
+    }
+}
+
+std::uint64_t GetUint (const std::uint8_t * in, size_t bytes)
+{
+    std::uint64_t value = 0;
+    for (size_t i=0; i<bytes; ++i)
+    {
+        value |= static_cast <std::uint64_t> (in[i]) << (8 * i);
+    }
+    return value;
+}
+
+void PutVarint (std::vector <std::uint8_t> & out, std::uint32_t value)
+{
+    while (value >= 0x80)
+    {
+        out.push_back(static_cast <std::uint8_t> (value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast <std::uint8_t> (value));
+}
+
+//!
+//! \brief GetVarint Decode varint moving %in forward
+//! \return false if varint is truncated or too long
+//!
+bool GetVarint (const std::uint8_t *& in, const std::uint8_t * end,
+                std::uint32_t & value)
+{
+    value = 0;
+    for (unsigned shift = 0; (in != end) && (shift < 35); shift += 7)
+    {
+        std::uint8_t byte = *in++;
+        value |= static_cast <std::uint32_t> (byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::uint32_t CellIndex (const coordinates_t & cell, coordinate_t table_size)
+{
+    return (cell.y - 1) * table_size + (cell.x - 1);
+}
+
+}
+
+bool CorpusWriter::Add(const InputData &data)
+{
+    if (InputData::Status::Ok != data.GetDataStatus())
+    {
+        return false;
+    }
+
+    coordinate_t table_size = data.GetTableSize();
+    if (static_cast <std::uint64_t> (table_size) * table_size > UINT32_MAX)
+    {
+        // cell index does not fit into varint
+        return false;
+    }
+
+    offsets_.push_back(records_.size());
+
+    PutVarint(records_, table_size);
+    PutVarint(records_, data.GetBallCount());
+    PutVarint(records_, data.GetWallCount());
+    for (const auto & ball : data.GetBalls())
+    {
+        PutVarint(records_, CellIndex(ball, table_size));
+    }
+    for (const auto & hole : data.GetHoles())
+    {
+        PutVarint(records_, CellIndex(hole, table_size));
+    }
+    for (const auto & wall : data.GetWalls())
+    {
+        PutVarint(records_, CellIndex(wall.first, table_size));
+        PutVarint(records_, CellIndex(wall.second, table_size));
+    }
+    return true;
+}
+
+size_t CorpusWriter::GetCount() const
+{
+    return offsets_.size();
+}
+
+bool CorpusWriter::Save(const std::string &filename) const
+{
+    std::vector <std::uint8_t> header (CORPUS_MAGIC, CORPUS_MAGIC + sizeof(CORPUS_MAGIC));
+    PutUint(header, CORPUS_VERSION, 4);
+    PutUint(header, 0, 4);
+    PutUint(header, offsets_.size(), 8);
+
+    std::uint64_t records_start = HEADER_SIZE + (offsets_.size() + 1) * 8;
+    for (auto offset : offsets_)
+    {
+        PutUint(header, records_start + offset, 8);
+    }
+    PutUint(header, records_start + records_.size(), 8);
+
+    // interrupted write leaves previous corpus in place
+    return WriteFileAtomically(filename, [this, &header] (std::ostream & file)
+    {
+        file.write(reinterpret_cast <const char*> (header.data()), header.size());
+        file.write(reinterpret_cast <const char*> (records_.data()), records_.size());
+    });
+}
+
+CorpusReader::CorpusReader(const std::string &filename)
+    : data_(nullptr)
+    , size_(0)
+    , count_(0)
+    , status_(Status::CannotOpen)
+{
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        close(fd);
+        return;
+    }
+    if (static_cast <size_t> (st.st_size) < HEADER_SIZE)
+    {
+        close(fd);
+        status_ = Status::InvalidHeader;
+        return;
+    }
+
+    size_t size = static_cast <size_t> (st.st_size);
+    void * mapped = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED)
+    {
+        return;
+    }
+
+    data_ = static_cast <const std::uint8_t*> (mapped);
+    size_ = size;
+
+    if ((std::memcmp(data_, CORPUS_MAGIC, sizeof(CORPUS_MAGIC)) != 0) ||
+        (GetUint(data_ + 8, 4) != CORPUS_VERSION))
+    {
+        status_ = Status::InvalidHeader;
+        return;
+    }
+
+    count_ = GetUint(data_ + 16, 8);
+    if (count_ >= (size_ - HEADER_SIZE) / 8)
+    {
+        count_ = 0;
+        status_ = Status::Truncated;
+        return;
+    }
+    status_ = Status::Ok;
+}
+
+CorpusReader::~CorpusReader()
+{
+    if (data_ != nullptr)
+    {
+        munmap(const_cast <std::uint8_t*> (data_), size_);
+    }
+}
+
+CorpusReader::Status CorpusReader::GetStatus() const
+{
+    return status_;
+}
+
+size_t CorpusReader::GetCount() const
+{
+    return count_;
+}
+
+InputData CorpusReader::GetPuzzle(size_t index) const
+{
+    if ((status_ != Status::Ok) || (index >= count_))
+    {
+        return InputData(input_data_t());
+    }
+
+    const std::uint8_t * entry = data_ + HEADER_SIZE + index * 8;
+    std::uint64_t begin = GetUint(entry, 8);
+    std::uint64_t end = GetUint(entry + 8, 8);
+    if ((begin > end) || (end > size_))
+    {
+        return InputData(input_data_t());
+    }
+
+    const std::uint8_t * in = data_ + begin;
+    const std::uint8_t * in_end = data_ + end;
+
+    std::uint32_t table_size = 0;
+    std::uint32_t balls_count = 0;
+    std::uint32_t walls_count = 0;
+    if (!GetVarint(in, in_end, table_size) ||
+        !GetVarint(in, in_end, balls_count) ||
+        !GetVarint(in, in_end, walls_count) ||
+        (table_size == 0) ||
+        // every cell takes at least one byte
+        (static_cast <std::uint64_t> (balls_count) * 2 +
+         static_cast <std::uint64_t> (walls_count) * 2 >
+         static_cast <std::uint64_t> (in_end - in)))
+    {
+        return InputData(input_data_t());
+    }
+
+    bool ok = true;
+    auto next_cell = [&] ()
+    {
+        std::uint32_t index = 0;
+        ok = ok && GetVarint(in, in_end, index);
+        return coordinates_t(index % table_size + 1, index / table_size + 1);
+    };
+
+    std::vector <coordinates_t> balls;
+    std::vector <coordinates_t> holes;
+    std::vector <wall_coordinates_t> walls;
+    balls.reserve(balls_count);
+    holes.reserve(balls_count);
+    walls.reserve(walls_count);
+
+    for (std::uint32_t i=0; i<balls_count; ++i)
+    {
+        balls.push_back(next_cell());
+    }
+    for (std::uint32_t i=0; i<balls_count; ++i)
+    {
+        holes.push_back(next_cell());
+    }
+    for (std::uint32_t i=0; i<walls_count; ++i)
+    {
+        coordinates_t first = next_cell();
+        coordinates_t second = next_cell();
+        walls.push_back(wall_coordinates_t(first, second));
+    }
+
+    if (!ok)
+    {
+        return InputData(input_data_t());
+    }
+
+    return InputData(table_size, std::move(balls), std::move(holes),
+                     std::move(walls));
+}
+
+bool CorpusReader::IsCorpus(const std::string &filename)
+{
+    char magic[sizeof(CORPUS_MAGIC)];
+    std::ifstream file (filename, std::ios_base::in | std::ios_base::binary);
+    file.read(magic, sizeof(magic));
+    return file.good() && (std::memcmp(magic, CORPUS_MAGIC, sizeof(magic)) == 0);
+}
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2017, Ivan
+ * 
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TG_CORPUS_H
+#define TG_CORPUS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "input.h"
+#include "tg_types.h"
+
+//!
+//! Binary corpus of puzzles. All numbers are little endian.
+//!
+//! Header:
+//! - 8 bytes: magic "TGCORPUS"
+//! - uint32: format version, %CORPUS_VERSION
+//! - uint32: reserved, 0
+//! - uint64: puzzles count N
+//!
+//! Index: N+1 uint64 offsets of records from the start of file, the last one
+//! is the end of the last record.
+//!
+//! Record: unsigned LEB128 varints: table size, balls count, walls count,
+//! then balls cells, holes cells and pairs of wall cells. Every cell is
+//! encoded by its index (y-1) * table size + (x-1).
+//!
+
+//!
+//! \brief CORPUS_VERSION version of corpus format written by %CorpusWriter
+//!
+const std::uint32_t CORPUS_VERSION = 1;
+
+//!
+//! \brief The CorpusWriter class Collects puzzles and saves them as binary
+//! corpus
+//!
+class CorpusWriter
+{
+public:
+    CorpusWriter () = default;
+
+    //!
+    //! \brief Add Encode puzzle and add it to the end of corpus
+    //! \param data puzzle to be added
+    //! \return false if puzzle is not valid or its board is too big to be
+    //! encoded, puzzle is not added in this case
+    //!
+    bool Add (const InputData & data);
+
+    //!
+    //! \brief GetCount Gives number of added puzzles
+    //! \return puzzles count
+    //!
+    size_t GetCount () const;
+
+    //!
+    //! \brief Save Write corpus into file
+    //! \param filename output file name
+    //! \return false if file can not be written
+    //!
+    bool Save (const std::string & filename) const;
+
+private:
+    std::vector <std::uint8_t> records_; //!< encoded records
+    std::vector <std::uint64_t> offsets_; //!< records offsets in %records_
+};
+
+//!
+//! \brief The CorpusReader class Gives random access to puzzles of binary
+//! corpus mapped into memory. Puzzles are decoded on demand
+//!
+class CorpusReader
+{
+public:
+    //!
+    //! \brief The Status enum Describes status of opening corpus
+    //!
+    enum class Status
+    {
+        Ok,            //!< Corpus is ready to be read
+        CannotOpen,    //!< File can not be opened or mapped
+        InvalidHeader, //!< File is not corpus or has unsupported version
+        Truncated      //!< Index is beyond end of file
+    };
+
+    //!
+    //! \brief CorpusReader Map corpus file and check its header
+    //! \param filename corpus file name
+    //!
+    explicit CorpusReader (const std::string & filename);
+    ~CorpusReader ();
+
+    CorpusReader (const CorpusReader &) = delete;
+    CorpusReader & operator= (const CorpusReader &) = delete;
+
+    //!
+    //! \brief GetStatus Returns status of opening corpus
+    //! \return corpus status. See %Status for more information
+    //!
+    Status GetStatus () const;
+
+    //!
+    //! \brief GetCount Gives number of puzzles in corpus
+    //! \return puzzles count
+    //!
+    size_t GetCount () const;
+
+    //!
+    //! \brief GetPuzzle Decode puzzle. Damaged record gives input data with
+    //! error status
+    //! \param index puzzle index, from 0 to %GetCount() - 1
+    //! \return puzzle input data
+    //!
+    InputData GetPuzzle (size_t index) const;
+
+    //!
+    //! \brief IsCorpus Check if file starts with corpus magic
+    //! \param filename file name
+    //! \return true if file looks like corpus
+    //!
+    static bool IsCorpus (const std::string & filename);
+
+private:
+    const std::uint8_t * data_; //!< mapped file
+    size_t size_; //!< size of mapped file
+    std::uint64_t count_; //!< puzzles count
+    Status status_; //!< opening status
+};
+
+#endif // TG_CORPUS_H
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2017, Ivan
+ * 
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "difficulty.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+//! \brief PROBES_SEED seed of random walks, fixed to make estimates repeatable
+const std::uint64_t PROBES_SEED = 0x9E3779B97F4A7C15ULL;
+
+//!
+//! \brief Ranks Give every value its rank starting from 1, tied values get
+//! average of their ranks
+//!
+std::vector <double> Ranks (const std::vector <double> & values)
+{
+    std::vector <size_t> order (values.size());
+    for (size_t i=0; i<order.size(); ++i)
+    {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&values] (size_t l, size_t r)
+    {
+        return values[l] < values[r];
+    });
+
+    std::vector <double> ranks (values.size());
+    size_t first = 0;
+    while (first < order.size())
+    {
+        size_t last = first + 1;
+        while ((last < order.size()) && (values[order[last]] == values[order[first]]))
+        {
+            ++last;
+        }
+        double rank = (first + last + 1) / 2.0;
+        for (size_t i=first; i<last; ++i)
+        {
+            ranks[order[i]] = rank;
+        }
+        first = last;
+    }
+    return ranks;
+}
+
+}
+
+Difficulty EstimateDifficulty(const InputData &in, size_t probes)
+{
+    Difficulty difficulty;
+    difficulty.balls = in.GetBallCount();
+    difficulty.table_size = in.GetTableSize();
+    difficulty.walls = in.GetWallCount();
+    difficulty.tree = GameTable::TreeEstimate{0, 0, 0};
+    difficulty.cost = 0;
+
+    if (InputData::Status::Ok != in.GetDataStatus())
+    {
+        return difficulty;
+    }
+
+    GameTable table (in);
+    difficulty.tree = table.EstimateSearchTree(probes, PROBES_SEED);
+    difficulty.cost = difficulty.tree.states * difficulty.balls;
+    return difficulty;
+}
+
+double RankCorrelation(const std::vector<double> &x,
+                       const std::vector<double> &y)
+{
+    if ((x.size() != y.size()) || (x.size() < 2))
+    {
+        return 0;
+    }
+
+    // Pearson correlation of ranks
+    std::vector <double> rx = Ranks(x);
+    std::vector <double> ry = Ranks(y);
+    double mean = (x.size() + 1) / 2.0;
+    double xy = 0;
+    double xx = 0;
+    double yy = 0;
+    for (size_t i=0; i<x.size(); ++i)
+    {
+        xy += (rx[i] - mean) * (ry[i] - mean);
+        xx += (rx[i] - mean) * (rx[i] - mean);
+        yy += (ry[i] - mean) * (ry[i] - mean);
+    }
+    if ((xx == 0) || (yy == 0))
+    {
+        return 0;
+    }
+    return xy / std::sqrt(xx * yy);
+}
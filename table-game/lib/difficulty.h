@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2017, Ivan
+ * 
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TG_DIFFICULTY_H
+#define TG_DIFFICULTY_H
+
+#include <cstddef>
+#include <vector>
+
+#include "input.h"
+#include "table.h"
+#include "tg_types.h"
+
+//!
+//! \brief The Difficulty struct Cheap prediction of solving cost, made
+//! before solving
+//!
+struct Difficulty
+{
+    size_t balls;              //!< balls count
+    coordinate_t table_size;   //!< board size
+    size_t walls;              //!< walls count
+    GameTable::TreeEstimate tree; //!< predicted search size
+    //! \brief cost predicted solving cost in relative units: states to be
+    //! expanded weighted by balls rolled per state. Zero for invalid input
+    double cost;
+};
+
+//!
+//! \brief DIFFICULTY_PROBES random walks made by %EstimateDifficulty by
+//! default
+//!
+const size_t DIFFICULTY_PROBES = 8;
+
+//!
+//! \brief EstimateDifficulty Predict solving cost of the puzzle. Builds the
+//! move graph and makes \a probes random walks up to 24 moves deep, so it
+//! pays off only for puzzles harder than a few milliseconds. Same puzzle
+//! always gets the same estimate
+//! \param in puzzle input data
+//! \param probes random walks of search tree estimate
+//! \return prediction
+//!
+Difficulty EstimateDifficulty (const InputData & in,
+                               size_t probes = DIFFICULTY_PROBES);
+
+//!
+//! \brief RankCorrelation Spearman rank correlation of two samples, tells
+//! how well predictions order puzzles by their actual solving time.
+//! Tied values get average rank
+//! \param x first sample
+//! \param y second sample of the same size
+//! \return correlation in range [-1, 1], 0 if it is not defined
+//!
+double RankCorrelation (const std::vector <double> & x,
+                        const std::vector <double> & y);
+
+#endif // TG_DIFFICULTY_H
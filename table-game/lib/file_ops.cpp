@@ -31,6 +31,122 @@
 
 #include "file_ops.h"
 
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+#include <sstream>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+
+//!
+//! \brief The MappedFile class Whole file mapped into memory for reading,
+//! unmapped on destruction
+//!
+class MappedFile
+{
+public:
+    //!
+    //! \brief MappedFile Map the file
+    //! \param filename file to be mapped
+    //!
+    explicit MappedFile (const std::string & filename)
+        : begin_(NULL)
+        , size_(0)
+    {
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return;
+        }
+
+        struct stat st;
+        if ((fstat(fd, &st) != 0) || (st.st_size <= 0))
+        {
+            close(fd);
+            return;
+        }
+
+        size_t size = static_cast<size_t>(st.st_size);
+        void * mapped = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (mapped == MAP_FAILED)
+        {
+            return;
+        }
+        madvise(mapped, size, MADV_SEQUENTIAL);
+        begin_ = static_cast<const char*>(mapped);
+        size_ = size;
+    }
+
+    ~MappedFile ()
+    {
+        if (begin_ != NULL)
+        {
+            munmap(const_cast<char*>(begin_), size_);
+        }
+    }
+
+    MappedFile (const MappedFile &) = delete;
+    MappedFile & operator= (const MappedFile &) = delete;
+
+    bool IsMapped () const { return begin_ != NULL; }
+    const char * Begin () const { return begin_; }
+    const char * End () const { return begin_ + size_; }
+
+private:
+    const char * begin_; //!< start of the mapping, null if file is not mapped
+    size_t size_;        //!< mapped bytes
+};
+
+//!
+//! \brief NextCoordinate Parse one coordinate, skipping whitespace before it
+//! \param p current position, moved past the coordinate. On failure it is
+//! left on the first character not parsed
+//! \param end end of the buffer
+//! \param value parsed coordinate
+//! \return false at the end of the buffer, on a character which is not a
+//! digit or whitespace and on value too big for coordinate
+//!
+bool NextCoordinate (const char * & p, const char * end, coordinate_t & value)
+{
+    const coordinate_t max_value = std::numeric_limits<coordinate_t>::max();
+
+    while ((p != end) && ((*p == ' ') || (*p == '\n') || (*p == '\t') ||
+                          (*p == '\r') || (*p == '\v') || (*p == '\f')))
+    {
+        ++p;
+    }
+
+    const char * number = p;
+    std::uint64_t parsed = 0;
+    while ((p != end) && (*p >= '0') && (*p <= '9'))
+    {
+        parsed = parsed * 10 + static_cast<unsigned>(*p - '0');
+        if (parsed > max_value)
+        {
+            p = number;
+            return false;
+        }
+        ++p;
+    }
+
+    if (p == number)
+    {
+        // not a number
+        return false;
+    }
+    value = static_cast<coordinate_t>(parsed);
+    return true;
+}
+
+}
 
 FileInput::FileInput(std::string filename)
 {
@@ -52,3 +168,126 @@ const input_data_t & FileInput::GetData() const
 {
     return data_;
 }
+
+const char *ParseCoordinates(const char *begin, const char *end,
+                             input_data_t &data)
+{
+    const char * p = begin;
+    coordinate_t value;
+    while (NextCoordinate(p, end, value))
+    {
+        data.push_back(value);
+    }
+    return p;
+}
+
+InputData ParseInputData(const char *begin, const char *end)
+{
+    const char * p = begin;
+    coordinate_t header[3];
+    for (auto & value : header)
+    {
+        if (!NextCoordinate(p, end, value))
+        {
+            return InputData(InputData::Status::IncompliteData);
+        }
+    }
+    coordinate_t table_size = header[0];
+    size_t balls_count = header[1];
+    size_t walls_count = header[2];
+
+    // counts are not trusted: every coordinate takes at least two
+    // characters with separator
+    size_t most_coordinates = static_cast<size_t>(end - p) / 2 + 1;
+    std::vector <coordinates_t> balls;
+    std::vector <coordinates_t> holes;
+    std::vector <wall_coordinates_t> walls;
+    balls.reserve(std::min(balls_count, most_coordinates / 2));
+    holes.reserve(std::min(balls_count, most_coordinates / 2));
+    walls.reserve(std::min(walls_count, most_coordinates / 4));
+
+    // coordinates go straight into objects, the ones after the last wall
+    // are only counted
+    size_t expected = balls_count * 4 + walls_count * 4;
+    size_t parsed = 0;
+    coordinate_t values[4];
+    coordinate_t value;
+    while (NextCoordinate(p, end, value))
+    {
+        if (parsed >= expected)
+        {
+            ++parsed;
+            continue;
+        }
+        values[parsed % 4] = value;
+        ++parsed;
+        if (parsed <= balls_count * 4)
+        {
+            if (parsed % 2 == 0)
+            {
+                coordinates_t cell (values[(parsed - 2) % 4], value);
+                (parsed <= balls_count * 2 ? balls : holes).push_back(cell);
+            }
+        }
+        else if (parsed % 4 == 0)
+        {
+            walls.emplace_back(values[0], values[1], values[2], values[3]);
+        }
+    }
+
+    if (parsed < expected)
+    {
+        return InputData(InputData::Status::IncompliteData);
+    }
+    if (parsed > expected)
+    {
+        return InputData(InputData::Status::TooLongData);
+    }
+    return InputData(table_size, std::move(balls), std::move(holes),
+                     std::move(walls));
+}
+
+InputData ReadInputData(const std::string &filename)
+{
+    MappedFile file (filename);
+    if (!file.IsMapped())
+    {
+        FileInput input (filename);
+        return InputData(input.GetData());
+    }
+    return ParseInputData(file.Begin(), file.End());
+}
+
+bool WriteFileAtomically(const std::string &path,
+                         const std::function<void (std::ostream &)> &write)
+{
+    // unique per writer, so concurrent writers never share temporary file
+    std::ostringstream temp_name;
+    temp_name << path << ".tmp." << getpid() << "."
+              << std::hash <std::thread::id> () (std::this_thread::get_id());
+    {
+        std::ofstream file (temp_name.str(), std::ios_base::out |
+                            std::ios_base::binary | std::ios_base::trunc);
+        write(file);
+        if (!file.good())
+        {
+            file.close();
+            unlink(temp_name.str().c_str());
+            return false;
+        }
+    }
+    if (std::rename(temp_name.str().c_str(), path.c_str()) != 0)
+    {
+        unlink(temp_name.str().c_str());
+        return false;
+    }
+    return true;
+}
+
+bool WriteFileAtomically(const std::string &path, const std::string &bytes)
+{
+    return WriteFileAtomically(path, [&bytes] (std::ostream & file)
+    {
+        file.write(bytes.data(), bytes.size());
+    });
+}
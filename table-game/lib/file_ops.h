@@ -34,9 +34,12 @@
 
 #include <string>
 #include <fstream>
+#include <functional>
+#include <ostream>
 
 
 #include "tg_types.h"
+#include "input.h"
 
 //!
 //! \brief The FileInput class Controls reading data from files
@@ -62,4 +65,55 @@ private:
     std::ifstream input_file_; //!< Stream of input file
 };
 
+//!
+//! \brief ParseCoordinates Parse whitespace separated coordinates from
+//! memory buffer. Parsing stops on first character which is not a digit or
+//! whitespace, or on value too big for coordinate, same way as reading
+//! from stream does
+//! \param begin start of the buffer
+//! \param end end of the buffer
+//! \param data parsed coordinates are appended here
+//! \return pointer to the first character not parsed
+//!
+const char * ParseCoordinates (const char * begin, const char * end,
+                               input_data_t & data);
+
+//!
+//! \brief ParseInputData Decode input data from memory buffer in one pass:
+//! coordinates go straight into balls, holes and walls, with the same
+//! checks %InputData does for coordinates parsed by %ParseCoordinates
+//! \param begin start of the buffer
+//! \param end end of the buffer
+//! \return input data, its status tells if the buffer was valid
+//!
+InputData ParseInputData (const char * begin, const char * end);
+
+//!
+//! \brief ReadInputData Map the file into memory and decode it by
+//! %ParseInputData. File which can not be mapped is read by %FileInput
+//! \param filename file to be read
+//! \return input data, its status tells if the file was valid
+//!
+InputData ReadInputData (const std::string & filename);
+
+//!
+//! \brief WriteFileAtomically Write the file under temporary name next to
+//! it and rename it over the target, so readers never see partial file and
+//! the file mapped by other readers stays valid while new one replaces it
+//! \param path file to be written
+//! \param write writes file contents into the stream
+//! \return false if the file cannot be written, target stays untouched then
+//!
+bool WriteFileAtomically (const std::string & path,
+                          const std::function<void (std::ostream &)> & write);
+
+//!
+//! \brief WriteFileAtomically Write bytes into the file atomically
+//! \see %WriteFileAtomically
+//! \param path file to be written
+//! \param bytes file contents
+//! \return false if the file cannot be written
+//!
+bool WriteFileAtomically (const std::string & path, const std::string & bytes);
+
 #endif // TG_FILES_H
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2017, Ivan
+ * 
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "game_session.h"
+
+#include "tg_utils.h"
+
+GameSession::GameSession(const InputData &in, const Tablebase *tablebase)
+    : table_(in)
+    , known_(in)
+    , tablebase_((tablebase != nullptr) && tablebase->Matches(in) ? tablebase
+                                                                  : nullptr)
+    , state_(State::Playing)
+    , moves_count_(0)
+{
+    for (const auto & ball : table_.GetBalls())
+    {
+        balls_.insert(std::make_pair(ball.first, ball.second.GetId()));
+    }
+
+    table_.PrepareMoveGraph();
+    table_.SetTranspositionCache(&known_);
+}
+
+GameSession::State GameSession::GetState() const
+{
+    return state_;
+}
+
+const GameSession::balls_t &GameSession::GetBalls() const
+{
+    return balls_;
+}
+
+size_t GameSession::GetMovesCount() const
+{
+    return moves_count_;
+}
+
+GameSession::State GameSession::Move(Direction to)
+{
+    if (state_ != State::Playing)
+    {
+        return state_;
+    }
+
+    balls_t next;
+    ++moves_count_;
+    if (!table_.MakeMove(balls_, to, next))
+    {
+        state_ = State::Lost;
+        return state_;
+    }
+
+    balls_.swap(next);
+    if (balls_.empty())
+    {
+        state_ = State::Won;
+    }
+    return state_;
+}
+
+bool GameSession::GetHints(std::vector<Direction> &hints, size_t &distance)
+{
+    hints.clear();
+    distance = 0;
+    if (state_ == State::Won)
+    {
+        return true;
+    }
+    if (state_ == State::Lost)
+    {
+        return false;
+    }
+
+    TranspositionCache::Entry known;
+    bool found = (tablebase_ != nullptr) && tablebase_->Find(balls_, known);
+    if (!found)
+    {
+        zobrist_key_t key = table_.MakeState(balls_).GetKey();
+        found = known_.Find(key, known);
+        if (!found)
+        {
+            // search learns the state together with the best sequences
+            table_.CalculateMovesFrom(balls_);
+            found = known_.Find(key, known);
+        }
+    }
+
+    if (!found || (known.distance == TranspositionCache::UNSOLVABLE))
+    {
+        return false;
+    }
+
+    for (Direction to : {Direction::North, Direction::West,
+                         Direction::South, Direction::East})
+    {
+        if ((known.moves & (1 << static_cast <unsigned> (to))) != 0)
+        {
+            hints.push_back(to);
+        }
+    }
+    distance = known.distance;
+    return true;
+}
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2017, Ivan
+ * 
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TG_GAME_SESSION_H
+#define TG_GAME_SESSION_H
+
+#include <cstddef>
+#include <map>
+#include <vector>
+
+#include "input.h"
+#include "table.h"
+#include "tablebase.h"
+#include "transposition_cache.h"
+#include "tg_types.h"
+
+//!
+//! \brief The GameSession class Game being played move by move. Keeps move
+//! graph of the board and everything learned by previous searches, so hint
+//! for the next move is usually a single lookup: after a search all the
+//! states of the best sequences are known. Search is done again only when
+//! player leaves the best sequences, and it stops at the known states.
+//!
+//! Session must not be used from several threads at once.
+//!
+class GameSession
+{
+public:
+    //!
+    //! \brief balls_t cells of balls on the board and their ids. Balls fallen
+    //! into their holes are absent
+    //!
+    using balls_t = std::map <coordinates_t, ball_id_t>;
+
+    //!
+    //! \brief The State enum Describes the game
+    //!
+    enum class State
+    {
+        Playing, //!< balls are on the board
+        Won,     //!< all balls are in their holes
+        Lost     //!< ball has fallen into another's hole
+    };
+
+    //!
+    //! \brief GameSession Start the game of the puzzle
+    //! \param in valid puzzle
+    //! \param tablebase tablebase of the puzzle board to take hints from,
+    //! none by default. Ignored if it belongs to another board
+    //!
+    explicit GameSession (const InputData & in,
+                          const Tablebase * tablebase = nullptr);
+
+    GameSession (const GameSession &) = delete;
+    GameSession & operator= (const GameSession &) = delete;
+
+    //!
+    //! \brief GetState Gives state of the game
+    //! \return game state
+    //!
+    State GetState () const;
+
+    //!
+    //! \brief GetBalls Gives current positions of the balls
+    //! \return balls on the board
+    //!
+    const balls_t & GetBalls () const;
+
+    //!
+    //! \brief GetMovesCount Gives number of moves made
+    //! \return moves count
+    //!
+    size_t GetMovesCount () const;
+
+    //!
+    //! \brief Move Tilt the board. Does nothing if game is over
+    //! \param to move direction
+    //! \return game state after the move
+    //!
+    State Move (Direction to);
+
+    //!
+    //! \brief GetHints Gives best next moves from current state
+    //! \param hints every move starting one of the best sequences, in
+    //! order of directions
+    //! \param distance number of moves left to the win
+    //! \return false if game can not be won any more
+    //!
+    bool GetHints (std::vector <Direction> & hints, size_t & distance);
+
+private:
+    GameTable table_; //!< board of the game
+    TranspositionCache known_; //!< states learned by searches
+    const Tablebase * tablebase_; //!< tablebase of the board, may be null
+    balls_t balls_; //!< current balls positions
+    State state_; //!< game state
+    size_t moves_count_; //!< moves made
+};
+
+#endif // TG_GAME_SESSION_H
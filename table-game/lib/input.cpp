@@ -30,6 +30,9 @@
  */
 
 #include "input.h"
+
+#include <algorithm>
+
 #include "tg_utils.h"
 
 InputData::InputData(const input_data_t &input)
@@ -126,6 +129,55 @@ InputData::InputData(const input_data_t &input)
     Validate();
 }
 
+InputData::InputData(coordinate_t table_size,
+                     std::vector<coordinates_t> &&balls,
+                     std::vector<coordinates_t> &&holes,
+                     std::vector<wall_coordinates_t> &&walls)
+    : table_size_(table_size)
+    , balls_(std::move(balls))
+    , holes_(std::move(holes))
+    , walls_(std::move(walls))
+    , status_(Status::Ok)
+{
+    if (balls_.size() != holes_.size())
+    {
+        status_ = Status::IncompliteData;
+        return;
+    }
+
+    if (balls_.empty())
+    {
+        status_ = Status::NoBalls;
+        return;
+    }
+
+    for (size_t i=0; i<balls_.size(); ++i)
+    {
+        if (! IsValid(balls_[i], table_size_) || ! IsValid(holes_[i], table_size_))
+        {
+            status_ = Status::InvalidCoordinates;
+            return;
+        }
+    }
+
+    for (const auto & wall : walls_)
+    {
+        if (! IsValid(wall, table_size_))
+        {
+            status_ = Status::InvalidCoordinates;
+            return;
+        }
+    }
+
+    Validate();
+}
+
+InputData::InputData(Status status)
+    : table_size_(0)
+    , status_(status)
+{
+}
+
 InputData::Status InputData::GetDataStatus() const
 {
     return status_;
@@ -154,12 +206,12 @@ const std::string InputData::GetErrorString() const
     return "";
 }
 
-std::vector<coordinates_t> InputData::GetBalls() const
+const std::vector<coordinates_t> &InputData::GetBalls() const
 {
     return balls_;
 }
 
-std::vector<coordinates_t> InputData::GetHoles() const
+const std::vector<coordinates_t> &InputData::GetHoles() const
 {
     return holes_;
 }
@@ -179,11 +231,42 @@ coordinate_t InputData::GetWallCount() const
     return (walls_.size() & 0xFFFFFFFF);
 }
 
-std::vector<wall_coordinates_t> InputData::GetWalls() const
+const std::vector<wall_coordinates_t> &InputData::GetWalls() const
 {
     return walls_;
 }
 
+std::uint64_t InputData::GetBoardHash() const
+{
+    input_data_t data;
+    data.reserve(2 + holes_.size() * 2 + walls_.size() * 4);
+    data.push_back(table_size_);
+    data.push_back(GetBallCount());
+
+    // hole ids matter: ball falls only into the hole of its own id
+    for (const auto & hole : holes_)
+    {
+        data.push_back(hole.x);
+        data.push_back(hole.y);
+    }
+
+    std::vector <std::pair <coordinates_t, coordinates_t> > walls;
+    walls.reserve(walls_.size());
+    for (const auto & wall : walls_)
+    {
+        walls.push_back(DuplicateKey(wall));
+    }
+    std::sort(walls.begin(), walls.end());
+    for (const auto & wall : walls)
+    {
+        data.push_back(wall.first.x);
+        data.push_back(wall.first.y);
+        data.push_back(wall.second.x);
+        data.push_back(wall.second.y);
+    }
+    return Fnv1a(data);
+}
+
 void InputData::Validate()
 {
     if (HasDuplicates(balls_))
@@ -205,16 +288,10 @@ void InputData::Validate()
 
     // Board state still can be invalid, if one of the balls will
     // stay up on the hole
-    for (auto i : balls_)
+    if (HasCommonItems(balls_, holes_))
     {
-        for (auto j : holes_)
-        {
-            if (i == j)
-            {
-                status_ = Status::BallsInHoles;
-                return;
-            }
-        }
+        status_ = Status::BallsInHoles;
+        return;
     }
 }
 
@@ -32,6 +32,7 @@
 #ifndef TG_INPUT_H
 #define TG_INPUT_H
 
+#include <cstdint>
 #include <map>
 #include <vector>
 #include <string>
@@ -51,6 +52,19 @@ public:
     //! \param input vector of coordinates
     //!
     InputData (const input_data_t &input);
+
+    //!
+    //! \brief InputData creates input data object from already decoded
+    //! objects, taking their ownership, and makes data validation
+    //! \param table_size size of game board
+    //! \param balls balls coordinates, vector index describes ball's id
+    //! \param holes holes coordinates, must be as many as balls
+    //! \param walls walls on game board
+    //!
+    InputData (coordinate_t table_size,
+               std::vector <coordinates_t> && balls,
+               std::vector <coordinates_t> && holes,
+               std::vector <wall_coordinates_t> && walls);
     ~InputData() = default;
 
     //!
@@ -67,6 +81,13 @@ public:
         NoBalls             //!< No balls on the board. Nothing to play with
     };
 
+    //!
+    //! \brief InputData creates empty input data which failed to be
+    //! decoded, for parsers finding errors before objects are made
+    //! \param status parsing status, not %Status::Ok
+    //!
+    explicit InputData (Status status);
+
     //!
     //! \brief GetDataStatus Returns parsing status of input data
     //! \return parsing status description. See %Status for more information
@@ -107,20 +128,28 @@ public:
     //! \return Array of board coordinates where balls ere installed.
     //! Vectoe index describes ball's id
     //!
-    std::vector<coordinates_t> GetBalls() const;
+    const std::vector<coordinates_t> & GetBalls() const;
 
     //!
     //! \brief GetHoles Same as %GetBalls
     //! \return Array of board coordinates where holes ere installed.
     //! Vectoe index describes halls's id
     //!
-    std::vector<coordinates_t> GetHoles() const;
+    const std::vector<coordinates_t> & GetHoles() const;
 
     //!
     //! \brief GetWalls Same as %GetBalls
     //! \return rray of board coordinates where bordedrs ere installed.
     //!
-    std::vector<wall_coordinates_t> GetWalls() const;
+    const std::vector<wall_coordinates_t> & GetWalls() const;
+
+    //!
+    //! \brief GetBoardHash Hash of the board: table size, balls count, holes
+    //! with their ids and walls in any order. Puzzles differing only in balls
+    //! positions have the same board hash
+    //! \return board hash
+    //!
+    std::uint64_t GetBoardHash() const;
 
 private:
     //!
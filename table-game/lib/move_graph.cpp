@@ -120,3 +120,22 @@ std::ostream &operator<<(std::ostream &os, const GraphItem &gi)
        << " E: " << gi.GetNeigbour(Direction::East);
     return os;
 }
+
+bool operator==(const GraphItem &l, const GraphItem &r)
+{
+    for (Direction d : {Direction::North, Direction::West,
+                        Direction::South, Direction::East})
+    {
+        if (!(l.GetNeigbour(d) == r.GetNeigbour(d)) ||
+            (l.GetHolesOnWayTo(d) != r.GetHolesOnWayTo(d)))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool operator!=(const GraphItem &l, const GraphItem &r)
+{
+    return !(l == r);
+}
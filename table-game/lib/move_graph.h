@@ -110,4 +110,16 @@ private:
 std::ostream &
 operator<< (std::ostream & os, const GraphItem & gi);
 
+//!
+//! \brief operator== Nodes are equal if they have the same neighbours and
+//! the same holes on the way to them
+//! \param l left node
+//! \param r right node
+//! \return true if equal
+//!
+bool operator== (const GraphItem & l, const GraphItem & r);
+
+//! \see %operator==
+bool operator!= (const GraphItem & l, const GraphItem & r);
+
 #endif //TG_MOVE_GRAPH_H
@@ -0,0 +1,324 @@
+/*
+ * Copyright (c) 2017, Ivan
+ * 
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "move_graph_cache.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "file_ops.h"
+#include "tg_utils.h"
+
+namespace
+{
+
+const char FILE_MAGIC[8] = {'T', 'G', 'M', 'G', 'R', 'A', 'P', 'H'};
+const std::uint32_t FILE_VERSION = 1;
+const std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+const Direction DIRECTIONS[4] = {Direction::North, Direction::West,
+                                 Direction::South, Direction::East};
+
+//!
+//! \brief The FileHeader struct Header of graph file, followed by canonical
+//! board, cell records and holes pool
+//!
+struct FileHeader
+{
+    char magic[8];              //!< "TGMGRAPH"
+    std::uint32_t version;      //!< format version
+    std::uint32_t byte_order;   //!< %BYTE_ORDER_MARK in native order
+    std::uint32_t table_size;   //!< cells count is its square
+    std::uint32_t board_size;   //!< values in canonical board
+    std::uint32_t pool_size;    //!< holes in pool
+    std::uint32_t reserved;     //!< zero
+};
+
+//!
+//! \brief The CellRecord struct Graph node of one cell. Cells are ordered
+//! by x, then by y
+//!
+struct CellRecord
+{
+    std::uint32_t neighbours[4][2]; //!< neighbour cell in every direction
+    std::uint32_t holes_begin[4];   //!< first hole in the pool
+    std::uint32_t holes_count[4];   //!< number of holes on the way
+};
+
+size_t FileSize (const FileHeader & header)
+{
+    size_t cells = static_cast <size_t> (header.table_size) * header.table_size;
+    return sizeof(FileHeader) +
+           header.board_size * sizeof(std::uint32_t) +
+           cells * sizeof(CellRecord) +
+           header.pool_size * 2 * sizeof(std::uint32_t);
+}
+
+}
+
+MoveGraphCache::MoveGraphCache(const std::string &directory, bool validate)
+    : directory_(directory)
+    , validate_(validate)
+    , open_(false)
+    , loads_(0)
+    , mismatches_(0)
+{
+    mkdir(directory_.c_str(), 0755);
+
+    DIR * dir = opendir(directory_.c_str());
+    if (dir != NULL)
+    {
+        open_ = true;
+        closedir(dir);
+    }
+}
+
+bool MoveGraphCache::IsOpen() const
+{
+    return open_;
+}
+
+bool MoveGraphCache::IsValidating() const
+{
+    return validate_;
+}
+
+MoveGraphCache::Key MoveGraphCache::MakeKey(const InputData &in)
+{
+    // hole ids do not matter for the graph, only hole cells
+    std::vector <coordinates_t> holes (in.GetHoles());
+    std::sort(holes.begin(), holes.end());
+
+    std::vector <std::pair <coordinates_t, coordinates_t> > walls;
+    walls.reserve(in.GetWalls().size());
+    for (const auto & wall : in.GetWalls())
+    {
+        walls.push_back(DuplicateKey(wall));
+    }
+    std::sort(walls.begin(), walls.end());
+
+    Key key;
+    key.board.reserve(3 + 2 * holes.size() + 4 * walls.size());
+    key.board.push_back(in.GetTableSize());
+    key.board.push_back(holes.size() & 0xFFFFFFFF);
+    key.board.push_back(walls.size() & 0xFFFFFFFF);
+    for (const auto & hole : holes)
+    {
+        key.board.push_back(hole.x);
+        key.board.push_back(hole.y);
+    }
+    for (const auto & wall : walls)
+    {
+        key.board.push_back(wall.first.x);
+        key.board.push_back(wall.first.y);
+        key.board.push_back(wall.second.x);
+        key.board.push_back(wall.second.y);
+    }
+    key.name = HashName(key.board);
+    return key;
+}
+
+bool MoveGraphCache::Load(const Key &key, graph_t &graph)
+{
+    if (!open_ || key.board.empty())
+    {
+        return false;
+    }
+
+    std::string path = directory_ + "/" + key.name;
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat st;
+    if ((fstat(fd, &st) != 0) ||
+        (static_cast <size_t> (st.st_size) < sizeof(FileHeader)))
+    {
+        close(fd);
+        return false;
+    }
+
+    size_t size = static_cast <size_t> (st.st_size);
+    void * mapped = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED)
+    {
+        return false;
+    }
+
+    // check header and canonical board: hash may collide
+    const char * data = static_cast <const char*> (mapped);
+    const FileHeader * header = reinterpret_cast <const FileHeader*> (data);
+    const std::uint32_t * board =
+        reinterpret_cast <const std::uint32_t*> (data + sizeof(FileHeader));
+    bool valid = (std::memcmp(header->magic, FILE_MAGIC, sizeof(FILE_MAGIC)) == 0) &&
+                 (header->version == FILE_VERSION) &&
+                 (header->byte_order == BYTE_ORDER_MARK) &&
+                 (header->table_size == key.board[0]) &&
+                 (header->board_size == key.board.size()) &&
+                 (FileSize(*header) == size) &&
+                 std::equal(key.board.begin(), key.board.end(), board);
+
+    if (valid)
+    {
+        coordinate_t table_size = header->table_size;
+        const CellRecord * cells =
+            reinterpret_cast <const CellRecord*> (board + header->board_size);
+        const std::uint32_t * pool = reinterpret_cast <const std::uint32_t*> (
+                    cells + static_cast <size_t> (table_size) * table_size);
+
+        size_t index = 0;
+        for (coordinate_t x=1; valid && (x<=table_size); ++x)
+        {
+            for (coordinate_t y=1; valid && (y<=table_size); ++y)
+            {
+                const CellRecord & cell = cells[index++];
+                GraphItem gi;
+                for (unsigned d=0; d<4; ++d)
+                {
+                    gi.AddNeighbour(DIRECTIONS[d],
+                                    coordinates_t(cell.neighbours[d][0],
+                                                  cell.neighbours[d][1]));
+                    if ((cell.holes_begin[d] > header->pool_size) ||
+                        (cell.holes_count[d] > header->pool_size - cell.holes_begin[d]))
+                    {
+                        valid = false;
+                        break;
+                    }
+                    for (std::uint32_t i=0; i<cell.holes_count[d]; ++i)
+                    {
+                        const std::uint32_t * hole = pool + 2 * (cell.holes_begin[d] + i);
+                        gi.AddHole(DIRECTIONS[d], coordinates_t(hole[0], hole[1]));
+                    }
+                }
+                graph.insert(graph.end(), std::make_pair(coordinates_t(x, y), gi));
+            }
+        }
+    }
+    munmap(mapped, size);
+
+    if (!valid)
+    {
+        graph.clear();
+        return false;
+    }
+    ++loads_;
+    return true;
+}
+
+bool MoveGraphCache::Store(const Key &key, const graph_t &graph)
+{
+    if (!open_ || key.board.empty())
+    {
+        return false;
+    }
+
+    coordinate_t table_size = key.board[0];
+    std::vector <CellRecord> cells;
+    std::vector <std::uint32_t> pool;
+    cells.reserve(static_cast <size_t> (table_size) * table_size);
+
+    for (coordinate_t x=1; x<=table_size; ++x)
+    {
+        for (coordinate_t y=1; y<=table_size; ++y)
+        {
+            auto found = graph.find(coordinates_t(x, y));
+            if (found == graph.end())
+            {
+                return false;
+            }
+
+            CellRecord cell;
+            for (unsigned d=0; d<4; ++d)
+            {
+                const coordinates_t & neighbour = found->second.GetNeigbour(DIRECTIONS[d]);
+                const auto & holes = found->second.GetHolesOnWayTo(DIRECTIONS[d]);
+                cell.neighbours[d][0] = neighbour.x;
+                cell.neighbours[d][1] = neighbour.y;
+                cell.holes_begin[d] = (pool.size() / 2) & 0xFFFFFFFF;
+                cell.holes_count[d] = holes.size() & 0xFFFFFFFF;
+                for (const auto & hole : holes)
+                {
+                    pool.push_back(hole.x);
+                    pool.push_back(hole.y);
+                }
+            }
+            cells.push_back(cell);
+        }
+    }
+
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+    header.version = FILE_VERSION;
+    header.byte_order = BYTE_ORDER_MARK;
+    header.table_size = table_size;
+    header.board_size = key.board.size() & 0xFFFFFFFF;
+    header.pool_size = (pool.size() / 2) & 0xFFFFFFFF;
+
+    return WriteFileAtomically(directory_ + "/" + key.name,
+                               [&] (std::ostream & file)
+    {
+        file.write(reinterpret_cast <const char*> (&header), sizeof(header));
+        file.write(reinterpret_cast <const char*> (key.board.data()),
+                   key.board.size() * sizeof(std::uint32_t));
+        file.write(reinterpret_cast <const char*> (cells.data()),
+                   cells.size() * sizeof(CellRecord));
+        file.write(reinterpret_cast <const char*> (pool.data()),
+                   pool.size() * sizeof(std::uint32_t));
+    });
+}
+
+void MoveGraphCache::ReportMismatch()
+{
+    ++mismatches_;
+}
+
+size_t MoveGraphCache::GetLoads() const
+{
+    return loads_;
+}
+
+size_t MoveGraphCache::GetMismatches() const
+{
+    return mismatches_;
+}
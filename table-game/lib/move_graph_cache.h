@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2017, Ivan
+ * 
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TG_MOVE_GRAPH_CACHE_H
+#define TG_MOVE_GRAPH_CACHE_H
+
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <string>
+
+#include "input.h"
+#include "move_graph.h"
+#include "tg_types.h"
+
+//!
+//! \brief The MoveGraphCache class On-disk cache of move graphs. Move graph
+//! depends only on table size, walls and holes positions, so one graph
+//! serves all the puzzles of the board. Every graph is kept in its own file
+//! of cache directory, named by hash of the board.
+//!
+//! File is written in native byte order as fixed size records: neighbours
+//! and holes ranges of every cell and pool of holes. It is mapped into
+//! memory and graph nodes are filled from the records, no parsing and no
+//! rolling is done.
+//!
+//! In validating mode loaded graph is compared with the one built from the
+//! board, mismatching file is replaced.
+//!
+//! Cache may be used from several threads at once.
+//!
+class MoveGraphCache
+{
+public:
+    //!
+    //! \brief graph_t move graph, same as kept by %GameTable
+    //!
+    using graph_t = std::map <const coordinates_t, GraphItem>;
+
+    //!
+    //! \brief The Key struct Canonical representation of the board
+    //!
+    struct Key
+    {
+        std::string name;   //!< hex hash of canonical board, file name
+        input_data_t board; //!< table size, sorted holes and walls
+    };
+
+    //!
+    //! \brief MoveGraphCache Open cache directory, creating it if needed
+    //! \param directory cache directory
+    //! \param validate compare loaded graphs with built ones
+    //!
+    explicit MoveGraphCache (const std::string & directory, bool validate = false);
+
+    MoveGraphCache (const MoveGraphCache &) = delete;
+    MoveGraphCache & operator= (const MoveGraphCache &) = delete;
+
+    //!
+    //! \brief IsOpen Check if cache directory can be used
+    //! \return true if directory exists
+    //!
+    bool IsOpen () const;
+
+    //!
+    //! \brief IsValidating Check if loaded graphs must be validated
+    //! \return true in validating mode
+    //!
+    bool IsValidating () const;
+
+    //!
+    //! \brief MakeKey Make canonical key of the board of valid puzzle
+    //! \param in puzzle input data
+    //! \return cache key
+    //!
+    static Key MakeKey (const InputData & in);
+
+    //!
+    //! \brief Load Fill move graph from cached file
+    //! \param key board key
+    //! \param graph empty graph to be filled
+    //! \return false if board is not cached or file is damaged
+    //!
+    bool Load (const Key & key, graph_t & graph);
+
+    //!
+    //! \brief Store Put move graph of the board into the cache
+    //! \param key board key
+    //! \param graph complete move graph of the board
+    //! \return false if graph can not be written
+    //!
+    bool Store (const Key & key, const graph_t & graph);
+
+    //!
+    //! \brief ReportMismatch Count cached graph found different from the
+    //! built one in validating mode
+    //!
+    void ReportMismatch ();
+
+    //!
+    //! \brief GetLoads Gives number of graphs taken from the cache
+    //! \return loads count
+    //!
+    size_t GetLoads () const;
+
+    //!
+    //! \brief GetMismatches Gives number of cached graphs failed validation
+    //! \return mismatches count
+    //!
+    size_t GetMismatches () const;
+
+private:
+    std::string directory_; //!< cache directory
+    bool validate_; //!< compare loaded graphs with built ones
+    bool open_; //!< directory can be used
+    std::atomic <size_t> loads_; //!< graphs taken from the cache
+    std::atomic <size_t> mismatches_; //!< cached graphs failed validation
+};
+
+#endif // TG_MOVE_GRAPH_CACHE_H
@@ -37,24 +37,21 @@ Movement::Movement(Direction to, const Movement &previous_move)
     , start_move_(false)
     , occupied_cells_ (previous_move.GetBallsPositions())
     , holes_state_ (previous_move.GetHoles())
-    , loop_guard_(previous_move.GetLoopGuard())
+    , zobrist_ (previous_move.zobrist_)
+    , key_ (previous_move.GetKey())
 {
 
 }
 
 Movement::Movement(const std::map<coordinates_t, ball_id_t> &balls,
-                   const std::map<coordinates_t, ball_id_t> &holes)
+                   const std::map<coordinates_t, ball_id_t> &holes,
+                   const ZobristTable &zobrist)
     : start_move_ (true)
-    , occupied_cells_ (balls)
-    , holes_state_ (holes)
+    , occupied_cells_ (balls.begin(), balls.end())
+    , holes_state_ (holes.begin(), holes.end())
+    , zobrist_ (&zobrist)
+    , key_ (zobrist.StateKey(balls, holes))
 {
-    for (auto ball : balls)
-    {
-        LoopGuard lg;
-        lg.visited_cells_[ball.first] = true;
-
-        loop_guard_.insert(std::make_pair(ball.second, lg));
-    }
 }
 
 bool Movement::IsStartMove() const
@@ -69,6 +66,7 @@ bool Movement::SetBallPosition(ball_id_t ball,
     auto search = occupied_cells_.find(previous_cell);
     if (search != occupied_cells_.end())
     {
+        key_ ^= zobrist_->BallKey(search->second, search->first);
         occupied_cells_.erase(search);
     }
 
@@ -86,6 +84,7 @@ bool Movement::SetBallPosition(ball_id_t ball,
         {
             if (hole->second == ball)
             {
+                key_ ^= zobrist_->HoleKey(hole->second);
                 holes_state_.erase(hole);
                 return true;
             }
@@ -94,7 +93,7 @@ bool Movement::SetBallPosition(ball_id_t ball,
         {
             // just place ball on the cell
             occupied_cells_.insert(std::make_pair(current_cell, ball));
-            loop_guard_.at(ball).visited_cells_[current_cell] = true;
+            key_ ^= zobrist_->BallKey(ball, current_cell);
             return true;
         }
     }
@@ -118,37 +117,17 @@ Direction Movement::GetMove() const
     return move_;
 }
 
-const std::map<coordinates_t, ball_id_t> &Movement::GetBallsPositions() const
+const Movement::cells_map_t &Movement::GetBallsPositions() const
 {
     return occupied_cells_;
 }
 
-const std::map<coordinates_t, ball_id_t> &Movement::GetHoles() const
+const Movement::cells_map_t &Movement::GetHoles() const
 {
     return holes_state_;
 }
 
-const std::map<ball_id_t, Movement::LoopGuard> Movement::GetLoopGuard() const
-{
-    return loop_guard_;
-}
-
-void Movement::InitLoopGuard()
+zobrist_key_t Movement::GetKey() const
 {
-    for (auto lg : loop_guard_)
-    {
-        lg.second.visited_cells_count_ = lg.second.visited_cells_.size();
-    }
-}
-
-bool Movement::IsLooped() const
-{
-    for (auto lg : loop_guard_)
-    {
-        if (lg.second.visited_cells_count_ != lg.second.visited_cells_.size())
-        {
-            return false;
-        }
-    }
-    return true;
+    return key_;
 }
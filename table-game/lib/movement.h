@@ -36,6 +36,8 @@
 #include <map>
 
 #include "tg_types.h"
+#include "zobrist.h"
+#include "arena.h"
 
 //!
 //! \brief The Movement class stores state during computing possible movements
@@ -43,6 +45,14 @@
 class Movement
 {
 public:
+    //!
+    //! \brief cells_map_t cells and ids of balls or holes placed there.
+    //! Allocated in current arena of the thread, so states of one search
+    //! layer can be released at once
+    //!
+    using cells_map_t = std::map <coordinates_t, ball_id_t, std::less <coordinates_t>,
+                                  ArenaAllocator <std::pair <const coordinates_t, ball_id_t> > >;
+
     //!
     //! \brief Movement creates movement from previous state
     //! \param to move direction
@@ -54,9 +64,12 @@ public:
     //! \brief Movement creates state as initial position to prepare for calculations
     //! \param balls coordinates of balls and their's ids
     //! \param holes coordinates of holes and their's ids
+    //! \param zobrist keys used to hash the state. Must outlive all the
+    //! movements created from this one
     //!
     Movement(const std::map <coordinates_t, ball_id_t> & balls,
-             const std::map <coordinates_t, ball_id_t> & holes);
+             const std::map <coordinates_t, ball_id_t> & holes,
+             const ZobristTable & zobrist);
     ~Movement() = default;
 
     //!
@@ -69,7 +82,8 @@ public:
     //!
     //! \brief SetBallPosition update ball position on the board.
     //! if ball will stend up on cell wth hole, they will destroy each other.
-    //! Caller must be worried abot holes between start and stop positions
+    //! Caller must be worried abot holes between start and stop positions.
+    //! State key is updated incrementally
     //! \param ball ball id
     //! \param current_cell current position on the cell
     //! \param previous_cell previous position on the cell
@@ -98,54 +112,21 @@ public:
     //! reached it's hole it will not be present in in return value
     //! \return current position of all balls
     //!
-    const std::map <coordinates_t, ball_id_t> & GetBallsPositions () const;
+    const cells_map_t & GetBallsPositions () const;
 
     //!
     //! \brief GetHoles Return current state of all states of all the holes.
     //! If hole is closed by the ball it will not be present in return value;
     //! \return current state of all holes
     //!
-    const std::map <coordinates_t, ball_id_t> & GetHoles () const;
+    const cells_map_t & GetHoles () const;
 
     //!
-    //! \brief The LoopGuard struct Keep track of loops for all the mooves
+    //! \brief GetKey Zobrist key of the state: balls on their cells and
+    //! open holes. Equal states have equal keys, no matter how they were reached
+    //! \return state key
     //!
-    struct LoopGuard
-    {
-        //! \brief visited_cells_count_ tracks difference from current
-        //! count of visited cells
-        size_t visited_cells_count_;
-
-        //! \brief visited_cells_ visited cells. each item has value 'true'
-        //! if cell was visited, otherwise corresponding value is not set
-        std::map <coordinates_t, bool> visited_cells_;
-    };
-
-    //!
-    //! \brief GetLoopGuard return current state of loop guard
-    //! \return state of loop guard
-    //!
-    const std::map <ball_id_t, LoopGuard>  GetLoopGuard () const;
-
-    //!
-    //! \brief InitLoopGuard need to be called before using loop guard.
-    //! Call init of loop guard, update current positions of balls and then
-    //! check for loops with %IsLooped()
-    //!
-    void InitLoopGuard ();
-
-    //!
-    //! \brief IsLooped Check if last moves caused game state to be looped.
-    //! First init loop guard by calling  %InitLoopGuard(), update current
-    //! ball positions with %SetBallPosition(). After that safe to use %IsLooped()
-    //! check
-    //!
-    //! If updating ball positions doesnot make balls to visit new cell,
-    //! state just got stack in loop and game will never reach win position
-    //! \return bool true if state was looped
-    //!
-    bool IsLooped () const;
-
+    zobrist_key_t GetKey () const;
 
 private:
     //!
@@ -163,18 +144,22 @@ private:
     //!
     //! \brief occupied_cells_ Describes current ball positions on this move
     //!
-    std::map <coordinates_t, ball_id_t> occupied_cells_;
+    cells_map_t occupied_cells_;
 
     //!
     //! \brief holes_state_ Describes open holes on this move
     //!
-    std::map <coordinates_t, ball_id_t> holes_state_;
+    cells_map_t holes_state_;
 
     //!
-    //! \brief loop_guard_ per-ball loop guard
+    //! \brief zobrist_ keys to hash the state
     //!
-    std::map <ball_id_t, LoopGuard> loop_guard_;
+    const ZobristTable * zobrist_;
 
+    //!
+    //! \brief key_ Zobrist key of current state
+    //!
+    zobrist_key_t key_;
 };
 
 #endif // TG_PATH_H
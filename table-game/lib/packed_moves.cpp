@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2017, Ivan
+ * 
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "packed_moves.h"
+
+#include <algorithm>
+
+namespace
+{
+
+const char BINARY_MAGIC[4] = {'T', 'G', 'M', 'V'};
+
+//! \brief MOVE_LETTERS text of every direction, in order of %Direction
+const char MOVE_LETTERS[4] = {'N', 'W', 'S', 'E'};
+
+void PutUint32 (std::string & out, std::uint32_t value)
+{
+    for (unsigned i=0; i<4; ++i)
+    {
+        out.push_back(static_cast <char> ((value >> (8 * i)) & 0xFF));
+    }
+}
+
+bool GetUint32 (std::istream & is, std::uint32_t & value)
+{
+    unsigned char bytes[4];
+    if (!is.read(reinterpret_cast <char *> (bytes), sizeof(bytes)))
+    {
+        return false;
+    }
+    value = 0;
+    for (unsigned i=0; i<4; ++i)
+    {
+        value |= static_cast <std::uint32_t> (bytes[i]) << (8 * i);
+    }
+    return true;
+}
+
+}
+
+PackedMoves::PackedMoves()
+    : size_(0)
+{
+}
+
+PackedMoves::PackedMoves(const std::vector<Direction> &moves)
+    : size_(0)
+{
+    bytes_.reserve((moves.size() + 3) / 4);
+    for (auto to : moves)
+    {
+        Push(to);
+    }
+}
+
+void PackedMoves::Push(Direction to)
+{
+    if (size_ % 4 == 0)
+    {
+        bytes_.push_back(0);
+    }
+    bytes_.back() |= static_cast <std::uint8_t> (
+                         static_cast <unsigned> (to) << (2 * (size_ % 4)));
+    ++size_;
+}
+
+size_t PackedMoves::GetSize() const
+{
+    return size_;
+}
+
+Direction PackedMoves::Get(size_t index) const
+{
+    return static_cast <Direction> ((bytes_[index / 4] >> (2 * (index % 4))) & 3);
+}
+
+std::vector<Direction> PackedMoves::Unpack() const
+{
+    std::vector <Direction> moves;
+    moves.reserve(size_);
+    for (size_t i=0; i<size_; ++i)
+    {
+        moves.push_back(Get(i));
+    }
+    return moves;
+}
+
+const PackedMoves::bytes_t &PackedMoves::GetBytes() const
+{
+    return bytes_;
+}
+
+void FormatMoves(const moves_list_t &moves, std::string &out)
+{
+    if (!moves.empty())
+    {
+        // all the best sequences have the same length
+        out.reserve(out.size() + moves.size() * (2 * moves.front().size() + 1));
+    }
+    for (const auto & sequence : moves)
+    {
+        for (auto to : sequence)
+        {
+            out.push_back(MOVE_LETTERS[static_cast <unsigned> (to)]);
+            out.push_back(' ');
+        }
+        out.push_back('\n');
+    }
+}
+
+void WriteBinaryMoves(std::ostream &os, const moves_list_t &moves)
+{
+    std::string out (BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    PutUint32(out, moves.size() & 0xFFFFFFFF);
+    for (const auto & sequence : moves)
+    {
+        PackedMoves packed (sequence);
+        PutUint32(out, packed.GetSize() & 0xFFFFFFFF);
+        out.append(packed.GetBytes().begin(), packed.GetBytes().end());
+    }
+    os.write(out.data(), out.size());
+}
+
+bool ReadBinaryMoves(std::istream &is, moves_list_t &moves)
+{
+    char magic[sizeof(BINARY_MAGIC)];
+    std::uint32_t count = 0;
+    if (!is.read(magic, sizeof(magic)) ||
+        !std::equal(magic, magic + sizeof(magic), BINARY_MAGIC) ||
+        !GetUint32(is, count))
+    {
+        return false;
+    }
+
+    moves_list_t found;
+    for (std::uint32_t i=0; i<count; ++i)
+    {
+        std::uint32_t size = 0;
+        if (!GetUint32(is, size))
+        {
+            return false;
+        }
+        // size comes from the stream, sequence grows only as bytes are read
+        std::vector <Direction> sequence;
+        std::uint8_t byte = 0;
+        for (std::uint32_t j=0; j<size; ++j)
+        {
+            if (j % 4 == 0)
+            {
+                char c;
+                if (!is.get(c))
+                {
+                    return false;
+                }
+                byte = static_cast <std::uint8_t> (c);
+            }
+            sequence.push_back(static_cast <Direction> ((byte >> (2 * (j % 4))) & 3));
+        }
+        found.push_back(std::move(sequence));
+    }
+    moves.splice(moves.end(), found);
+    return true;
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2017, Ivan
+ * 
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TG_PACKED_MOVES_H
+#define TG_PACKED_MOVES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <list>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "arena.h"
+#include "tg_types.h"
+
+//!
+//! \brief The PackedMoves class Moves sequence taking 2 bits per move, four
+//! moves per byte. Bytes are allocated in current arena of the thread, like
+//! search states
+//!
+class PackedMoves
+{
+public:
+    //!
+    //! \brief bytes_t packed moves, first move in the lowest bits
+    //!
+    using bytes_t = std::vector <std::uint8_t, ArenaAllocator <std::uint8_t> >;
+
+    //!
+    //! \brief PackedMoves Create empty sequence
+    //!
+    PackedMoves ();
+
+    //!
+    //! \brief PackedMoves Pack moves sequence
+    //! \param moves moves to be packed
+    //!
+    explicit PackedMoves (const std::vector <Direction> & moves);
+
+    //!
+    //! \brief Push Append move to the sequence
+    //! \param to move direction
+    //!
+    void Push (Direction to);
+
+    //!
+    //! \brief GetSize Gives number of moves
+    //! \return moves count
+    //!
+    size_t GetSize () const;
+
+    //!
+    //! \brief Get Gives one move
+    //! \param index move number, less than %GetSize
+    //! \return move direction
+    //!
+    Direction Get (size_t index) const;
+
+    //!
+    //! \brief Unpack Gives moves one per item
+    //! \return moves sequence
+    //!
+    std::vector <Direction> Unpack () const;
+
+    //!
+    //! \brief GetBytes Gives packed moves, unused bits of the last byte are
+    //! zero
+    //! \return packed bytes
+    //!
+    const bytes_t & GetBytes () const;
+
+private:
+    bytes_t bytes_; //!< packed moves
+    size_t size_;   //!< moves count
+};
+
+//!
+//! \brief moves_list_t moves sequences as solver gives them
+//!
+using moves_list_t = std::list <std::vector <Direction> >;
+
+//!
+//! \brief FormatMoves Append moves sequences as text, "N W S E " line per
+//! sequence. Whole text is built in one buffer, so it can be written by one
+//! call
+//! \param moves moves sequences
+//! \param out text is appended here
+//!
+void FormatMoves (const moves_list_t & moves, std::string & out);
+
+//!
+//! \brief WriteBinaryMoves Write moves sequences in binary form: "TGMV"
+//! magic, sequences count, then moves count and packed moves of every
+//! sequence. Counts are 32 bits little endian
+//! \param os output stream
+//! \param moves moves sequences
+//!
+void WriteBinaryMoves (std::ostream & os, const moves_list_t & moves);
+
+//!
+//! \brief ReadBinaryMoves Read moves sequences written by %WriteBinaryMoves
+//! \param is input stream
+//! \param moves sequences are appended here
+//! \return false if stream is not in binary moves format or truncated
+//!
+bool ReadBinaryMoves (std::istream & is, moves_list_t & moves);
+
+#endif // TG_PACKED_MOVES_H
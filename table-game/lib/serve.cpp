@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2017, Ivan
+ * 
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "serve.h"
+
+#include <cctype>
+#include <sstream>
+
+#include "file_ops.h"
+#include "tg_utils.h"
+
+std::string FormatResponse(const std::string &id, const SolveResult &result)
+{
+    std::ostringstream response;
+    response << id;
+
+    switch (result.status)
+    {
+    case SolveResult::Status::Solved:
+        response << " OK";
+        for (const auto & move_list : result.moves)
+        {
+            response << " ";
+            for (auto move : move_list)
+            {
+                response << move;
+            }
+        }
+        break;
+    case SolveResult::Status::NoSolution:
+        response << " NONE";
+        break;
+    case SolveResult::Status::InvalidInput:
+        response << " ERR " << result.error;
+        break;
+    case SolveResult::Status::Cancelled:
+        response << " ERR Solving was cancelled.";
+        break;
+    }
+
+    return response.str();
+}
+
+RequestStatus ParseRequest(const std::string &line, std::string &id,
+                           input_data_t &data)
+{
+    const char * begin = line.data();
+    const char * end = begin + line.size();
+
+    const char * id_begin = begin;
+    while ((id_begin != end) && std::isspace(static_cast<unsigned char>(*id_begin)))
+        ++id_begin;
+    const char * id_end = id_begin;
+    while ((id_end != end) && !std::isspace(static_cast<unsigned char>(*id_end)))
+        ++id_end;
+
+    if (id_begin == id_end)
+    {
+        return RequestStatus::Empty;
+    }
+
+    id.assign(id_begin, id_end);
+    data.clear();
+    if (ParseCoordinates(id_end, end, data) != end)
+    {
+        return RequestStatus::NotNumeric;
+    }
+    return RequestStatus::Ok;
+}
+
+bool ServeRequest(const std::string &line, std::string &response,
+                  SolutionCache *cache)
+{
+    std::string id;
+    input_data_t data;
+
+    switch (ParseRequest(line, id, data))
+    {
+    case RequestStatus::Empty:
+        response.clear();
+        return false;
+    case RequestStatus::NotNumeric:
+        response = id + " ERR Request contains non-numeric data.";
+        return true;
+    case RequestStatus::Ok:
+        break;
+    }
+
+    SolveOptions options = SolveOptions();
+    options.cache = cache;
+    response = FormatResponse(id, SolvePuzzle(data, &options));
+    return true;
+}
+
+void Serve(std::istream &in, std::ostream &out, SolutionCache *cache)
+{
+    std::string line;
+    std::string response;
+
+    while (std::getline(in, line))
+    {
+        if (ServeRequest(line, response, cache))
+        {
+            out << response << "\n" << std::flush;
+        }
+    }
+}
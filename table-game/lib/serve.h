@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2017, Ivan
+ * 
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TG_SERVE_H
+#define TG_SERVE_H
+
+#include <istream>
+#include <ostream>
+#include <string>
+
+#include "solver.h"
+#include "tg_types.h"
+
+//!
+//! Line protocol of resident solver. Every request is one line:
+//!
+//!     <id> <table size> <balls count> <walls count> <coordinates>...
+//!
+//! where id is any word without whitespaces and numbers are the same as in
+//! input file. Every request gets exactly one response line starting with
+//! the request id:
+//!
+//!     <id> OK <moves> <moves>...   best moves sequences, e.g. "NWE"
+//!     <id> NONE                    game can not be won
+//!     <id> ERR <description>       request is invalid
+//!
+//! Empty lines are ignored.
+//!
+
+//!
+//! \brief The RequestStatus enum Describes status of parsing request line
+//!
+enum class RequestStatus
+{
+    Ok,        //!< Request id and coordinates were parsed
+    Empty,     //!< Line is empty and must be ignored
+    NotNumeric //!< Coordinates contain something except numbers
+};
+
+//!
+//! \brief ParseRequest Split request line into id and coordinates
+//! \param line request line without line end
+//! \param id request id
+//! \param data puzzle coordinates
+//! \return parsing status
+//!
+RequestStatus ParseRequest (const std::string & line, std::string & id,
+                            input_data_t & data);
+
+//!
+//! \brief FormatResponse Make response line for solved request
+//! \param id request id
+//! \param result solving result
+//! \return response line without line end
+//!
+std::string FormatResponse (const std::string & id, const SolveResult & result);
+
+//!
+//! \brief ServeRequest Parse request line, solve puzzle and make response
+//! \param line request line without line end
+//! \param response response line without line end, empty for ignored lines
+//! \param cache solution cache to be used, none by default
+//! \return false if line was ignored
+//!
+bool ServeRequest (const std::string & line, std::string & response,
+                   SolutionCache * cache = nullptr);
+
+//!
+//! \brief Serve Answer requests until end of input. Every response is flushed
+//! as soon as it is ready
+//! \param in requests stream
+//! \param out responses stream
+//! \param cache solution cache to be used, none by default
+//!
+void Serve (std::istream & in, std::ostream & out,
+            SolutionCache * cache = nullptr);
+
+#endif // TG_SERVE_H
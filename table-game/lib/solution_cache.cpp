@@ -0,0 +1,353 @@
+/*
+ * Copyright (c) 2017, Ivan
+ * 
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "solution_cache.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <utility>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "file_ops.h"
+#include "tg_utils.h"
+
+namespace
+{
+
+const char ENTRY_MAGIC[8] = {'T', 'G', 'S', 'O', 'L', 'U', 'T', 'N'};
+const std::uint32_t ENTRY_VERSION = 1;
+
+std::uint64_t CellKey (const coordinates_t & c)
+{
+    return (static_cast <std::uint64_t> (c.x) << 32) | c.y;
+}
+
+//!
+//! \brief CanonicalData Puzzle with sorted ball and hole pairs and sorted
+//! walls, smaller cell of the wall first
+//!
+input_data_t CanonicalData (const InputData & in)
+{
+    using cells_pair_t = std::pair <std::uint64_t, std::uint64_t>;
+    coordinate_t table_size = in.GetTableSize();
+
+    std::vector <cells_pair_t> pairs;
+    pairs.reserve(in.GetBallCount());
+    for (size_t i=0; i<in.GetBalls().size(); ++i)
+    {
+        pairs.push_back(std::make_pair(CellKey(in.GetBalls()[i]),
+                                       CellKey(in.GetHoles()[i])));
+    }
+    std::sort(pairs.begin(), pairs.end());
+
+    std::vector <cells_pair_t> walls;
+    walls.reserve(in.GetWallCount());
+    for (const auto & wall : in.GetWalls())
+    {
+        std::uint64_t first = CellKey(wall.first);
+        std::uint64_t second = CellKey(wall.second);
+        walls.push_back(std::make_pair(std::min(first, second),
+                                       std::max(first, second)));
+    }
+    std::sort(walls.begin(), walls.end());
+
+    input_data_t data;
+    data.reserve(3 + pairs.size() * 4 + walls.size() * 4);
+    data.push_back(table_size);
+    data.push_back(pairs.size() & 0xFFFFFFFF);
+    data.push_back(walls.size() & 0xFFFFFFFF);
+    auto append = [&data] (const std::vector <cells_pair_t> & items)
+    {
+        for (const auto & item : items)
+        {
+            data.push_back(item.first >> 32);
+            data.push_back(item.first & 0xFFFFFFFF);
+            data.push_back(item.second >> 32);
+            data.push_back(item.second & 0xFFFFFFFF);
+        }
+    };
+    append(pairs);
+    append(walls);
+    return data;
+}
+
+bool IsEntryName (const std::string & name)
+{
+    return (name.size() == 16) &&
+           (name.find_first_not_of("0123456789abcdef") == std::string::npos);
+}
+
+void PutUint32 (std::string & out, std::uint32_t value)
+{
+    for (unsigned i=0; i<4; ++i)
+    {
+        out.push_back(static_cast <char> ((value >> (8 * i)) & 0xFF));
+    }
+}
+
+bool GetUint32 (const std::string & in, size_t & pos, std::uint32_t & value)
+{
+    if (in.size() < pos + 4)
+    {
+        return false;
+    }
+    value = 0;
+    for (unsigned i=0; i<4; ++i)
+    {
+        value |= static_cast <std::uint32_t> (
+                     static_cast <unsigned char> (in[pos + i])) << (8 * i);
+    }
+    pos += 4;
+    return true;
+}
+
+}
+
+SolutionCache::SolutionCache(const std::string &directory, size_t max_entries)
+    : directory_(directory)
+    , max_entries_(max_entries == 0 ? 1 : max_entries)
+    , open_(false)
+    , hits_(0)
+    , misses_(0)
+{
+    mkdir(directory_.c_str(), 0755);
+
+    DIR * dir = opendir(directory_.c_str());
+    if (dir == NULL)
+    {
+        return;
+    }
+    open_ = true;
+
+    // restore usage order from files modification time
+    std::vector <std::pair <struct timespec, std::string> > found;
+    while (struct dirent * entry = readdir(dir))
+    {
+        std::string name (entry->d_name);
+        struct stat st;
+        if (IsEntryName(name) &&
+            (stat((directory_ + "/" + name).c_str(), &st) == 0))
+        {
+            found.push_back(std::make_pair(st.st_mtim, name));
+        }
+    }
+    closedir(dir);
+
+    std::sort(found.begin(), found.end(),
+              [] (const std::pair <struct timespec, std::string> & l,
+                  const std::pair <struct timespec, std::string> & r)
+    {
+        if (l.first.tv_sec != r.first.tv_sec)
+            return l.first.tv_sec > r.first.tv_sec;
+        return l.first.tv_nsec > r.first.tv_nsec;
+    });
+
+    for (const auto & entry : found)
+    {
+        if (lru_.size() >= max_entries_)
+        {
+            unlink((directory_ + "/" + entry.second).c_str());
+            continue;
+        }
+        lru_.push_back(entry.second);
+        entries_[entry.second] = std::prev(lru_.end());
+    }
+}
+
+bool SolutionCache::IsOpen() const
+{
+    return open_;
+}
+
+SolutionCache::Key SolutionCache::MakeKey(const InputData &in) const
+{
+    Key key;
+    key.canonical = CanonicalData(in);
+    key.name = HashName(key.canonical);
+    return key;
+}
+
+bool SolutionCache::Lookup(const Key &key, moves_t &moves)
+{
+    {
+        std::lock_guard <std::mutex> lock (mutex_);
+        if (!open_ || (entries_.count(key.name) == 0))
+        {
+            ++misses_;
+            return false;
+        }
+    }
+
+    std::string contents;
+    {
+        std::ifstream file (directory_ + "/" + key.name,
+                            std::ios_base::in | std::ios_base::binary);
+        contents.assign(std::istreambuf_iterator <char> (file),
+                        std::istreambuf_iterator <char> ());
+    }
+
+    // check header and canonical puzzle: hash may collide
+    size_t pos = sizeof(ENTRY_MAGIC);
+    std::uint32_t version = 0;
+    std::uint32_t length = 0;
+    bool valid = (contents.size() >= pos) &&
+                 std::equal(ENTRY_MAGIC, ENTRY_MAGIC + pos, contents.begin()) &&
+                 GetUint32(contents, pos, version) && (version == ENTRY_VERSION) &&
+                 GetUint32(contents, pos, length) &&
+                 (length == key.canonical.size());
+    for (std::uint32_t i=0; valid && (i<length); ++i)
+    {
+        std::uint32_t value = 0;
+        valid = GetUint32(contents, pos, value) && (value == key.canonical[i]);
+    }
+
+    moves_t found;
+    std::uint32_t count = 0;
+    valid = valid && GetUint32(contents, pos, count);
+    for (std::uint32_t i=0; valid && (i<count); ++i)
+    {
+        std::uint32_t size = 0;
+        valid = GetUint32(contents, pos, size) && (contents.size() >= pos + size);
+        if (!valid)
+            break;
+
+        std::vector <Direction> sequence;
+        sequence.reserve(size);
+        for (std::uint32_t j=0; j<size; ++j)
+        {
+            unsigned char d = static_cast <unsigned char> (contents[pos + j]);
+            valid = valid && (d <= static_cast <unsigned char> (Direction::East));
+            sequence.push_back(static_cast <Direction> (d));
+        }
+        pos += size;
+        found.push_back(std::move(sequence));
+    }
+
+    std::lock_guard <std::mutex> lock (mutex_);
+    if (!valid)
+    {
+        Forget(key.name);
+        ++misses_;
+        return false;
+    }
+
+    moves.swap(found);
+    Touch(key.name);
+    ++hits_;
+    return true;
+}
+
+void SolutionCache::Store(const Key &key, const moves_t &moves)
+{
+    if (!open_)
+    {
+        return;
+    }
+
+    std::string contents (ENTRY_MAGIC, sizeof(ENTRY_MAGIC));
+    PutUint32(contents, ENTRY_VERSION);
+    PutUint32(contents, key.canonical.size() & 0xFFFFFFFF);
+    for (auto value : key.canonical)
+    {
+        PutUint32(contents, value);
+    }
+    PutUint32(contents, moves.size() & 0xFFFFFFFF);
+    for (const auto & sequence : moves)
+    {
+        PutUint32(contents, sequence.size() & 0xFFFFFFFF);
+        for (auto d : sequence)
+        {
+            contents.push_back(static_cast <char> (d));
+        }
+    }
+
+    if (!WriteFileAtomically(directory_ + "/" + key.name, contents))
+    {
+        return;
+    }
+
+    std::lock_guard <std::mutex> lock (mutex_);
+    Touch(key.name);
+    while (lru_.size() > max_entries_)
+    {
+        unlink((directory_ + "/" + lru_.back()).c_str());
+        entries_.erase(lru_.back());
+        lru_.pop_back();
+    }
+}
+
+size_t SolutionCache::GetSize() const
+{
+    std::lock_guard <std::mutex> lock (mutex_);
+    return lru_.size();
+}
+
+size_t SolutionCache::GetHits() const
+{
+    std::lock_guard <std::mutex> lock (mutex_);
+    return hits_;
+}
+
+size_t SolutionCache::GetMisses() const
+{
+    std::lock_guard <std::mutex> lock (mutex_);
+    return misses_;
+}
+
+void SolutionCache::Touch(const std::string &name)
+{
+    auto entry = entries_.find(name);
+    if (entry != entries_.end())
+    {
+        lru_.splice(lru_.begin(), lru_, entry->second);
+        // keep usage order for the next run
+        utimensat(AT_FDCWD, (directory_ + "/" + name).c_str(), NULL, 0);
+        return;
+    }
+
+    lru_.push_front(name);
+    entries_[name] = lru_.begin();
+}
+
+void SolutionCache::Forget(const std::string &name)
+{
+    auto entry = entries_.find(name);
+    if (entry != entries_.end())
+    {
+        lru_.erase(entry->second);
+        entries_.erase(entry);
+    }
+}
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2017, Ivan
+ * 
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TG_SOLUTION_CACHE_H
+#define TG_SOLUTION_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "input.h"
+#include "tg_types.h"
+
+//!
+//! \brief The SolutionCache class On-disk cache of best moves sequences,
+//! addressed by hash of canonical puzzle. Every puzzle is kept in its own
+//! file of cache directory, named by the hash. Number of files is bounded,
+//! least recently used ones are removed first.
+//!
+//! Canonical puzzle does not depend on order of walls, on order of cells in
+//! the wall and on order of ball and hole pairs. Rotated and reflected
+//! puzzles are not merged: balls are rolled in order of their coordinates,
+//! so rules are not the same in every direction.
+//!
+//! Cache may be used from several threads at once.
+//!
+class SolutionCache
+{
+public:
+    //!
+    //! \brief moves_t best moves sequences, same as kept by %GameTable
+    //!
+    using moves_t = std::list <std::vector <Direction> >;
+
+    //!
+    //! \brief The Key struct Canonical representation of puzzle
+    //!
+    struct Key
+    {
+        std::string name;       //!< hex hash of canonical puzzle, file name
+        input_data_t canonical; //!< canonical puzzle to detect collisions
+    };
+
+    //!
+    //! \brief SolutionCache Open cache directory, creating it if needed
+    //! \param directory cache directory
+    //! \param max_entries maximum number of cached puzzles
+    //!
+    SolutionCache (const std::string & directory, size_t max_entries);
+
+    SolutionCache (const SolutionCache &) = delete;
+    SolutionCache & operator= (const SolutionCache &) = delete;
+
+    //!
+    //! \brief IsOpen Check if cache directory can be used
+    //! \return true if directory exists
+    //!
+    bool IsOpen () const;
+
+    //!
+    //! \brief MakeKey Make canonical key of valid puzzle
+    //! \param in puzzle input data
+    //! \return cache key
+    //!
+    Key MakeKey (const InputData & in) const;
+
+    //!
+    //! \brief Lookup Find cached moves of the puzzle
+    //! \param key puzzle key
+    //! \param moves best moves sequences, empty if puzzle can not be won
+    //! \return false if puzzle is not in the cache
+    //!
+    bool Lookup (const Key & key, moves_t & moves);
+
+    //!
+    //! \brief Store Put moves of the puzzle into the cache, removing least
+    //! recently used puzzles if cache is full
+    //! \param key puzzle key
+    //! \param moves best moves sequences
+    //!
+    void Store (const Key & key, const moves_t & moves);
+
+    //!
+    //! \brief GetSize Gives number of cached puzzles
+    //! \return cached puzzles count
+    //!
+    size_t GetSize () const;
+
+    //!
+    //! \brief GetHits Gives number of successful lookups
+    //! \return hits count
+    //!
+    size_t GetHits () const;
+
+    //!
+    //! \brief GetMisses Gives number of failed lookups
+    //! \return misses count
+    //!
+    size_t GetMisses () const;
+
+private:
+    std::string directory_; //!< cache directory
+    size_t max_entries_; //!< maximum number of cached puzzles
+    bool open_; //!< directory can be used
+
+    mutable std::mutex mutex_; //!< guards everything below
+    //! \brief lru_ cached entries names, most recently used first
+    std::list <std::string> lru_;
+    //! \brief entries_ position of every cached entry in %lru_
+    std::unordered_map <std::string, std::list <std::string>::iterator> entries_;
+    size_t hits_; //!< successful lookups
+    size_t misses_; //!< failed lookups
+
+    //!
+    //! \brief Touch Mark entry as most recently used
+    //! \param name entry name
+    //!
+    void Touch (const std::string & name);
+
+    //!
+    //! \brief Forget Remove entry from index, file is kept
+    //! \param name entry name
+    //!
+    void Forget (const std::string & name);
+};
+
+#endif // TG_SOLUTION_CACHE_H
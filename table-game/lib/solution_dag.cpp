@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2017, Ivan
+ * 
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "solution_dag.h"
+
+#include <limits>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "table.h"
+#include "tg_utils.h"
+#include "zobrist.h"
+
+SolutionDag::SolutionDag(const InputData &in, size_t max_states)
+    : status_(Status::NoSolution)
+{
+    if (InputData::Status::Ok != in.GetDataStatus())
+    {
+        status_ = Status::InvalidInput;
+        return;
+    }
+
+    // best sequences go along the moves kept by the search
+    std::vector <GameTable::SearchEdge> edges;
+    GameTable table (in);
+    table.SetSearchLimits(GameTable::SearchLimits{0, max_states});
+    table.SetSearchEdges(&edges);
+    table.CalculateMoves();
+    if (table.IsLimitReached())
+    {
+        status_ = Status::LimitReached;
+        return;
+    }
+    if (table.GetMoves().empty())
+    {
+        return;
+    }
+
+    // states leading to the win, moves into deeper layers are checked first
+    std::unordered_set <zobrist_key_t> on_path;
+    on_path.insert(table.MakeState(balls_t()).GetKey());
+    using edges_t = std::vector <const GameTable::SearchEdge *>;
+    std::unordered_map <zobrist_key_t, edges_t> moves;
+    for (auto edge = edges.rbegin(); edge != edges.rend(); ++edge)
+    {
+        if (on_path.count(edge->to) != 0)
+        {
+            on_path.insert(edge->from);
+            moves[edge->from].push_back(&*edge);
+        }
+    }
+
+    // states are numbered in order they are reached from the start, moves
+    // of every state in order of directions
+    balls_t start;
+    for (const auto & ball : table.GetBalls())
+    {
+        start.insert(std::make_pair(ball.first, ball.second.GetId()));
+    }
+    std::vector <zobrist_key_t> keys (1, table.MakeState(start).GetKey());
+    std::unordered_map <zobrist_key_t, size_t> number;
+    number.emplace(keys.front(), 0);
+    states_.push_back(std::move(start));
+    depths_.push_back(0);
+
+    for (size_t from=0; from<states_.size(); ++from)
+    {
+        auto found = moves.find(keys[from]);
+        if (found == moves.end())
+        {
+            continue;
+        }
+        for (auto edge = found->second.rbegin(); edge != found->second.rend(); ++edge)
+        {
+            auto to = number.find((*edge)->to);
+            size_t state = states_.size();
+            if (to == number.end())
+            {
+                number.emplace((*edge)->to, state);
+                keys.push_back((*edge)->to);
+                balls_t rolled;
+                table.MakeMove(states_[from], (*edge)->move, rolled);
+                states_.push_back(std::move(rolled));
+                depths_.push_back(depths_[from] + 1);
+            }
+            else
+            {
+                state = to->second;
+            }
+            edges_.push_back(Edge{from, state, (*edge)->move});
+        }
+    }
+    status_ = Status::Solved;
+}
+
+SolutionDag::Status SolutionDag::GetStatus() const
+{
+    return status_;
+}
+
+size_t SolutionDag::GetMovesCount() const
+{
+    return depths_.empty() ? 0 : depths_.back();
+}
+
+const std::vector<SolutionDag::balls_t> &SolutionDag::GetStates() const
+{
+    return states_;
+}
+
+const std::vector<size_t> &SolutionDag::GetDepths() const
+{
+    return depths_;
+}
+
+const std::vector<SolutionDag::Edge> &SolutionDag::GetEdges() const
+{
+    return edges_;
+}
+
+std::uint64_t SolutionDag::CountPaths() const
+{
+    if (states_.empty())
+    {
+        return 0;
+    }
+
+    // sequences from every state to the win, deeper states first
+    const std::uint64_t max = std::numeric_limits <std::uint64_t>::max();
+    std::vector <std::uint64_t> paths (states_.size(), 0);
+    paths.back() = 1;
+    for (auto edge = edges_.rbegin(); edge != edges_.rend(); ++edge)
+    {
+        std::uint64_t & count = paths[edge->from];
+        count = (max - count < paths[edge->to]) ? max : count + paths[edge->to];
+    }
+    return paths.front();
+}
+
+void SolutionDag::GetPaths(std::list<std::vector<Direction> > &paths) const
+{
+    if (states_.empty())
+    {
+        return;
+    }
+
+    // first move of every state
+    std::vector <size_t> first (states_.size() + 1, 0);
+    for (const auto & edge : edges_)
+    {
+        ++first[edge.from + 1];
+    }
+    for (size_t i=0; i<states_.size(); ++i)
+    {
+        first[i + 1] += first[i];
+    }
+
+    // depth-first walk, next move to be tried is kept for every state
+    size_t win = states_.size() - 1;
+    std::vector <Direction> path;
+    std::vector <size_t> walk = {0};
+    std::vector <size_t> next = {first[0]};
+    while (!walk.empty())
+    {
+        size_t state = walk.back();
+        if ((state == win) || (next.back() == first[state + 1]))
+        {
+            if (state == win)
+            {
+                paths.push_back(path);
+            }
+            walk.pop_back();
+            next.pop_back();
+            if (!path.empty())
+            {
+                path.pop_back();
+            }
+            continue;
+        }
+
+        const Edge & edge = edges_[next.back()++];
+        path.push_back(edge.move);
+        walk.push_back(edge.to);
+        next.push_back(first[edge.to]);
+    }
+}
+
+std::ostream &operator <<(std::ostream &os, const SolutionDag &dag)
+{
+    if (dag.GetStatus() != SolutionDag::Status::Solved)
+    {
+        return os;
+    }
+
+    os << "moves " << dag.GetMovesCount()
+       << " states " << dag.GetStates().size()
+       << " edges " << dag.GetEdges().size()
+       << " paths " << dag.CountPaths() << "\n";
+    for (size_t i=0; i<dag.GetStates().size(); ++i)
+    {
+        os << "s " << i << " " << dag.GetDepths()[i];
+        for (const auto & ball : dag.GetStates()[i])
+        {
+            os << " " << ball.first.x << " " << ball.first.y << " " << ball.second;
+        }
+        os << "\n";
+    }
+    for (const auto & edge : dag.GetEdges())
+    {
+        os << "e " << edge.from << " " << edge.to << " " << edge.move << "\n";
+    }
+    return os;
+}
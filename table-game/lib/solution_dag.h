@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2017, Ivan
+ * 
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TG_SOLUTION_DAG_H
+#define TG_SOLUTION_DAG_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <ostream>
+#include <vector>
+
+#include "input.h"
+#include "tg_types.h"
+
+//!
+//! \brief The SolutionDag class All the shortest moves sequences of a puzzle
+//! kept as a graph: states lying on some shortest sequence and the moves
+//! between them. When many sequences pass the same states, graph is much
+//! smaller than the list of sequences, its size grows with number of states
+//! only.
+//!
+//! Graph is built from the moves kept by the search of %GameTable, see
+//! %GameTable::SetSearchEdges, so it is pruned the same way and can not
+//! disagree with %GameTable::GetMoves. State 0 is the initial one, the last
+//! state is the win; states are numbered in order of their distance from the
+//! start.
+//!
+class SolutionDag
+{
+public:
+    //!
+    //! \brief balls_t cells of balls on the board and their ids. Balls fallen
+    //! into their holes are absent
+    //!
+    using balls_t = std::map <coordinates_t, ball_id_t>;
+
+    //!
+    //! \brief The Edge struct Move from one state of the graph to another
+    //!
+    struct Edge
+    {
+        size_t from;    //!< state before the move
+        size_t to;      //!< state after the move
+        Direction move; //!< move direction
+    };
+
+    //!
+    //! \brief The Status enum Describes result of building the graph
+    //!
+    enum class Status
+    {
+        Solved,       //!< graph holds all the shortest sequences
+        NoSolution,   //!< game can not be won, graph is empty
+        InvalidInput, //!< input data failed validation, graph is empty
+        LimitReached  //!< states limit was reached, graph is empty
+    };
+
+    //!
+    //! \brief SolutionDag Build graph of the puzzle
+    //! \param in puzzle input data
+    //! \param max_states limit of distinct states visited, 0 for no limit
+    //!
+    explicit SolutionDag (const InputData & in, size_t max_states = 0);
+
+    //!
+    //! \brief GetStatus Gives result of building the graph
+    //! \return building status
+    //!
+    Status GetStatus () const;
+
+    //!
+    //! \brief GetMovesCount Gives length of the shortest sequences
+    //! \return moves count, 0 if puzzle is not solved
+    //!
+    size_t GetMovesCount () const;
+
+    //!
+    //! \brief GetStates Gives balls of every state of the graph
+    //! \return states by their numbers
+    //!
+    const std::vector <balls_t> & GetStates () const;
+
+    //!
+    //! \brief GetDepths Gives number of moves from the start to every state
+    //! \return distances by state numbers
+    //!
+    const std::vector <size_t> & GetDepths () const;
+
+    //!
+    //! \brief GetEdges Gives moves of the graph ordered by their start
+    //! states, moves of one state in order of directions
+    //! \return graph edges
+    //!
+    const std::vector <Edge> & GetEdges () const;
+
+    //!
+    //! \brief CountPaths Gives number of the shortest sequences without
+    //! enumerating them
+    //! \return sequences count, saturated at maximum of uint64_t
+    //!
+    std::uint64_t CountPaths () const;
+
+    //!
+    //! \brief GetPaths Enumerate the shortest sequences, in the same order
+    //! as %GameTable::GetMoves gives them
+    //! \param paths sequences are appended here
+    //!
+    void GetPaths (std::list <std::vector <Direction> > & paths) const;
+
+private:
+    Status status_; //!< building status
+    std::vector <balls_t> states_; //!< balls of graph states
+    std::vector <size_t> depths_; //!< distance of graph states from start
+    std::vector <Edge> edges_; //!< graph moves ordered by start states
+};
+
+//!
+//! \brief operator << Print graph as text: "moves <n> states <n> edges <n>
+//! paths <n>" header, then "s <state> <depth> [<x> <y> <ball>]..." line per
+//! state and "e <from> <to> <N|W|S|E>" line per move. Nothing is printed if
+//! puzzle is not solved
+//! \param os output stream
+//! \param dag graph to be printed
+//! \return output stream
+//!
+std::ostream & operator << (std::ostream & os, const SolutionDag & dag);
+
+#endif // TG_SOLUTION_DAG_H
@@ -0,0 +1,623 @@
+/*
+ * Copyright (c) 2017, Ivan
+ * 
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "solvability.h"
+
+#include <algorithm>
+
+#include "tg_utils.h"
+
+namespace
+{
+
+//! \brief DIRECTIONS all the moves, in order of their numbers
+const Direction DIRECTIONS[4] = {Direction::North, Direction::West,
+                                 Direction::South, Direction::East};
+
+//! \brief MASK_BITS hole ids of hole order masks are below that
+const size_t MASK_BITS = 64;
+
+//!
+//! \brief LowestHole Gives the lowest hole of the mask
+//! \param mask holes mask, not empty
+//! \return hole id
+//!
+ball_id_t LowestHole (std::uint64_t mask)
+{
+    ball_id_t hole = 0;
+    while ((mask & (std::uint64_t(1) << hole)) == 0)
+    {
+        ++hole;
+    }
+    return hole;
+}
+
+}
+
+const std::uint16_t SolvabilityCheck::NO_MOVES;
+
+SolvabilityCheck::SolvabilityCheck(const std::map<const coordinates_t, BoardCell> &board,
+                                   const std::map<const coordinates_t, GraphItem> &move_graph,
+                                   coordinate_t table_size)
+    : table_size_(table_size)
+    , holes_(table_size * table_size, 0)
+    , hole_cells_(1, 0)
+{
+    ray_begin_.reserve(holes_.size() * 4 + 1);
+    way_begin_.reserve(holes_.size() * 4 + 1);
+    for (coordinate_t y=1; y<=table_size_; ++y)
+    {
+        for (coordinate_t x=1; x<=table_size_; ++x)
+        {
+            coordinates_t cell (x, y);
+            ball_id_t hole = board.at(cell).HoleId();
+            holes_[GetCell(cell)] = hole;
+            if (hole != 0)
+            {
+                if (hole_cells_.size() <= hole)
+                {
+                    hole_cells_.resize(hole + 1, 0);
+                }
+                hole_cells_[hole] = GetCell(cell);
+            }
+
+            const GraphItem & node = move_graph.at(cell);
+            for (Direction to : DIRECTIONS)
+            {
+                ray_begin_.push_back(static_cast <std::uint32_t> (rays_.size()));
+                coordinates_t current = cell;
+                while (!(current == node.GetNeigbour(to)))
+                {
+                    current = GetNeighbourCell(current, to);
+                    rays_.push_back(GetCell(current));
+                }
+
+                way_begin_.push_back(static_cast <std::uint32_t> (way_holes_.size()));
+                for (const auto & gap : node.GetHolesOnWayTo(to))
+                {
+                    way_holes_.push_back(board.at(gap).HoleId());
+                }
+            }
+        }
+    }
+    ray_begin_.push_back(static_cast <std::uint32_t> (rays_.size()));
+    way_begin_.push_back(static_cast <std::uint32_t> (way_holes_.size()));
+}
+
+SolvabilityCheck::Result SolvabilityCheck::Check(const Movement &state) const
+{
+    Reach reach;
+    StartReach(state, reach);
+    size_t count = reach.ids.size();
+
+    // holes which can be crossed: closed ones and holes of the balls
+    // proved to get there earlier
+    std::vector <bool> passable (hole_cells_.size(), true);
+    for (const auto & hole : state.GetHoles())
+    {
+        passable[hole.second] = false;
+    }
+
+    SpreadInOrder(0, passable, reach);
+
+    Result result {Reason::None, 0};
+    for (size_t ball=0; ball<count; ++ball)
+    {
+        if (!reach.reached[ball] &&
+            ((result.ball == 0) || (reach.ids[ball] < result.ball)))
+        {
+            result = Result{Reason::Blocked, reach.ids[ball]};
+        }
+    }
+    if (result.reason == Reason::None)
+    {
+        return result;
+    }
+
+    // balls which can not get into their holes even crossing all the holes
+    passable.assign(passable.size(), true);
+    Spread(passable, reach);
+    Result unreachable {Reason::None, 0};
+    for (size_t ball=0; ball<count; ++ball)
+    {
+        if (!reach.reached[ball] &&
+            ((unreachable.ball == 0) || (reach.ids[ball] < unreachable.ball)))
+        {
+            unreachable = Result{Reason::Unreachable, reach.ids[ball]};
+        }
+    }
+    if (unreachable.reason != Reason::None)
+    {
+        return unreachable;
+    }
+
+    ball_id_t cycle = FindCycle(MakeHoleOrder(state), state);
+    return (cycle == 0) ? result : Result{Reason::Cycle, cycle};
+}
+
+SolvabilityCheck::HoleOrder SolvabilityCheck::MakeHoleOrder(const Movement &start) const
+{
+    size_t cells = holes_.size();
+    HoleOrder order {cells, {}, {}};
+    if (hole_cells_.size() > MASK_BITS)
+    {
+        return order;
+    }
+
+    order.needs.assign((hole_cells_.size() - 1) * cells, 0);
+    order.moves.assign((hole_cells_.size() - 1) * cells, NO_MOVES);
+
+    // moves are followed back from the hole, so every cell the hole can be
+    // reached from is found at once
+    std::vector <std::vector <std::uint32_t> > sources (cells);
+    std::vector <bool> can_reach (cells);
+    std::vector <std::uint16_t> distance (cells);
+    std::vector <std::uint32_t> queue;
+    queue.reserve(cells);
+
+    // hole 0 stands for no hole kept open
+    std::vector <ball_id_t> open_holes (1, 0);
+    for (const auto & ball : start.GetBallsPositions())
+    {
+        open_holes.push_back(ball.second);
+    }
+
+    for (ball_id_t open : open_holes)
+    {
+        // cells balls can stand on and holes which can be closed while the
+        // hole is open
+        Reach reach;
+        StartReach(start, reach);
+        std::vector <bool> passable (hole_cells_.size(), true);
+        for (const auto & hole : start.GetHoles())
+        {
+            passable[hole.second] = false;
+        }
+        SpreadInOrder(open, passable, reach);
+
+        for (size_t ball=0; ball<reach.ids.size(); ++ball)
+        {
+            ball_id_t id = reach.ids[ball];
+            if (id == open)
+            {
+                continue;
+            }
+            const std::vector <bool> & own = reach.can_stand[ball];
+
+            for (auto & from : sources)
+            {
+                from.clear();
+            }
+            can_reach.assign(cells, false);
+            queue.clear();
+
+            // cells are queued in order of their distance to the hole
+            auto fall_in = [&can_reach, &distance, &queue] (std::uint32_t from,
+                                                            std::uint16_t moves)
+            {
+                if (!can_reach[from])
+                {
+                    can_reach[from] = true;
+                    distance[from] = moves;
+                    queue.push_back(from);
+                }
+            };
+
+            // same moves as %Spread makes
+            for (std::uint32_t from=0; from<cells; ++from)
+            {
+                for (size_t to=0; to<4; ++to)
+                {
+                    size_t ray = from * 4 + to;
+                    ball_id_t gap = 0;
+                    for (std::uint32_t n=way_begin_[ray]; n<way_begin_[ray + 1]; ++n)
+                    {
+                        if ((way_holes_[n] == id) || !passable[way_holes_[n]])
+                        {
+                            gap = way_holes_[n];
+                            break;
+                        }
+                    }
+                    if (gap == id)
+                    {
+                        fall_in(from, 1);
+                        continue;
+                    }
+                    if (gap != 0)
+                    {
+                        continue;
+                    }
+
+                    std::uint32_t end = ray_begin_[ray + 1];
+                    for (std::uint32_t n=ray_begin_[ray]; n<end; ++n)
+                    {
+                        std::uint32_t cell = rays_[n];
+                        if ((n + 1 != end) &&
+                            (reach.standing[rays_[n + 1]] <= (own[rays_[n + 1]] ? 1u : 0u)))
+                        {
+                            continue;
+                        }
+
+                        ball_id_t hole = holes_[cell];
+                        if (hole == id)
+                        {
+                            fall_in(from, 1);
+                        }
+                        else if ((hole == 0) || passable[hole])
+                        {
+                            sources[cell].push_back(from);
+                        }
+                    }
+                }
+            }
+
+            for (size_t i=0; i<queue.size(); ++i)
+            {
+                for (std::uint32_t from : sources[queue[i]])
+                {
+                    fall_in(from, distance[queue[i]] + 1);
+                }
+            }
+
+            std::uint64_t * needs = &order.needs[(id - 1) * cells];
+            std::uint16_t * moves = &order.moves[(id - 1) * cells];
+            for (std::uint32_t cell=0; cell<cells; ++cell)
+            {
+                if (!can_reach[cell])
+                {
+                    needs[cell] |= std::uint64_t(1) << open;
+                }
+                else if (open == 0)
+                {
+                    // only moves counted with no hole kept open are right
+                    // for every state
+                    moves[cell] = distance[cell];
+                }
+            }
+        }
+    }
+    return order;
+}
+
+bool SolvabilityCheck::IsHopeless(const HoleOrder &order, const Movement &state) const
+{
+    if (order.needs.empty())
+    {
+        return false;
+    }
+
+    std::uint64_t open = 0;
+    for (const auto & ball : state.GetBallsPositions())
+    {
+        open |= std::uint64_t(1) << ball.second;
+    }
+
+    // most states have no ball waiting, cycles are looked for only then
+    bool waiting = false;
+    for (const auto & ball : state.GetBallsPositions())
+    {
+        std::uint64_t needs = order.needs[(ball.second - 1) * order.cells +
+                                          GetCell(ball.first)];
+        if ((needs & 1) != 0)
+        {
+            return true;
+        }
+        waiting = waiting || ((needs & open) != 0);
+    }
+    return waiting && (FindCycle(order, state) != 0);
+}
+
+size_t SolvabilityCheck::GetLowerBound(const HoleOrder &order, const Movement &state) const
+{
+    size_t bound = 0;
+    if (order.moves.empty())
+    {
+        return bound;
+    }
+
+    for (const auto & ball : state.GetBallsPositions())
+    {
+        bound = std::max <size_t> (bound, order.moves[(ball.second - 1) * order.cells +
+                                                      GetCell(ball.first)]);
+    }
+    return bound;
+}
+
+size_t SolvabilityCheck::GetMovesLeft(const HoleOrder &order, const Movement &state) const
+{
+    size_t moves = 0;
+    if (order.moves.empty())
+    {
+        return moves;
+    }
+
+    for (const auto & ball : state.GetBallsPositions())
+    {
+        moves += order.moves[(ball.second - 1) * order.cells + GetCell(ball.first)];
+    }
+    return moves;
+}
+
+std::vector<std::pair<ball_id_t, ball_id_t> >
+SolvabilityCheck::GetForcedOrder(const HoleOrder &order, const Movement &state) const
+{
+    std::vector <std::pair <ball_id_t, ball_id_t> > forced;
+    if (order.needs.empty())
+    {
+        return forced;
+    }
+
+    std::uint64_t open = 0;
+    for (const auto & ball : state.GetBallsPositions())
+    {
+        open |= std::uint64_t(1) << ball.second;
+    }
+    for (const auto & ball : state.GetBallsPositions())
+    {
+        std::uint64_t waits = order.needs[(ball.second - 1) * order.cells +
+                                          GetCell(ball.first)] & open;
+        for (ball_id_t hole=1; hole<hole_cells_.size(); ++hole)
+        {
+            if ((waits & (std::uint64_t(1) << hole)) != 0)
+            {
+                forced.push_back(std::make_pair(hole, ball.second));
+            }
+        }
+    }
+    std::sort(forced.begin(), forced.end());
+    return forced;
+}
+
+void SolvabilityCheck::StartReach(const Movement &state, Reach &reach) const
+{
+    const auto & balls = state.GetBallsPositions();
+    size_t cells = holes_.size();
+
+    reach.ids.clear();
+    reach.cells.assign(balls.size(), std::vector <std::uint32_t> ());
+    reach.can_stand.assign(balls.size(), std::vector <bool> (cells, false));
+    reach.standing.assign(cells, 0);
+    reach.reached.assign(balls.size(), false);
+
+    for (const auto & ball : balls)
+    {
+        std::uint32_t cell = GetCell(ball.first);
+        reach.cells[reach.ids.size()].push_back(cell);
+        reach.can_stand[reach.ids.size()][cell] = true;
+        ++reach.standing[cell];
+        reach.ids.push_back(ball.second);
+    }
+}
+
+void SolvabilityCheck::Spread(const std::vector<bool> &passable, Reach &reach) const
+{
+    // fallen ball leaves the board, but treating its hole as a cell it can
+    // stand on only widens the relaxed reach, so the check stays sound
+    auto fall_in = [this, &reach] (size_t ball)
+    {
+        if (reach.reached[ball])
+        {
+            return false;
+        }
+        reach.reached[ball] = true;
+        std::uint32_t cell = hole_cells_[reach.ids[ball]];
+        reach.can_stand[ball][cell] = true;
+        ++reach.standing[cell];
+        return true;
+    };
+
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (size_t ball=0; ball<reach.ids.size(); ++ball)
+        {
+            ball_id_t id = reach.ids[ball];
+            std::vector <bool> & own = reach.can_stand[ball];
+            std::vector <std::uint32_t> & cells = reach.cells[ball];
+
+            // new cells are appended while they are rolled from
+            for (size_t i=0; i<cells.size(); ++i)
+            {
+                std::uint32_t from = cells[i];
+                for (size_t to=0; to<4; ++to)
+                {
+                    size_t ray = from * 4 + to;
+
+                    // ball falls into the first open hole on its way,
+                    // game is lost if it is not its own one
+                    ball_id_t gap = 0;
+                    for (std::uint32_t n=way_begin_[ray]; n<way_begin_[ray + 1]; ++n)
+                    {
+                        if ((way_holes_[n] == id) || !passable[way_holes_[n]])
+                        {
+                            gap = way_holes_[n];
+                            break;
+                        }
+                    }
+                    if (gap == id)
+                    {
+                        changed |= fall_in(ball);
+                        continue;
+                    }
+                    if (gap != 0)
+                    {
+                        continue;
+                    }
+
+                    std::uint32_t end = ray_begin_[ray + 1];
+                    for (std::uint32_t n=ray_begin_[ray]; n<end; ++n)
+                    {
+                        // ball stops at its neighbour or before another ball
+                        std::uint32_t cell = rays_[n];
+                        if ((n + 1 != end) &&
+                            (reach.standing[rays_[n + 1]] <= (own[rays_[n + 1]] ? 1u : 0u)))
+                        {
+                            continue;
+                        }
+
+                        // holes skipped by the move graph are checked where
+                        // ball stops
+                        ball_id_t hole = holes_[cell];
+                        if (hole == id)
+                        {
+                            changed |= fall_in(ball);
+                        }
+                        else if (((hole == 0) || passable[hole]) && !own[cell])
+                        {
+                            own[cell] = true;
+                            ++reach.standing[cell];
+                            cells.push_back(cell);
+                            changed = true;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+void SolvabilityCheck::SpreadInOrder(ball_id_t open, std::vector<bool> &passable,
+                                     Reach &reach) const
+{
+    // balls get into their holes one by one, holes of the balls already
+    // there can be crossed by the rest
+    bool closed = true;
+    while (closed)
+    {
+        Spread(passable, reach);
+        closed = false;
+        for (size_t ball=0; ball<reach.ids.size(); ++ball)
+        {
+            ball_id_t id = reach.ids[ball];
+            if (reach.reached[ball] && !passable[id] && (id != open))
+            {
+                passable[id] = true;
+                closed = true;
+            }
+        }
+    }
+}
+
+ball_id_t SolvabilityCheck::FindCycle(const HoleOrder &order, const Movement &state) const
+{
+    if (order.needs.empty())
+    {
+        return 0;
+    }
+
+    std::uint64_t open = 0;
+    for (const auto & ball : state.GetBallsPositions())
+    {
+        open |= std::uint64_t(1) << ball.second;
+    }
+    std::vector <std::uint64_t> waits (hole_cells_.size(), 0);
+    for (const auto & ball : state.GetBallsPositions())
+    {
+        waits[ball.second] = order.needs[(ball.second - 1) * order.cells +
+                                         GetCell(ball.first)] & open;
+    }
+
+    // balls waiting for nobody get into their holes, then the ones waiting
+    // only for them and so on
+    std::uint64_t waiting = open;
+    bool closed = true;
+    while (closed)
+    {
+        closed = false;
+        for (ball_id_t ball=1; ball<waits.size(); ++ball)
+        {
+            std::uint64_t mask = std::uint64_t(1) << ball;
+            if (((waiting & mask) != 0) && ((waits[ball] & waiting) == 0))
+            {
+                waiting &= ~mask;
+                closed = true;
+            }
+        }
+    }
+    if (waiting == 0)
+    {
+        return 0;
+    }
+
+    // every ball left waits for another one left, following the waits
+    // leads into a cycle
+    auto next = [&waits, &waiting] (ball_id_t ball)
+    {
+        ball_id_t hole = 1;
+        while ((waits[ball] & waiting & (std::uint64_t(1) << hole)) == 0)
+        {
+            ++hole;
+        }
+        return hole;
+    };
+
+    ball_id_t ball = next(LowestHole(waiting));
+    for (size_t i=0; i<waits.size(); ++i)
+    {
+        ball = next(ball);
+    }
+    ball_id_t lowest = ball;
+    for (ball_id_t cycle = next(ball); cycle != ball; cycle = next(cycle))
+    {
+        lowest = std::min(lowest, cycle);
+    }
+    return lowest;
+}
+
+std::uint32_t SolvabilityCheck::GetCell(const coordinates_t &cell) const
+{
+    return (cell.y - 1) * table_size_ + (cell.x - 1);
+}
+
+std::ostream &
+operator<<(std::ostream &os, const SolvabilityCheck::Result &result)
+{
+    switch (result.reason)
+    {
+    case SolvabilityCheck::Reason::None:
+        os << "Game may be won";
+        break;
+    case SolvabilityCheck::Reason::Unreachable:
+        os << "Game can not be won: ball " << result.ball
+           << " can not reach its hole";
+        break;
+    case SolvabilityCheck::Reason::Blocked:
+        os << "Game can not be won: ball " << result.ball
+           << " can not reach its hole before holes on its way are closed";
+        break;
+    case SolvabilityCheck::Reason::Cycle:
+        os << "Game can not be won: ball " << result.ball
+           << " waits for holes waiting for its own one";
+        break;
+    }
+    return os;
+}
@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2017, Ivan
+ * 
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TG_SOLVABILITY_H
+#define TG_SOLVABILITY_H
+
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <vector>
+
+#include "tg_types.h"
+#include "board_cell.h"
+#include "move_graph.h"
+#include "movement.h"
+
+//!
+//! \brief The SolvabilityCheck class Proves that game can not be won without
+//! searching its states. Every ball is followed on its own: it rolls along
+//! the move graph, it may stop before any cell another ball can ever stand
+//! on and it may cross holes of the balls which can be in their holes
+//! earlier. Such moves include every move the game allows, so a ball which
+//! can not get into its hole this way will never get there. Balls get into
+//! their holes one by one: ball can cross hole of another one only after
+//! that one is proved to be able to get into its hole first.
+//!
+//! Hole order tells for every ball and every cell which holes must be
+//! closed before the ball gets from that cell into its own hole: a ball
+//! which can not avoid crossing a hole waits for it. Balls waiting for each
+//! other can not win, so the search drops such states
+//!
+class SolvabilityCheck
+{
+public:
+    //!
+    //! \brief The Reason enum Why game can not be won
+    //!
+    enum class Reason
+    {
+        None,       //!< not proved, game may be won
+        Unreachable,//!< ball can not get to its hole from its cell at all
+        //! \brief Blocked every way of the ball to its hole crosses holes
+        //! which can not be closed before
+        Blocked,
+        //! \brief Cycle ball waits for a hole which waits for the hole of
+        //! this ball, directly or through other holes
+        Cycle
+    };
+
+    //!
+    //! \brief The Result struct Outcome of %Check
+    //!
+    struct Result
+    {
+        Reason reason;  //!< why game can not be won
+        ball_id_t ball; //!< ball with the lowest id proved not to win, 0 if none
+    };
+
+    //!
+    //! \brief SolvabilityCheck Prepare check of states on given board
+    //! \param board board cells with their holes, every cell of the table
+    //! must be present
+    //! \param move_graph move graph of the board
+    //! \param table_size board size
+    //!
+    SolvabilityCheck (const std::map <const coordinates_t, BoardCell> & board,
+                      const std::map <const coordinates_t, GraphItem> & move_graph,
+                      coordinate_t table_size);
+
+    //!
+    //! \brief Check Try to prove that game can not be won from the state.
+    //! Costs about as much as expanding a few dozens of search states
+    //! \param state game state
+    //! \return proof, reason is None if game may be won
+    //!
+    Result Check (const Movement & state) const;
+
+    //!
+    //! \brief The HoleOrder struct Holes every ball waits for, by cell of the
+    //! ball, see %MakeHoleOrder
+    //!
+    struct HoleOrder
+    {
+        size_t cells; //!< cells of the board
+        //! \brief needs bit h of needs[(b-1)*cells+c] is set if ball b can not
+        //! get from cell c into its hole while hole h is open, bit 0 if it can
+        //! not get there at all. Empty if hole ids do not fit the bits
+        std::vector <std::uint64_t> needs;
+        //! \brief moves moves[(b-1)*cells+c] is the least number of moves
+        //! ball b needs to get from cell c into its hole, %NO_MOVES if it can
+        //! not get there. Laid out and empty as %needs
+        std::vector <std::uint16_t> moves;
+    };
+
+    //! \brief NO_MOVES see %HoleOrder::moves
+    static const std::uint16_t NO_MOVES = 0xFFFF;
+
+    //!
+    //! \brief MakeHoleOrder Find holes every ball waits for in the states
+    //! reached from given one. Costs about as much as %Check for every ball
+    //! \param start game state the states are reached from
+    //! \return hole order, valid for \a start and states reached from it
+    //!
+    HoleOrder MakeHoleOrder (const Movement & start) const;
+
+    //!
+    //! \brief IsHopeless Check if game can not be won from the state by the
+    //! hole order: some ball can not get into its hole or balls wait for
+    //! each other
+    //! \param order hole order made for the state or one it was reached from
+    //! \param state game state
+    //! \return true if game can not be won
+    //!
+    bool IsHopeless (const HoleOrder & order, const Movement & state) const;
+
+    //!
+    //! \brief GetLowerBound Gives moves the game needs at least to be won
+    //! from the state: every ball needs its own moves by hole order, all of
+    //! them roll at once
+    //! \param order hole order made for the state or one it was reached from
+    //! \param state game state
+    //! \return least number of moves, %NO_MOVES if some ball can not get
+    //! into its hole, 0 if hole order is empty
+    //!
+    size_t GetLowerBound (const HoleOrder & order, const Movement & state) const;
+
+    //!
+    //! \brief GetMovesLeft Gives moves all the balls need by hole order as if
+    //! they rolled one by one. Greedy search takes it for the distance to the
+    //! win, it is no bound
+    //! \param order hole order made for the state or one it was reached from
+    //! \param state game state
+    //! \return sum of moves of all the balls, 0 if hole order is empty
+    //!
+    size_t GetMovesLeft (const HoleOrder & order, const Movement & state) const;
+
+    //!
+    //! \brief GetForcedOrder Gives holes which must be closed before others
+    //! \param order hole order made for the state or one it was reached from
+    //! \param state game state
+    //! \return pairs of hole ids: first one is closed before second one.
+    //! Only open holes are given
+    //!
+    std::vector <std::pair <ball_id_t, ball_id_t> >
+    GetForcedOrder (const HoleOrder & order, const Movement & state) const;
+
+private:
+    //!
+    //! \brief The Reach struct Cells balls can stand on, grown by %Spread
+    //!
+    struct Reach
+    {
+        std::vector <ball_id_t> ids; //!< ids of the balls on the board
+        //! \brief cells cells every ball can stand on, in order they are found
+        std::vector <std::vector <std::uint32_t> > cells;
+        //! \brief can_stand same cells of every ball as a mask, its hole is
+        //! there too once it is reached
+        std::vector <std::vector <bool> > can_stand;
+        std::vector <std::uint32_t> standing; //!< balls able to stand on a cell
+        std::vector <bool> reached; //!< ball can get into its hole
+    };
+
+    //!
+    //! \brief StartReach Put balls of the state on their cells
+    //! \param state game state
+    //! \param reach reach to be started
+    //!
+    void StartReach (const Movement & state, Reach & reach) const;
+
+    //!
+    //! \brief Spread Roll balls until none of them gets new cells, as new
+    //! cells of one ball give new stops to others
+    //! \param passable holes which can be crossed, indexed by hole id
+    //! \param reach cells found so far
+    //!
+    void Spread (const std::vector <bool> & passable, Reach & reach) const;
+
+    //!
+    //! \brief SpreadInOrder Roll balls as %Spread does, letting them cross
+    //! holes of the balls proved to get there. Balls get into their holes
+    //! one by one, so this finds every hole which can be closed while
+    //! another one is open
+    //! \param open hole kept open, 0 for none
+    //! \param passable holes which can be crossed, holes found to be closed
+    //! are added
+    //! \param reach cells found so far
+    //!
+    void SpreadInOrder (ball_id_t open, std::vector <bool> & passable,
+                        Reach & reach) const;
+
+    //!
+    //! \brief FindCycle Find balls waiting for each other by hole order
+    //! \param order hole order
+    //! \param state game state
+    //! \return lowest id of the balls in a cycle, 0 if there is no cycle
+    //!
+    ball_id_t FindCycle (const HoleOrder & order, const Movement & state) const;
+
+    //!
+    //! \brief GetCell Gives index of the cell in board vectors
+    //! \param cell cell coordinates
+    //! \return cell index
+    //!
+    std::uint32_t GetCell (const coordinates_t & cell) const;
+
+    //! \brief table_size_ board size
+    coordinate_t table_size_;
+
+    //! \brief holes_ hole id of every cell, 0 if cell has no hole
+    std::vector <ball_id_t> holes_;
+
+    //! \brief hole_cells_ cell of every hole, indexed by hole id
+    std::vector <std::uint32_t> hole_cells_;
+
+    //! \brief rays_ cells passed by a ball rolled from every cell in every
+    //! direction up to its neighbour in the move graph. Cells of the ray of
+    //! cell c and direction d are between %ray_begin_[c*4+d] and
+    //! %ray_begin_[c*4+d+1]
+    std::vector <std::uint32_t> rays_;
+
+    //! \brief ray_begin_ see %rays_
+    std::vector <std::uint32_t> ray_begin_;
+
+    //! \brief way_holes_ ids of the holes on the way of every ray, ball falls
+    //! into the first open one. Laid out as %rays_
+    std::vector <ball_id_t> way_holes_;
+
+    //! \brief way_begin_ see %way_holes_
+    std::vector <std::uint32_t> way_begin_;
+};
+
+std::ostream &
+operator<< (std::ostream & os, const SolvabilityCheck::Result & result);
+
+#endif // TG_SOLVABILITY_H
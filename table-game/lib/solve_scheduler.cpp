@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2017, Ivan
+ * 
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "solve_scheduler.h"
+
+#include <algorithm>
+
+const size_t SolveScheduler::DEFAULT_SLICE;
+
+SolveScheduler::SolveScheduler(size_t workers, size_t slice)
+    : slice_(std::max <size_t> (slice, 1))
+    , cache_(nullptr)
+    , graph_cache_(nullptr)
+    , tablebase_(nullptr)
+    , slices_(0)
+    , pool_(workers)
+{
+}
+
+SolveScheduler::~SolveScheduler()
+{
+    pool_.Wait();
+}
+
+void SolveScheduler::SetCache(SolutionCache *cache)
+{
+    cache_ = cache;
+}
+
+void SolveScheduler::SetMoveGraphCache(MoveGraphCache *graph_cache)
+{
+    graph_cache_ = graph_cache;
+}
+
+void SolveScheduler::SetTablebase(const Tablebase *tablebase)
+{
+    tablebase_ = tablebase;
+}
+
+void SolveScheduler::Submit(const InputData &in, done_t done)
+{
+    std::shared_ptr <Job> job = std::make_shared <Job> ();
+    job->in.reset(new InputData(in));
+    job->done = std::move(done);
+    pool_.Submit([this, job] () { RunSlice(job); });
+}
+
+void SolveScheduler::Wait()
+{
+    pool_.Wait();
+}
+
+size_t SolveScheduler::GetSlicesCount() const
+{
+    return slices_.load();
+}
+
+void SolveScheduler::RunSlice(const std::shared_ptr<Job> &job)
+{
+    ++slices_;
+
+    SolveResult result;
+    bool finished = (job->table == nullptr) ? Start(*job, result) : false;
+    if (!finished && (job->table != nullptr))
+    {
+        finished = job->table->ContinueCalculation(slice_);
+    }
+
+    if (!finished)
+    {
+        // queued behind every puzzle which is already waiting
+        pool_.Submit([this, job] () { RunSlice(job); });
+        return;
+    }
+
+    if (job->table != nullptr)
+    {
+        result.moves = job->table->GetMoves();
+        result.status = result.moves.empty() ? SolveResult::Status::NoSolution
+                                             : SolveResult::Status::Solved;
+        job->table.reset();
+    }
+    job->done(result);
+}
+
+bool SolveScheduler::Start(Job &job, SolveResult &result)
+{
+    std::unique_ptr <InputData> in (std::move(job.in));
+    if (InputData::Status::Ok != in->GetDataStatus())
+    {
+        result.status = SolveResult::Status::InvalidInput;
+        result.error = in->GetErrorString();
+        return true;
+    }
+
+    job.table.reset(new GameTable(*in, cache_, graph_cache_));
+    if ((tablebase_ != nullptr) && tablebase_->Matches(*in))
+    {
+        job.table->SetTablebase(tablebase_);
+    }
+    return job.table->StartCalculation();
+}
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2017, Ivan
+ * 
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TG_SOLVE_SCHEDULER_H
+#define TG_SOLVE_SCHEDULER_H
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+#include "move_graph_cache.h"
+#include "solution_cache.h"
+#include "solver.h"
+#include "table.h"
+#include "tablebase.h"
+#include "thread_pool.h"
+#include "tg_types.h"
+
+//!
+//! \brief The SolveScheduler class Solves many puzzles at once on a fixed
+//! thread pool by time slices. Every slice expands at most %slice_ search
+//! states of one puzzle, then the puzzle goes to the end of the queue.
+//! Short puzzles are finished by first slices, while long ones make steady
+//! progress without taking workers for long.
+//!
+//! Puzzle waiting for its first slice holds only its input data, suspended
+//! puzzle holds its table and search layers
+//!
+class SolveScheduler
+{
+public:
+    //!
+    //! \brief done_t called on worker thread with result of the puzzle
+    //!
+    using done_t = std::function <void (const SolveResult &)>;
+
+    //!
+    //! \brief DEFAULT_SLICE Search states expanded by one slice by default
+    //!
+    static const size_t DEFAULT_SLICE = 4096;
+
+    //!
+    //! \brief SolveScheduler Start workers
+    //! \param workers number of worker threads, 0 to use all hardware threads
+    //! \param slice search states expanded by one slice, at least 1
+    //!
+    SolveScheduler (size_t workers, size_t slice = DEFAULT_SLICE);
+
+    //!
+    //! \brief ~SolveScheduler Wait for all the puzzles
+    //!
+    ~SolveScheduler ();
+
+    SolveScheduler (const SolveScheduler &) = delete;
+    SolveScheduler & operator= (const SolveScheduler &) = delete;
+
+    //!
+    //! \brief SetCache Use solution cache for all the puzzles
+    //! \param cache solution cache, null to solve every puzzle
+    //!
+    void SetCache (SolutionCache * cache);
+
+    //!
+    //! \brief SetMoveGraphCache Use move graphs cache for all the puzzles
+    //! \param graph_cache move graphs cache, null to build every graph
+    //!
+    void SetMoveGraphCache (MoveGraphCache * graph_cache);
+
+    //!
+    //! \brief SetTablebase Use tablebase for puzzles of its board
+    //! \param tablebase tablebase, null to search every puzzle
+    //!
+    void SetTablebase (const Tablebase * tablebase);
+
+    //!
+    //! \brief Submit Queue puzzle to be solved. Caches must be set before
+    //! \param in puzzle input data
+    //! \param done called with result, the same one %SolvePuzzle gives
+    //!
+    void Submit (const InputData & in, done_t done);
+
+    //!
+    //! \brief Wait Block until all submitted puzzles are solved
+    //!
+    void Wait ();
+
+    //!
+    //! \brief GetSlicesCount Gives number of slices done so far
+    //! \return slices count
+    //!
+    size_t GetSlicesCount () const;
+
+private:
+    //!
+    //! \brief The Job struct Puzzle being solved
+    //!
+    struct Job
+    {
+        std::unique_ptr <InputData> in;    //!< input data, until started
+        std::unique_ptr <GameTable> table; //!< table, once started
+        done_t done;                       //!< result callback
+    };
+
+    size_t slice_; //!< search states expanded by one slice
+    SolutionCache * cache_; //!< solution cache, may be null
+    MoveGraphCache * graph_cache_; //!< move graphs cache, may be null
+    const Tablebase * tablebase_; //!< tablebase, may be null
+    std::atomic <size_t> slices_; //!< see %GetSlicesCount
+
+    //! \brief pool_ workers. Declared last to be destroyed before everything
+    //! workers use
+    ThreadPool pool_;
+
+    //!
+    //! \brief RunSlice Give puzzle one slice, then queue it again or report
+    //! its result
+    //! \param job puzzle
+    //!
+    void RunSlice (const std::shared_ptr <Job> & job);
+
+    //!
+    //! \brief Start Validate puzzle, create its table and start calculation
+    //! \param job puzzle
+    //! \param result set if puzzle is finished
+    //! \return true if puzzle is finished
+    //!
+    bool Start (Job & job, SolveResult & result);
+};
+
+#endif // TG_SOLVE_SCHEDULER_H
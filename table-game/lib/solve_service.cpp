@@ -0,0 +1,554 @@
+/*
+ * Copyright (c) 2017, Ivan
+ * 
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "solve_service.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "serve.h"
+
+namespace
+{
+
+//! \brief LISTEN_ID epoll data of listening socket
+const std::uint64_t LISTEN_ID = 0;
+//! \brief WAKE_ID epoll data of wake up event
+const std::uint64_t WAKE_ID = 1;
+//! \brief READ_SIZE amount of data read from client at once
+const size_t READ_SIZE = 64 * 1024;
+
+}
+
+SolveService::SolveService(const std::string &socket_path, size_t workers,
+                           size_t max_queue, SolutionCache *cache)
+    : socket_path_(socket_path)
+    , workers_(workers)
+    , max_queue_(max_queue == 0 ? 1 : max_queue)
+    , cache_(cache)
+    , listen_fd_(-1)
+    , epoll_fd_(-1)
+    , event_fd_(-1)
+    , stop_(false)
+    , next_connection_id_(WAKE_ID + 1)
+    , requests_(0)
+    , solved_(0)
+    , merged_(0)
+    , cancelled_(0)
+{
+}
+
+SolveService::~SolveService()
+{
+    // nobody gets answers any more, puzzles are not solved to the end
+    for (auto & job : jobs_)
+    {
+        job.second.handle.Cancel();
+    }
+    // let workers finish before closing descriptors they wake loop with
+    pool_.reset();
+
+    while (!connections_.empty())
+    {
+        Close(connections_.begin()->first);
+    }
+    if (listen_fd_ >= 0)
+    {
+        close(listen_fd_);
+        unlink(socket_path_.c_str());
+    }
+    if (event_fd_ >= 0)
+    {
+        close(event_fd_);
+    }
+    if (epoll_fd_ >= 0)
+    {
+        close(epoll_fd_);
+    }
+}
+
+bool SolveService::Start()
+{
+    struct sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socket_path_.size() >= sizeof(address.sun_path))
+    {
+        return false;
+    }
+    std::strcpy(address.sun_path, socket_path_.c_str());
+
+    listen_fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0)
+    {
+        return false;
+    }
+
+    unlink(socket_path_.c_str());
+    if ((bind(listen_fd_, reinterpret_cast<struct sockaddr*>(&address),
+              sizeof(address)) != 0) ||
+        (listen(listen_fd_, SOMAXCONN) != 0))
+    {
+        return false;
+    }
+
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    event_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if ((epoll_fd_ < 0) || (event_fd_ < 0))
+    {
+        return false;
+    }
+
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.u64 = LISTEN_ID;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, listen_fd_, &event) != 0)
+    {
+        return false;
+    }
+    event.data.u64 = WAKE_ID;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, event_fd_, &event) != 0)
+    {
+        return false;
+    }
+
+    pool_.reset(new ThreadPool(workers_));
+    return true;
+}
+
+void SolveService::Run()
+{
+    const int max_events = 64;
+    struct epoll_event events[max_events];
+
+    while (!stop_)
+    {
+        int count = epoll_wait(epoll_fd_, events, max_events, -1);
+        if (count < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return;
+        }
+
+        for (int i=0; i<count; ++i)
+        {
+            std::uint64_t id = events[i].data.u64;
+            if (id == LISTEN_ID)
+            {
+                Accept();
+            }
+            else if (id == WAKE_ID)
+            {
+                std::uint64_t value;
+                while (read(event_fd_, &value, sizeof(value)) > 0);
+                DeliverCompleted();
+            }
+            else if (connections_.count(id) != 0)
+            {
+                if (events[i].events & (EPOLLERR | EPOLLHUP))
+                {
+                    // client has gone, nobody will read responses
+                    Close(id);
+                    continue;
+                }
+                if (events[i].events & EPOLLOUT)
+                {
+                    Flush(id);
+                    CloseIfDone(id);
+                }
+                if ((connections_.count(id) != 0) && (events[i].events & EPOLLIN))
+                {
+                    Read(id);
+                }
+            }
+        }
+    }
+}
+
+void SolveService::Stop()
+{
+    stop_ = true;
+    Wake();
+}
+
+SolveService::Stats SolveService::GetStats() const
+{
+    return Stats{requests_.load(), solved_.load(), merged_.load(),
+                 cancelled_.load()};
+}
+
+void SolveService::Accept()
+{
+    while (1)
+    {
+        int fd = accept4(listen_fd_, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+        {
+            return;
+        }
+
+        std::uint64_t id = next_connection_id_++;
+        connections_[id] = Connection{fd, "", "", 0, false, false};
+
+        struct epoll_event event;
+        event.events = EPOLLIN;
+        event.data.u64 = id;
+        if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) != 0)
+        {
+            Close(id);
+        }
+    }
+}
+
+void SolveService::Read(std::uint64_t id)
+{
+    Connection & connection = connections_.at(id);
+    if (connection.blocked || connection.read_closed)
+    {
+        return;
+    }
+
+    char buffer[READ_SIZE];
+    while (1)
+    {
+        ssize_t size = read(connection.fd, buffer, sizeof(buffer));
+        if (size > 0)
+        {
+            connection.input.append(buffer, size);
+            continue;
+        }
+        if (size == 0)
+        {
+            connection.read_closed = true;
+            break;
+        }
+        if (errno == EINTR)
+        {
+            continue;
+        }
+        if ((errno != EAGAIN) && (errno != EWOULDBLOCK))
+        {
+            Close(id);
+            return;
+        }
+        break;
+    }
+
+    ProcessInput(id);
+}
+
+void SolveService::ProcessInput(std::uint64_t id)
+{
+    Connection & connection = connections_.at(id);
+
+    size_t start = 0;
+    while (1)
+    {
+        size_t line_end = connection.input.find('\n', start);
+        if (line_end == std::string::npos)
+        {
+            if (connection.read_closed && (start < connection.input.size()))
+            {
+                // last request without line end
+                line_end = connection.input.size();
+            }
+            else
+            {
+                break;
+            }
+        }
+
+        if (jobs_.size() >= max_queue_)
+        {
+            // queue is full: stop reading the client until workers catch up
+            if (!connection.blocked)
+            {
+                connection.blocked = true;
+                blocked_.push_back(id);
+            }
+            break;
+        }
+
+        HandleRequest(id, connection.input.substr(start, line_end - start));
+        if (connections_.count(id) == 0)
+        {
+            // failed to send response
+            return;
+        }
+        start = std::min(line_end + 1, connection.input.size());
+    }
+    connection.input.erase(0, start);
+
+    UpdateEvents(id);
+    CloseIfDone(id);
+}
+
+void SolveService::HandleRequest(std::uint64_t id, const std::string &line)
+{
+    std::string request_id;
+    input_data_t data;
+
+    switch (ParseRequest(line, request_id, data))
+    {
+    case RequestStatus::Empty:
+        return;
+    case RequestStatus::NotNumeric:
+        ++requests_;
+        Send(id, request_id + " ERR Request contains non-numeric data.");
+        return;
+    case RequestStatus::Ok:
+        break;
+    }
+
+    ++requests_;
+    ++connections_.at(id).pending;
+
+    std::string key (reinterpret_cast<const char*>(data.data()),
+                     data.size() * sizeof(coordinate_t));
+    auto job = jobs_.find(key);
+    if (job != jobs_.end())
+    {
+        ++merged_;
+        job->second.waiters.push_back(waiter_t(id, request_id));
+        return;
+    }
+
+    Job & created = jobs_[key];
+    created.data = std::move(data);
+    created.waiters.push_back(waiter_t(id, request_id));
+    StartJob(key, created);
+}
+
+void SolveService::StartJob(const std::string &key, Job &job)
+{
+    AsyncSolveOptions options = AsyncSolveOptions();
+    options.cache = cache_;
+    options.done = [this, key] (const SolveResult & result)
+    {
+        if (result.status != SolveResult::Status::Cancelled)
+        {
+            ++solved_;
+        }
+        {
+            std::lock_guard <std::mutex> lock (completed_mutex_);
+            completed_.push_back(std::make_pair(key, result));
+        }
+        Wake();
+    };
+    job.handle = SolveAsync(*pool_, job.data, &options);
+}
+
+void SolveService::DeliverCompleted()
+{
+    std::vector <std::pair <std::string, SolveResult> > completed;
+    {
+        std::lock_guard <std::mutex> lock (completed_mutex_);
+        completed.swap(completed_);
+    }
+
+    for (const auto & item : completed)
+    {
+        auto job = jobs_.find(item.first);
+        if (job == jobs_.end())
+        {
+            continue;
+        }
+
+        if ((item.second.status == SolveResult::Status::Cancelled) &&
+            !job->second.waiters.empty())
+        {
+            // new request came for the puzzle after it was cancelled
+            StartJob(item.first, job->second);
+            continue;
+        }
+
+        std::vector <waiter_t> waiters;
+        waiters.swap(job->second.waiters);
+        jobs_.erase(job);
+
+        for (const auto & waiter : waiters)
+        {
+            auto connection = connections_.find(waiter.first);
+            if (connection == connections_.end())
+            {
+                // client has gone
+                continue;
+            }
+            --connection->second.pending;
+            Send(waiter.first, FormatResponse(waiter.second, item.second));
+            CloseIfDone(waiter.first);
+        }
+    }
+
+    // resume paused clients in the order they were paused
+    while (!blocked_.empty() && (jobs_.size() < max_queue_))
+    {
+        std::uint64_t id = blocked_.front();
+        blocked_.pop_front();
+
+        auto connection = connections_.find(id);
+        if (connection == connections_.end())
+        {
+            continue;
+        }
+        connection->second.blocked = false;
+        ProcessInput(id);
+        if ((connections_.count(id) != 0) && !connections_.at(id).blocked)
+        {
+            // data could come while client was paused
+            Read(id);
+        }
+    }
+}
+
+void SolveService::Send(std::uint64_t id, const std::string &line)
+{
+    Connection & connection = connections_.at(id);
+    connection.output.append(line);
+    connection.output.push_back('\n');
+    Flush(id);
+}
+
+void SolveService::Flush(std::uint64_t id)
+{
+    Connection & connection = connections_.at(id);
+
+    size_t sent = 0;
+    while (sent < connection.output.size())
+    {
+        ssize_t size = send(connection.fd, connection.output.data() + sent,
+                            connection.output.size() - sent, MSG_NOSIGNAL);
+        if (size > 0)
+        {
+            sent += size;
+            continue;
+        }
+        if ((size < 0) && (errno == EINTR))
+        {
+            continue;
+        }
+        if ((size < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK)))
+        {
+            break;
+        }
+        Close(id);
+        return;
+    }
+    connection.output.erase(0, sent);
+
+    UpdateEvents(id);
+}
+
+void SolveService::UpdateEvents(std::uint64_t id)
+{
+    Connection & connection = connections_.at(id);
+
+    struct epoll_event event;
+    event.events = 0;
+    if (!connection.blocked && !connection.read_closed)
+    {
+        event.events |= EPOLLIN;
+    }
+    if (!connection.output.empty())
+    {
+        event.events |= EPOLLOUT;
+    }
+    event.data.u64 = id;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, connection.fd, &event);
+}
+
+void SolveService::CloseIfDone(std::uint64_t id)
+{
+    auto connection = connections_.find(id);
+    if ((connection != connections_.end()) &&
+        connection->second.read_closed && !connection->second.blocked &&
+        (connection->second.pending == 0) && connection->second.output.empty() &&
+        (connection->second.input.find_first_not_of(" \t\r\n") == std::string::npos))
+    {
+        Close(id);
+    }
+}
+
+void SolveService::Close(std::uint64_t id)
+{
+    auto connection = connections_.find(id);
+    if (connection == connections_.end())
+    {
+        return;
+    }
+
+    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, connection->second.fd, NULL);
+    close(connection->second.fd);
+    bool had_pending = connection->second.pending != 0;
+    connections_.erase(connection);
+
+    if (!had_pending)
+    {
+        return;
+    }
+
+    // nobody else waiting for the puzzle, worker is freed for the next one
+    for (auto & job : jobs_)
+    {
+        auto & waiters = job.second.waiters;
+        if (waiters.empty())
+        {
+            continue;
+        }
+        waiters.erase(std::remove_if(waiters.begin(), waiters.end(),
+                                     [id] (const waiter_t & waiter)
+                                     {
+                                         return waiter.first == id;
+                                     }),
+                      waiters.end());
+        if (waiters.empty())
+        {
+            ++cancelled_;
+            job.second.handle.Cancel();
+        }
+    }
+}
+
+void SolveService::Wake()
+{
+    std::uint64_t value = 1;
+    ssize_t size = write(event_fd_, &value, sizeof(value));
+    (void) size;
+}
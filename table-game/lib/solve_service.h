@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2017, Ivan
+ * 
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TG_SOLVE_SERVICE_H
+#define TG_SOLVE_SERVICE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "async_solve.h"
+#include "solver.h"
+#include "thread_pool.h"
+#include "tg_types.h"
+
+//!
+//! \brief The SolveService class Local solve service listening on Unix domain
+//! socket. Clients talk the same line protocol as --serve mode, see serve.h.
+//! Responses of one client may come in any order.
+//!
+//! All the clients share one worker pool. Identical puzzles being solved at
+//! the same time are solved once, and every waiter gets the answer. When
+//! %max_queue_ different puzzles are being solved, service stops reading
+//! requests, so clients are blocked by socket buffers until workers catch up.
+//! Puzzle is cancelled when all the clients waiting for it have gone.
+//!
+class SolveService
+{
+public:
+    //!
+    //! \brief The Stats struct Service counters
+    //!
+    struct Stats
+    {
+        size_t requests; //!< requests received
+        size_t solved;   //!< puzzles actually solved
+        size_t merged;   //!< requests attached to puzzle already being solved
+        size_t cancelled; //!< puzzles abandoned by all their clients
+    };
+
+    //!
+    //! \brief SolveService Create service. Socket is not opened until %Start()
+    //! \param socket_path Unix domain socket path
+    //! \param workers number of worker threads, 0 to use all hardware threads
+    //! \param max_queue maximum number of different puzzles being solved
+    //! \param cache solution cache to be used, none by default
+    //!
+    SolveService (const std::string & socket_path, size_t workers,
+                  size_t max_queue, SolutionCache * cache = nullptr);
+    ~SolveService ();
+
+    SolveService (const SolveService &) = delete;
+    SolveService & operator= (const SolveService &) = delete;
+
+    //!
+    //! \brief Start Create listening socket. Existing socket file is replaced
+    //! \return false if socket can not be created
+    //!
+    bool Start ();
+
+    //!
+    //! \brief Run Serve clients until %Stop() is called
+    //!
+    void Run ();
+
+    //!
+    //! \brief Stop Make %Run() return. May be called from any thread
+    //!
+    void Stop ();
+
+    //!
+    //! \brief GetStats Gives service counters
+    //! \return counters
+    //!
+    Stats GetStats () const;
+
+private:
+    //!
+    //! \brief The Connection struct State of one client
+    //!
+    struct Connection
+    {
+        int fd;               //!< client socket
+        std::string input;    //!< received, but not processed data
+        std::string output;   //!< responses not sent yet
+        size_t pending;       //!< requests waiting for workers
+        bool read_closed;     //!< client will not send anything more
+        bool blocked;         //!< reading is paused by full queue
+    };
+
+    //!
+    //! \brief waiter_t connection id and request id waiting for the answer
+    //!
+    using waiter_t = std::pair <std::uint64_t, std::string>;
+
+    //!
+    //! \brief The Job struct Puzzle being solved
+    //!
+    struct Job
+    {
+        input_data_t data;              //!< puzzle coordinates
+        std::vector <waiter_t> waiters; //!< requests waiting for the answer
+        SolveHandle handle;             //!< solving on worker
+    };
+
+    std::string socket_path_; //!< listening socket path
+    size_t workers_; //!< number of worker threads
+    size_t max_queue_; //!< maximum number of puzzles being solved
+    SolutionCache * cache_; //!< solution cache, may be null
+    int listen_fd_; //!< listening socket
+    int epoll_fd_; //!< epoll instance
+    int event_fd_; //!< wakes loop up on completion or stop
+    std::atomic <bool> stop_; //!< %Run() must return
+
+    //! \brief connections_ clients by connection id
+    std::map <std::uint64_t, Connection> connections_;
+    //! \brief next_connection_id_ id of the next accepted client
+    std::uint64_t next_connection_id_;
+    //! \brief jobs_ every puzzle being solved, by puzzle key
+    std::unordered_map <std::string, Job> jobs_;
+    //! \brief blocked_ connections with paused reading
+    std::deque <std::uint64_t> blocked_;
+
+    std::mutex completed_mutex_; //!< guards %completed_
+    //! \brief completed_ results given by workers, not delivered yet
+    std::vector <std::pair <std::string, SolveResult> > completed_;
+
+    std::atomic <size_t> requests_; //!< see %Stats
+    std::atomic <size_t> solved_; //!< see %Stats
+    std::atomic <size_t> merged_; //!< see %Stats
+    std::atomic <size_t> cancelled_; //!< see %Stats
+
+    //! \brief pool_ workers. Declared last to be destroyed before everything
+    //! workers use
+    std::unique_ptr <ThreadPool> pool_;
+
+    //!
+    //! \brief Accept Accept all waiting clients
+    //!
+    void Accept ();
+
+    //!
+    //! \brief Read Read all available data of the client and process it
+    //! \param id connection id
+    //!
+    void Read (std::uint64_t id);
+
+    //!
+    //! \brief ProcessInput Handle complete request lines of the client until
+    //! queue is full
+    //! \param id connection id
+    //!
+    void ProcessInput (std::uint64_t id);
+
+    //!
+    //! \brief HandleRequest Answer invalid request or attach it to the job
+    //! \param id connection id
+    //! \param line request line
+    //!
+    void HandleRequest (std::uint64_t id, const std::string & line);
+
+    //!
+    //! \brief StartJob Give puzzle to workers
+    //! \param key puzzle key
+    //! \param job puzzle to be solved
+    //!
+    void StartJob (const std::string & key, Job & job);
+
+    //!
+    //! \brief DeliverCompleted Send results given by workers to all waiters
+    //! and resume paused clients
+    //!
+    void DeliverCompleted ();
+
+    //!
+    //! \brief Send Queue response line to the client and try to send it
+    //! \param id connection id
+    //! \param line response line without line end
+    //!
+    void Send (std::uint64_t id, const std::string & line);
+
+    //!
+    //! \brief Flush Send as much of queued responses as socket accepts
+    //! \param id connection id
+    //!
+    void Flush (std::uint64_t id);
+
+    //!
+    //! \brief UpdateEvents Subscribe to events client is waiting for
+    //! \param id connection id
+    //!
+    void UpdateEvents (std::uint64_t id);
+
+    //!
+    //! \brief CloseIfDone Close client which sent everything and got all the
+    //! answers
+    //! \param id connection id
+    //!
+    void CloseIfDone (std::uint64_t id);
+
+    //!
+    //! \brief Close Close client connection
+    //! \param id connection id
+    //!
+    void Close (std::uint64_t id);
+
+    //!
+    //! \brief Wake Wake event loop up
+    //!
+    void Wake ();
+};
+
+#endif // TG_SOLVE_SERVICE_H
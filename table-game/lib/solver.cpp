@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2017, Ivan
+ * 
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "solver.h"
+
+#include <cctype>
+
+#include "packed_moves.h"
+#include "table.h"
+#include "tg_utils.h"
+
+SolveResult SolvePuzzle(const input_data_t &data, const SolveOptions *options)
+{
+    return SolvePuzzle(InputData(data), options);
+}
+
+SolveResult SolvePuzzle(const InputData &in, const SolveOptions *options)
+{
+    SolveResult result;
+
+    if (InputData::Status::Ok != in.GetDataStatus())
+    {
+        result.status = SolveResult::Status::InvalidInput;
+        result.error = in.GetErrorString();
+        return result;
+    }
+
+    SolveOptions defaults = SolveOptions();
+    const SolveOptions & o = (options != nullptr) ? *options : defaults;
+
+    GameTable t (in, o.cache, o.graph_cache);
+    if ((o.tablebase != nullptr) && o.tablebase->Matches(in))
+    {
+        t.SetTablebase(o.tablebase);
+    }
+    t.SetCancelFlag(o.cancel);
+    t.SetProgressCallback(o.progress, o.progress_interval);
+    t.CalculateMoves();
+
+    if (t.IsCancelled())
+    {
+        result.status = SolveResult::Status::Cancelled;
+        return result;
+    }
+
+    result.moves = t.GetMoves();
+    result.status = result.moves.empty() ? SolveResult::Status::NoSolution
+                                         : SolveResult::Status::Solved;
+    return result;
+}
+
+std::ostream &operator <<(std::ostream &os, const SolveResult &result)
+{
+    if (result.status == SolveResult::Status::InvalidInput)
+    {
+        os << result.error << "\n";
+        return os;
+    }
+    if (result.status == SolveResult::Status::Cancelled)
+    {
+        os << "Solving was cancelled\n";
+        return os;
+    }
+
+    std::string text;
+    FormatMoves(result.moves, text);
+    os.write(text.data(), text.size());
+    return os;
+}
+
+bool ParseMoves(const std::string &text, std::vector<Direction> &moves)
+{
+    for (char c : text)
+    {
+        switch (c)
+        {
+        case 'N':
+            moves.push_back(Direction::North);
+            break;
+        case 'W':
+            moves.push_back(Direction::West);
+            break;
+        case 'S':
+            moves.push_back(Direction::South);
+            break;
+        case 'E':
+            moves.push_back(Direction::East);
+            break;
+        default:
+            if (!std::isspace(static_cast<unsigned char>(c)))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+std::ostream &operator <<(std::ostream &os,
+                          const GameTable::Verification &verification)
+{
+    switch (verification.status)
+    {
+    case GameTable::Verification::Status::Won:
+        os << "WON";
+        break;
+    case GameTable::Verification::Status::Lost:
+        os << "LOST";
+        break;
+    case GameTable::Verification::Status::Incomplete:
+        os << "INCOMPLETE";
+        break;
+    }
+    os << " " << verification.moves << "\n";
+    return os;
+}
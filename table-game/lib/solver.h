@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2017, Ivan
+ * 
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TG_SOLVER_H
+#define TG_SOLVER_H
+
+#include <atomic>
+#include <chrono>
+#include <list>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "input.h"
+#include "solution_cache.h"
+#include "move_graph_cache.h"
+#include "table.h"
+#include "tablebase.h"
+#include "tg_types.h"
+
+//!
+//! \brief The SolveResult struct Outcome of solving one puzzle
+//!
+struct SolveResult
+{
+    //!
+    //! \brief The Status enum Describes how puzzle was solved
+    //!
+    enum class Status
+    {
+        Solved,      //!< at least one moves sequence was found
+        NoSolution,  //!< input is valid, but game can not be won
+        InvalidInput, //!< input data failed validation, see %error
+        Cancelled     //!< solving was cancelled, moves are not known
+    };
+
+    Status status; //!< solving status
+    std::string error; //!< input error description for InvalidInput
+    std::list <std::vector <Direction> > moves; //!< best moves sequences
+};
+
+//!
+//! \brief The SolveOptions struct Options of %SolvePuzzle. Value
+//! initialized options solve without caches, cancellation and progress
+//!
+struct SolveOptions
+{
+    SolutionCache * cache;          //!< solution cache, may be null
+    MoveGraphCache * graph_cache;   //!< move graphs cache, may be null
+    //! \brief tablebase used if puzzle is on its board, may be null
+    const Tablebase * tablebase;
+    //! \brief cancel solving stops when set, may be null
+    const std::atomic <bool> * cancel;
+    //! \brief progress called on solving thread, may be empty
+    GameTable::progress_callback_t progress;
+    //! \brief progress_interval minimal time between progress reports
+    std::chrono::milliseconds progress_interval;
+};
+
+//!
+//! \brief SolvePuzzle Validate input data, build the game table and find
+//! best moves sequences. Safe to be called from several threads at once
+//! \param data puzzle coordinates, same as in input file
+//! \param options caches, tablebase, cancel flag and progress callback,
+//! none by default
+//! \return solving result
+//!
+SolveResult SolvePuzzle (const input_data_t & data,
+                         const SolveOptions * options = nullptr);
+
+//!
+//! \brief SolvePuzzle Same as above for already parsed input data
+//! \param in puzzle input data
+//! \param options caches, tablebase, cancel flag and progress callback,
+//! none by default
+//! \return solving result
+//!
+SolveResult SolvePuzzle (const InputData & in,
+                         const SolveOptions * options = nullptr);
+
+//!
+//! \brief operator << Print result the same way single puzzle is printed:
+//! moves sequences one per line, or error description
+//! \param os output stream
+//! \param result result to be printed
+//! \return output stream
+//!
+std::ostream & operator << (std::ostream & os, const SolveResult & result);
+
+//!
+//! \brief ParseMoves Parse moves sequence written by direction letters N, W,
+//! S and E, as solutions are printed. Letters may be separated by whitespaces
+//! \param text moves sequence
+//! \param moves parsed moves are appended here
+//! \return false if text has other characters
+//!
+bool ParseMoves (const std::string & text, std::vector <Direction> & moves);
+
+//!
+//! \brief operator << Print verification as one "WON|LOST|INCOMPLETE <moves>"
+//! line, see %GameTable::Verification for moves meaning
+//! \param os output stream
+//! \param verification verification to be printed
+//! \return output stream
+//!
+std::ostream & operator << (std::ostream & os,
+                            const GameTable::Verification & verification);
+
+#endif // TG_SOLVER_H
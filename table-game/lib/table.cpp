@@ -31,14 +31,41 @@
 
 #include "table.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <cassert>
+#include <limits>
+#include <random>
 
 #include "tg_utils.h"
 
 
-GameTable::GameTable(const InputData &in)
+GameTable::GameTable(const InputData &in, SolutionCache *cache,
+                     MoveGraphCache *graph_cache)
+    : zobrist_(in.GetTableSize(), in.GetBallCount())
+    , cache_(cache)
+    , graph_cache_(graph_cache)
+    , transpositions_(nullptr)
+    , limits_({0, 0})
+    , limit_reached_(false)
+    , cancel_(nullptr)
+    , cancelled_(false)
+    , pruning_({0, 0, 0, 0, 0, 0})
+    , unsolvable_({SolvabilityCheck::Reason::None, 0})
+    , upper_bound_(std::numeric_limits <size_t>::max())
+    , progress_interval_(0)
+    , tablebase_(nullptr)
+    , search_edges_(nullptr)
 {
+    if (cache_ != nullptr)
+    {
+        cache_key_ = cache_->MakeKey(in);
+    }
+    if (graph_cache_ != nullptr)
+    {
+        graph_key_ = MoveGraphCache::MakeKey(in);
+    }
+
     table_size_ = in.GetTableSize();
 
     for (coordinate_t i=1; i<=table_size_; ++i)
@@ -63,8 +90,8 @@ GameTable::GameTable(const InputData &in)
         board_[c_right].AddWall(Direction::East);
     }
 
-    auto walls = in.GetWalls();
-    for (auto i : walls)
+    const auto & walls = in.GetWalls();
+    for (const auto & i : walls)
     {
         if (i.first.x == i.second.x)
         {
@@ -98,18 +125,18 @@ GameTable::GameTable(const InputData &in)
         }
     }
 
-    auto holes = in.GetHoles();
+    const auto & holes = in.GetHoles();
     ball_id_t hole_id = 1;
-    for (auto i : holes)
+    for (const auto & i : holes)
     {
         board_[i].AddHole(hole_id);
         holes_[hole_id] = i;
         ++hole_id;
     }
 
-    auto balls = in.GetBalls();
+    const auto & balls = in.GetBalls();
     ball_id_t ball_id = 1;
-    for (auto i : balls)
+    for (const auto & i : balls)
     {
         balls_.insert(std::make_pair(i, Ball(ball_id)));
         ++ball_id;
@@ -117,7 +144,7 @@ GameTable::GameTable(const InputData &in)
 
 }
 
-std::map<const coordinates_t, BoardCell> GameTable::GetBoard() const
+const std::map<const coordinates_t, BoardCell> &GameTable::GetBoard() const
 {
     return board_;
 }
@@ -132,30 +159,357 @@ const std::map<coordinates_t, Ball> &GameTable::GetBalls() const
     return balls_;
 }
 
+GameTable::~GameTable()
+{
+}
+
 void GameTable::CalculateMoves()
 {
-    BuildMoveGraph();
-    FindAllMoves();
+    if (!StartCalculation())
+    {
+        while (!ContinueCalculation(std::numeric_limits <size_t>::max()))
+        {
+        }
+    }
 }
 
-std::map<const coordinates_t, GraphItem> GameTable::GetMoveGraph() const
+bool GameTable::StartCalculation()
 {
-    return move_graph_;
+    search_.reset();
+    // moves of the previous calculation would bound the search
+    moves_.clear();
+    limit_reached_ = false;
+    cancelled_ = false;
+    unsolvable_ = SolvabilityCheck::Result{SolvabilityCheck::Reason::None, 0};
+    upper_bound_ = std::numeric_limits <size_t>::max();
+    if ((cache_ != nullptr) && cache_->Lookup(cache_key_, moves_))
+    {
+        CheckMovesLimit();
+        return true;
+    }
+
+    PrepareMoveGraph();
+    if (((tablebase_ == nullptr) || !FindTablebaseMoves(GetStartPoint())) &&
+        BeginSimulation(GetStartPoint()))
+    {
+        return false;
+    }
+
+    FinishCalculation();
+    return true;
 }
 
-void GameTable::PrintMoves(std::ostream &os)
+bool GameTable::ContinueCalculation(size_t budget)
+{
+    if (search_ == nullptr)
+    {
+        return true;
+    }
+    if (!StepSimulation(budget))
+    {
+        return false;
+    }
+
+    FinishCalculation();
+    return true;
+}
+
+void GameTable::FinishCalculation()
 {
-    for (auto move_list : moves_)
+    // moves found within limits are the same as without them
+    if ((cache_ != nullptr) && !limit_reached_ && !cancelled_)
     {
-        for (auto move : move_list)
+        cache_->Store(cache_key_, moves_);
+    }
+    CheckMovesLimit();
+}
+
+void GameTable::SetSearchLimits(const SearchLimits &limits)
+{
+    limits_ = limits;
+}
+
+bool GameTable::IsLimitReached() const
+{
+    return limit_reached_;
+}
+
+void GameTable::SetCancelFlag(const std::atomic<bool> *cancel)
+{
+    cancel_ = cancel;
+}
+
+void GameTable::SetSearchEdges(std::vector<SearchEdge> *edges)
+{
+    search_edges_ = edges;
+}
+
+const GameTable::PruningStats &GameTable::GetPruningStats() const
+{
+    return pruning_;
+}
+
+SolvabilityCheck::Result GameTable::CheckSolvability()
+{
+    PrepareMoveGraph();
+    return CheckSolvability(GetStartPoint());
+}
+
+std::vector<std::pair<ball_id_t, ball_id_t> > GameTable::GetForcedOrder()
+{
+    PrepareMoveGraph();
+    PrepareSolvabilityCheck();
+    Movement start_point = GetStartPoint();
+    return solvability_->GetForcedOrder(solvability_->MakeHoleOrder(start_point),
+                                        start_point);
+}
+
+const SolvabilityCheck::Result &GameTable::GetUnsolvability() const
+{
+    return unsolvable_;
+}
+
+size_t GameTable::GetUpperBound() const
+{
+    return upper_bound_;
+}
+
+bool GameTable::IsCancelled() const
+{
+    return cancelled_;
+}
+
+void GameTable::SetProgressCallback(progress_callback_t callback,
+                                    std::chrono::milliseconds interval)
+{
+    progress_ = std::move(callback);
+    progress_interval_ = interval;
+}
+
+void GameTable::CheckMovesLimit()
+{
+    if ((limits_.max_moves != 0) && !moves_.empty() &&
+        (moves_.front().size() > limits_.max_moves))
+    {
+        moves_.clear();
+        limit_reached_ = true;
+    }
+}
+
+void GameTable::SetTranspositionCache(TranspositionCache *transpositions)
+{
+    transpositions_ = transpositions;
+}
+
+void GameTable::SetTablebase(const Tablebase *tablebase)
+{
+    tablebase_ = tablebase;
+}
+
+GameTable::TreeEstimate GameTable::EstimateSearchTree(size_t probes,
+                                                      std::uint64_t seed)
+{
+    // walks longer than that are too rare to change the estimate
+    const size_t max_depth = 24;
+
+    PrepareMoveGraph();
+    std::mt19937_64 random (seed);
+    const Movement start_point = GetStartPoint();
+
+    std::vector <std::vector <double> > widths (probes);
+    size_t won_depth = std::numeric_limits <size_t>::max();
+    double branching = 0;
+    size_t branching_count = 0;
+    double depth_sum = 0;
+
+    for (auto & probe : widths)
+    {
+        std::unordered_set <zobrist_key_t> path;
+        path.insert(start_point.GetKey());
+        Movement state = start_point;
+        double width = 1;
+        probe.push_back(width);
+
+        std::vector <Movement> children;
+        ball_order_t vertical;
+        ball_order_t horizontal;
+        std::vector <bool> open_holes;
+        std::vector <BallRoll> rolls;
+        while (probe.size() <= max_depth)
         {
-            if (!move.IsStartMove())
+            if (state.GetBallsPositions().empty())
             {
-                os << move.GetMove() << " ";
+                won_depth = std::min(won_depth, probe.size() - 1);
+                break;
             }
+
+            // state is decoded once, all four rolls share it
+            DecodeState(state, vertical, horizontal, open_holes);
+            children.clear();
+            for (Direction to : {Direction::North, Direction::West,
+                                 Direction::South, Direction::East})
+            {
+                bool vertical_move = (to == Direction::North) ||
+                                     (to == Direction::South);
+                rolls.clear();
+                if (!RollAllBalls(to, vertical_move ? vertical : horizontal,
+                                  open_holes, rolls))
+                {
+                    continue;
+                }
+                children.emplace_back(to, state);
+                if (!ApplyRolls(rolls, children.back()) ||
+                    (path.count(children.back().GetKey()) != 0))
+                {
+                    children.pop_back();
+                }
+            }
+            branching += children.size();
+            ++branching_count;
+            if (children.empty())
+            {
+                break;
+            }
+
+            width *= children.size();
+            probe.push_back(width);
+            std::uniform_int_distribution <size_t> pick (0, children.size() - 1);
+            state = children[pick(random)];
+            path.insert(state.GetKey());
+        }
+        depth_sum += probe.size() - 1;
+    }
+
+    TreeEstimate estimate = {0, 0, 0};
+    if (probes == 0)
+    {
+        return estimate;
+    }
+    for (const auto & probe : widths)
+    {
+        // search takes nothing from layers after the first win
+        size_t layers = probe.size();
+        if (won_depth < layers)
+        {
+            layers = won_depth + 1;
+        }
+        for (size_t i=0; i<layers; ++i)
+        {
+            estimate.states += probe[i];
+        }
+    }
+    estimate.states /= probes;
+    estimate.branching = (branching_count == 0) ? 0 : branching / branching_count;
+    estimate.depth = depth_sum / probes;
+    return estimate;
+}
+
+GameTable::Verification GameTable::VerifyMoves(const std::vector<Direction> &moves)
+{
+    PrepareMoveGraph();
+
+    // one state is changed in place by the same rolls and placing rules
+    // the search uses, so replaying does not copy it for every move. Its
+    // cells are taken from local arena, not from the heap one by one
+    Arena arena (4096);
+    Arena::Scope scope (&arena);
+    Movement state = GetStartPoint();
+    ball_order_t order;
+    std::vector <bool> open_holes;
+
+    Verification verification = {Verification::Status::Incomplete, 0};
+    std::vector <BallRoll> rolls;
+    for (Direction to : moves)
+    {
+        if (state.GetBallsPositions().empty())
+        {
+            break;
+        }
+
+        DecodeState(state, to, order, open_holes);
+
+        ++verification.moves;
+        rolls.clear();
+        if (!RollAllBalls(to, order, open_holes, rolls) ||
+            !ApplyRolls(rolls, state))
+        {
+            verification.status = Verification::Status::Lost;
+            return verification;
         }
-        os << "\n";
     }
+
+    if (state.GetBallsPositions().empty())
+    {
+        verification.status = Verification::Status::Won;
+    }
+    return verification;
+}
+
+Movement GameTable::MakeState(const std::map<coordinates_t, ball_id_t> &balls) const
+{
+    // hole is open while its ball is on the board
+    std::vector <bool> on_board (holes_.size() + 1, false);
+    for (const auto & ball : balls)
+    {
+        on_board[ball.second] = true;
+    }
+    std::map <coordinates_t, ball_id_t> holes;
+    for (const auto & hole : holes_)
+    {
+        if (on_board[hole.first])
+        {
+            holes.insert(std::make_pair(hole.second, hole.first));
+        }
+    }
+    return Movement(balls, holes, zobrist_);
+}
+
+void GameTable::CalculateMovesFrom(const std::map<coordinates_t, ball_id_t> &balls)
+{
+    PrepareMoveGraph();
+    moves_.clear();
+    limit_reached_ = false;
+    cancelled_ = false;
+    unsolvable_ = SolvabilityCheck::Result{SolvabilityCheck::Reason::None, 0};
+    upper_bound_ = std::numeric_limits <size_t>::max();
+
+    Movement start_point = MakeState(balls);
+    if ((tablebase_ == nullptr) || !FindTablebaseMoves(start_point))
+    {
+        SimulateGame(start_point);
+    }
+    CheckMovesLimit();
+}
+
+bool GameTable::MakeMove(const std::map<coordinates_t, ball_id_t> &balls,
+                         Direction to,
+                         std::map<coordinates_t, ball_id_t> &result) const
+{
+    Movement next (to, MakeState(balls));
+    if (!ApplyMove(next))
+    {
+        return false;
+    }
+    result.clear();
+    result.insert(next.GetBallsPositions().begin(), next.GetBallsPositions().end());
+    return true;
+}
+
+const std::map<const coordinates_t, GraphItem> &GameTable::GetMoveGraph() const
+{
+    return move_graph_;
+}
+
+const std::list<std::vector<Direction> > &GameTable::GetMoves() const
+{
+    return moves_;
+}
+
+void GameTable::PrintMoves(std::ostream &os)
+{
+    std::string text;
+    FormatMoves(moves_, text);
+    os.write(text.data(), text.size());
 }
 
 void GameTable::BuildMoveGraph()
@@ -175,6 +529,42 @@ void GameTable::BuildMoveGraph()
     }
 }
 
+void GameTable::PrepareMoveGraph()
+{
+    if (!move_graph_.empty())
+    {
+        return;
+    }
+
+    if (graph_cache_ == nullptr)
+    {
+        BuildMoveGraph();
+        return;
+    }
+
+    if (graph_cache_->Load(graph_key_, move_graph_))
+    {
+        if (!graph_cache_->IsValidating())
+        {
+            return;
+        }
+
+        std::map <const coordinates_t, GraphItem> loaded;
+        loaded.swap(move_graph_);
+        BuildMoveGraph();
+        if (loaded == move_graph_)
+        {
+            return;
+        }
+        graph_cache_->ReportMismatch();
+    }
+    else
+    {
+        BuildMoveGraph();
+    }
+    graph_cache_->Store(graph_key_, move_graph_);
+}
+
 std::pair<Ball::CollisionResult, coordinates_t>
 GameTable::RollBall(const coordinates_t &start_from,
                     const Direction to) const
@@ -255,9 +645,9 @@ void GameTable::FillGraphItemInDirection(GraphItem &gi,
 std::ostream &
 operator << (std::ostream & os, const GameTable & gt)
 {
-    auto board = gt.GetBoard();
+    const auto & board = gt.GetBoard();
     auto table_size = gt.GetTableSize();
-    auto balls = gt.GetBalls();
+    const auto & balls = gt.GetBalls();
 
     for (coordinate_t j=1; j<=table_size; ++j)
     {
@@ -356,8 +746,8 @@ operator << (std::ostream & os, const GameTable & gt)
 
     os << "\nMove garph status:\n";
 
-    auto graph = gt.GetMoveGraph();
-    for (auto i : graph)
+    const auto & graph = gt.GetMoveGraph();
+    for (const auto & i : graph)
     {
         os << i.first << ": " << i.second << "\n";
         if (!i.second.GetHolesOnWayTo(Direction::North).empty())
@@ -390,271 +780,889 @@ operator << (std::ostream & os, const GameTable & gt)
 void GameTable::FindAllMoves()
 {
     //create a start item and start playing around
-    std::map <coordinates_t, ball_id_t> balls;
-    std::map <coordinates_t, ball_id_t> holes;
+    SimulateGame(GetStartPoint());
+}
 
-    for (auto ball : balls_)
+Movement GameTable::GetStartPoint() const
+{
+    std::map <coordinates_t, ball_id_t> balls;
+    for (const auto & ball : balls_)
     {
         balls.insert(std::make_pair(ball.first, ball.second.GetId()));
     }
-    for (auto hole : holes_)
+
+    // all the holes are open at start
+    return MakeState(balls);
+}
+
+SolvabilityCheck::Result GameTable::CheckSolvability(const Movement &state)
+{
+    PrepareSolvabilityCheck();
+    return solvability_->Check(state);
+}
+
+void GameTable::PrepareSolvabilityCheck()
+{
+    if (solvability_ == nullptr)
+    {
+        solvability_.reset(new SolvabilityCheck(board_, move_graph_, table_size_));
+    }
+}
+
+bool GameTable::FindTablebaseMoves(const Movement & start_point)
+{
+    TranspositionCache::Entry known;
+    if (!tablebase_->Find(start_point.GetBallsPositions(), known))
+    {
+        return false;
+    }
+    if (known.distance == Tablebase::UNSOLVABLE)
     {
-        holes.insert(std::make_pair(hole.second, hole.first));
+        return true;
     }
 
-    Movement start_point (balls, holes);
-    std::list <Movement> moves = {start_point};
-    std::list <std::list <Movement> >all_moves  = {moves};
+    const Tablebase * tablebase = tablebase_;
+    lookup_t lookup = [tablebase] (const Movement & state,
+                                   TranspositionCache::Entry & entry)
+    {
+        return tablebase->Find(state.GetBallsPositions(), entry);
+    };
 
-    SimulateGame(all_moves);
+    std::vector <Direction> prefix;
+    if (FollowKnownMoves(start_point, known, lookup, prefix, moves_))
+    {
+        return true;
+    }
+    moves_.clear();
+    return false;
 }
 
 
-void GameTable::SimulateGame (std::list <std::list <Movement> > & moves)
+namespace
+{
+
+//! \brief SEARCH_ARENA_CHUNK first chunk of search arenas: small, so that
+//! many suspended searches fit in memory, chunks grow with the search
+const size_t SEARCH_ARENA_CHUNK = 4 * 1024;
+
+//! \brief CHECK_PERIOD cancel flag and clock are not checked for every
+//! state, it costs more than expanding it
+const size_t CHECK_PERIOD = 256;
+
+//! \brief HOLE_ORDER_STATES hole order costs about as much as expanding a
+//! few hundreds of states, searches smaller than that are done without it
+const size_t HOLE_ORDER_STATES = 4096;
+
+//! \brief UPPER_BOUND_WIDTH states kept by %GameTable::FindUpperBound on
+//! every layer: wider search finds more bounds, but it costs more than they
+//! save
+const size_t UPPER_BOUND_WIDTH = 32;
+
+//! \brief UPPER_BOUND_MOVES longer greedy searches are given up, they hardly
+//! give a bound worth pruning by
+const size_t UPPER_BOUND_MOVES = 64;
+
+}
+
+//!
+//! \brief The Search struct State of the search kept between its steps
+//!
+struct GameTable::Search
 {
-    while (!moves.empty())
+    Search (const Movement & start, std::chrono::milliseconds interval)
+        : start_point(start)
+        , first_arena(SEARCH_ARENA_CHUNK)
+        , second_arena(SEARCH_ARENA_CHUNK)
+        , current(0)
+        , layer(ArenaAllocator <move_path_t> (&first_arena))
+        , next_layer(ArenaAllocator <move_path_t> (&second_arena))
+        , layer_started(false)
+        , bound(std::numeric_limits <size_t>::max())
+        , depth(0)
+        , depth_limited(false)
+        , stopped(false)
+        , expanded(0)
+        , hole_order({0, {}, {}})
+        , hole_order_made(false)
+        , started(std::chrono::steady_clock::now())
+        , next_report(started + interval)
+    {}
+
+    //! \brief GetArena Gives one of two arenas layers are built in by turn
+    Arena & GetArena (size_t index)
     {
-        std::list <Movement> & current_moves = moves.front();
+        return (index == 0) ? first_arena : second_arena;
+    }
+
+    Movement start_point; //!< initial game state
+    Arena first_arena;    //!< see %GetArena
+    Arena second_arena;   //!< see %GetArena
+    size_t current;       //!< arena of %layer
+    move_layer_t layer;   //!< layer being searched
+    move_layer_t next_layer; //!< layer being built from %layer
+    move_layer_t::const_iterator position; //!< next sequence of %layer
+    bool layer_started;   //!< %position is set
+    std::unordered_set <zobrist_key_t> visited; //!< keys of reached states
+    //! \brief known_moves best sequences going through the states known by
+    //! transposition cache, all of them have %bound moves
+    std::list <std::vector <Direction> > known_moves;
+    size_t bound;         //!< moves of %known_moves
+    size_t depth;         //!< moves of %layer sequences
+    bool depth_limited;   //!< sequences were dropped by moves limit
+    bool stopped;         //!< search was stopped by states limit
+    size_t expanded;      //!< sequences taken from layers
+    //! \brief hole_order hole order of states reached from %start_point,
+    //! empty until %hole_order_made
+    SolvabilityCheck::HoleOrder hole_order;
+    bool hole_order_made; //!< %hole_order is made
+    //! \brief recorded states of %layer whose moves are recorded, the
+    //! same state may be there many times
+    std::unordered_set <zobrist_key_t> recorded;
+    std::chrono::steady_clock::time_point started; //!< search start time
+    std::chrono::steady_clock::time_point next_report; //!< progress time
+};
+
+void GameTable::SimulateGame (const Movement & start_point)
+{
+    if (BeginSimulation(start_point))
+    {
+        while (!StepSimulation(std::numeric_limits <size_t>::max()))
+        {
+        }
+    }
+}
 
-        if (!IsTooLotMoves(current_moves))
+bool GameTable::BeginSimulation (const Movement & start_point)
+{
+    search_.reset();
+    if (search_edges_ != nullptr)
+    {
+        search_edges_->clear();
+    }
+
+    TranspositionCache::Entry known;
+    if ((transpositions_ != nullptr) &&
+        transpositions_->Find(start_point.GetKey(), known))
+    {
+        std::vector <Direction> prefix;
+        if (known.distance == TranspositionCache::UNSOLVABLE)
+        {
+            return false;
+        }
+        if (FollowKnownMoves(start_point, known, GetTranspositionLookup(),
+                             prefix, moves_))
         {
-            auto current_position = current_moves.back().GetBallsPositions();
-            if (current_position.size() == 0)
+            return false;
+        }
+        // cache does not agree with the board, search from scratch
+        moves_.clear();
+    }
+
+    pruning_ = PruningStats{0, 0, 0, 0, 0, 0};
+    unsolvable_ = CheckSolvability(start_point);
+    if (unsolvable_.reason != SolvabilityCheck::Reason::None)
+    {
+        // whole reachable space would be searched for nothing
+        return false;
+    }
+
+    search_.reset(new Search(start_point, progress_interval_));
+    {
+        Arena::Scope scope (&search_->GetArena(0));
+        search_->layer.emplace_back(start_point);
+    }
+    search_->visited.insert(start_point.GetKey());
+    return true;
+}
+
+bool GameTable::StepSimulation (size_t budget)
+{
+    // layers are built in two arenas by turn: while next layer is built
+    // current one is still needed, the one before is already released
+    Search & search = *search_;
+    lookup_t lookup = GetTranspositionLookup();
+    size_t steps = 0;
+
+    while (true)
+    {
+        if (!search.layer_started)
+        {
+            if (search.layer.empty() || (search.depth > search.bound) ||
+                !CheckSearch(search.layer.size()))
             {
-                //all balls are in the holes!
-                SaveMoves(current_moves);
+                FinishSimulation();
+                return true;
             }
-            else
+            if (!search.hole_order_made && (search.expanded >= HOLE_ORDER_STATES))
             {
-                std::list <Movement> to_north = MakeMove(current_moves, Direction::North);
-                std::list <Movement> to_west  = MakeMove(current_moves, Direction::West);
-                std::list <Movement> to_south = MakeMove(current_moves, Direction::South);
-                std::list <Movement> to_east  = MakeMove(current_moves, Direction::East);
+                search.hole_order = solvability_->MakeHoleOrder(search.start_point);
+                search.hole_order_made = true;
+                // rest of the search is pruned by the bound
+                upper_bound_ = FindUpperBound(search.start_point, search.hole_order,
+                                              UPPER_BOUND_WIDTH);
+            }
+            search.position = search.layer.begin();
+            search.layer_started = true;
+        }
 
-                if (!to_north.empty())
-                {
-                    moves.push_back(to_north);
-                }
-                if (!to_west.empty())
-                {
-                    moves.push_back(to_west);
-                }
-                if (!to_south.empty())
-                {
-                    moves.push_back(to_south);
-                }
-                if (!to_east.empty())
+        {
+            Arena::Scope scope (&search.GetArena(1 - search.current));
+            while ((search.position != search.layer.end()) && (steps < budget))
+            {
+                ++steps;
+                if (((++search.expanded % CHECK_PERIOD) == 0) &&
+                    !CheckSearch(search.layer.size()))
                 {
-                    moves.push_back(to_east);
+                    FinishSimulation();
+                    return true;
                 }
+                SearchSequence(*search.position, lookup);
+                ++search.position;
             }
         }
-        moves.pop_front();
+
+        if (search.position != search.layer.end())
+        {
+            // budget is spent
+            return false;
+        }
+
+        for (const auto & new_moves : search.next_layer)
+        {
+            search.visited.insert(new_moves.state.GetKey());
+        }
+
+        if ((limits_.max_states != 0) &&
+            (search.visited.size() > limits_.max_states) &&
+            moves_.empty() && !search.next_layer.empty())
+        {
+            search.stopped = true;
+            FinishSimulation();
+            return true;
+        }
+
+        // current layer is not needed any more
+        search.layer.clear();
+        search.GetArena(search.current).Release();
+
+        search.layer = std::move(search.next_layer);
+        search.current = 1 - search.current;
+        search.next_layer = move_layer_t(ArenaAllocator <move_path_t> (
+                                             &search.GetArena(1 - search.current)));
+        search.layer_started = false;
+        search.recorded.clear();
+        ++search.depth;
     }
 }
 
-bool GameTable::SaveMoves (const std::list <Movement> & moves)
+void GameTable::SearchSequence (const move_path_t & current_moves,
+                                const lookup_t & lookup)
 {
-    if ((moves_.size() == 0) ||
-        (moves_.back().size() == moves.size() ))
+    Search & search = *search_;
+
+    if (IsTooLotMoves(current_moves))
     {
-        moves_.push_back(moves);
-        return true;
+        return;
+    }
+
+    if (current_moves.state.GetBallsPositions().empty())
+    {
+        //all balls are in the holes!
+        SaveMoves(current_moves);
+        return;
     }
-    else if (moves_.back().size() > moves.size())
+
+    TranspositionCache::Entry known;
+    if ((transpositions_ != nullptr) &&
+        transpositions_->Find(current_moves.state.GetKey(), known))
+    {
+        if ((known.distance == TranspositionCache::UNSOLVABLE) ||
+            (search.depth + known.distance > search.bound))
+        {
+            return;
+        }
+
+        std::list <std::vector <Direction> > found;
+        std::vector <Direction> prefix = GetDirections(current_moves);
+        if (FollowKnownMoves(current_moves.state, known, lookup,
+                             prefix, found))
+        {
+            if (search.depth + known.distance < search.bound)
+            {
+                search.bound = search.depth + known.distance;
+                search.known_moves.clear();
+            }
+            search.known_moves.splice(search.known_moves.end(), found);
+            return;
+        }
+    }
+
+    if (search.depth < search.bound)
+    {
+        if ((limits_.max_moves != 0) && (search.depth >= limits_.max_moves))
+        {
+            // longer sequences are not wanted
+            search.depth_limited = true;
+            return;
+        }
+        // wins saved on this layer bound the rest of it as well
+        size_t upper_bound = upper_bound_;
+        if (!moves_.empty())
+        {
+            upper_bound = std::min(upper_bound, moves_.front().size());
+        }
+        if ((upper_bound != std::numeric_limits <size_t>::max()) &&
+            (search.depth + std::max <size_t> (1, solvability_->GetLowerBound(
+                 search.hole_order, current_moves.state)) > upper_bound))
+        {
+            ++pruning_.bounded;
+            return;
+        }
+        ExpandMoves(current_moves, search.visited, search.hole_order,
+                    upper_bound, search.next_layer);
+    }
+}
+
+void GameTable::FinishSimulation ()
+{
+    Search & search = *search_;
+
+    if (!search.known_moves.empty())
+    {
+        if (moves_.empty() || (search.bound < moves_.front().size()))
+        {
+            moves_.swap(search.known_moves);
+        }
+        else if (search.bound == moves_.front().size())
+        {
+            moves_.splice(moves_.end(), search.known_moves);
+        }
+        // keep the order of search without cache
+        moves_.sort();
+    }
+
+    // sequences found within depth limit are the best ones, while stopped
+    // search might miss some of them
+    limit_reached_ = search.stopped || (search.depth_limited && moves_.empty());
+    if (limit_reached_ || cancelled_)
     {
         moves_.clear();
-        moves_.push_back(moves);
-        return true;
     }
-    //cannot add: better moves are saved
-    return false;
+    else if (transpositions_ != nullptr)
+    {
+        LearnTranspositions(search.start_point, search.visited);
+    }
+
+    search_.reset();
 }
 
-bool GameTable::IsTooLotMoves (const std::list <Movement> & moves)
+bool GameTable::CheckSearch (size_t frontier)
 {
-    if ((moves_.size() == 0) ||
-        (moves_.back().size() >= moves.size() ))
+    if ((cancel_ != nullptr) && cancel_->load(std::memory_order_relaxed))
     {
+        cancelled_ = true;
         return false;
     }
+    if (!progress_)
+    {
+        return true;
+    }
 
+    Search & search = *search_;
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (now < search.next_report)
+    {
+        return true;
+    }
+    search.next_report = now + progress_interval_;
+
+    double seconds = std::chrono::duration <double> (now - search.started).count();
+    progress_({search.depth, frontier, search.visited.size(),
+               (seconds > 0) ? search.expanded / seconds : 0.0});
     return true;
 }
 
-std::list <Movement>
-GameTable::MakeMove (std::list <Movement> & moves, Direction to)
+GameTable::lookup_t GameTable::GetTranspositionLookup () const
+{
+    TranspositionCache * transpositions = transpositions_;
+    return [transpositions] (const Movement & state,
+                             TranspositionCache::Entry & entry)
+    {
+        return transpositions->Find(state.GetKey(), entry);
+    };
+}
+
+bool GameTable::FollowKnownMoves (const Movement & state,
+                                  const TranspositionCache::Entry & known,
+                                  const lookup_t & lookup,
+                                  std::vector <Direction> & prefix,
+                                  std::list <std::vector <Direction> > & found) const
 {
-    auto current_position = moves.back().GetBallsPositions();
-    if (current_position.size() == 0)
+    if ((known.moves == 0) || (known.distance == 0) ||
+        (known.distance == TranspositionCache::UNSOLVABLE))
     {
-        //all balls are in the holes! no need to proceed making moves
-        SaveMoves(moves);
-        return std::list <Movement> ();
+        return false;
     }
 
-    std::map <coordinates_t, ball_id_t> new_position;
-    std::map <coordinates_t, ball_id_t> new_position_removed_balls;
-    bool game_ok = RollAllBalls (to,
-                                 current_position,
-                                 moves.back().GetHoles(),
-                                 new_position,
-                                 new_position_removed_balls);
-    if (!game_ok)
+    for (Direction to : {Direction::North, Direction::West,
+                         Direction::South, Direction::East})
     {
-        return std::list <Movement> ();
+        if ((known.moves & (1 << static_cast <unsigned> (to))) == 0)
+        {
+            continue;
+        }
+
+        Movement next (to, state);
+        if (!ApplyMove(next))
+        {
+            return false;
+        }
+
+        prefix.push_back(to);
+        if (next.GetBallsPositions().empty())
+        {
+            if (known.distance != 1)
+            {
+                return false;
+            }
+            found.push_back(prefix);
+        }
+        else
+        {
+            TranspositionCache::Entry next_known;
+            if (!lookup(next, next_known) ||
+                (next_known.distance + 1 != known.distance) ||
+                !FollowKnownMoves(next, next_known, lookup, prefix, found))
+            {
+                return false;
+            }
+        }
+        prefix.pop_back();
     }
+    return true;
+}
 
-    moves.back().InitLoopGuard();
+void GameTable::LearnTranspositions (const Movement & start_point,
+                                     const std::unordered_set <zobrist_key_t> & visited)
+{
+    if (moves_.empty())
+    {
+        // whole reachable space is searched, win is nowhere
+        for (auto key : visited)
+        {
+            transpositions_->AddUnsolvable(key);
+        }
+        return;
+    }
 
-    Movement new_move (to, moves.back());
-    for (auto ball : new_position_removed_balls)
+    size_t length = moves_.front().size();
+    if (length >= TranspositionCache::UNSOLVABLE)
     {
-        for (auto previous : current_position )
+        return;
+    }
+
+    // every state of the best sequence is as far from the win as the rest
+    // of the sequence
+    for (const auto & directions : moves_)
+    {
+        Movement state (start_point);
+        for (size_t i=0; i<length; ++i)
         {
-            if (ball.second == previous.second)
+            transpositions_->Add(state.GetKey(),
+                                 static_cast <std::uint16_t> (length - i),
+                                 directions[i]);
+            Movement next (directions[i], state);
+            if (!ApplyMove(next))
             {
-                if (!new_move.SetBallPosition(ball.second, ball.first, previous.first))
-                {
-                    return std::list <Movement> ();
-                }
                 break;
             }
+            state = next;
         }
     }
-    for (auto ball : new_position)
+}
+
+std::vector <Direction> GameTable::GetDirections (const move_path_t & moves)
+{
+    return moves.moves.Unpack();
+}
+
+bool GameTable::SaveMoves (const move_path_t & moves)
+{
+    std::vector <Direction> directions = GetDirections(moves);
+
+    if ((moves_.size() == 0) ||
+        (moves_.back().size() == directions.size() ))
+    {
+        moves_.push_back(std::move(directions));
+        return true;
+    }
+    else if (moves_.back().size() > directions.size())
     {
-        for (auto previous : current_position )
+        moves_.clear();
+        moves_.push_back(std::move(directions));
+        return true;
+    }
+    //cannot add: better moves are saved
+    return false;
+}
+
+bool GameTable::IsTooLotMoves (const move_path_t & moves)
+{
+    if ((moves_.size() == 0) ||
+        (moves_.back().size() >= moves.moves.GetSize()))
+    {
+        return false;
+    }
+
+    return true;
+}
+
+void GameTable::ExpandMoves (const move_path_t & moves,
+                             const std::unordered_set <zobrist_key_t> & visited,
+                             const SolvabilityCheck::HoleOrder & hole_order,
+                             size_t upper_bound,
+                             move_layer_t & next_layer)
+{
+    const Movement & parent = moves.state;
+
+    // decode parent state once, all four rolls share it
+    ball_order_t vertical;
+    ball_order_t horizontal;
+    std::vector <bool> open_holes;
+    DecodeState(parent, vertical, horizontal, open_holes);
+
+    std::vector <BallRoll> rolls;
+    rolls.reserve(vertical.size());
+
+    // copies of the state on the layer keep the same moves: the ones kept
+    // for one path only are null or revisited moves
+    bool record = (search_edges_ != nullptr) &&
+                  search_->recorded.insert(parent.GetKey()).second;
+
+    size_t made = moves.moves.GetSize();
+    for (Direction to : {Direction::North, Direction::West,
+                         Direction::South, Direction::East})
+    {
+        // balls stopped by the previous move can not roll further
+        if ((made != 0) && moves.settled && (moves.moves.Get(made - 1) == to))
+        {
+            ++pruning_.repeated;
+            continue;
+        }
+
+        bool vertical_move = (to == Direction::North) ||
+                             (to == Direction::South);
+
+        rolls.clear();
+        if (!RollAllBalls(to, vertical_move ? vertical : horizontal,
+                          open_holes, rolls))
+        {
+            continue;
+        }
+
+        // key of the new state is known before the state is built
+        zobrist_key_t key = parent.GetKey();
+        for (auto roll : rolls)
+        {
+            // ball stopped on its open hole falls there, as %ApplyRolls
+            // places it
+            bool in_hole = roll.in_hole ||
+                           (open_holes[roll.ball] && (holes_.at(roll.ball) == roll.to));
+            key ^= zobrist_.BallKey(roll.ball, roll.from);
+            key ^= in_hole ? zobrist_.HoleKey(roll.ball)
+                           : zobrist_.BallKey(roll.ball, roll.to);
+        }
+
+        // cheap checks first, all of them are special cases of the last one
+        if (key == parent.GetKey())
         {
-            if (ball.second == previous.second)
+            ++pruning_.null_moves;
+            continue;
+        }
+        if ((made != 0) && (key == moves.previous_key))
+        {
+            ++pruning_.reversed;
+            continue;
+        }
+        if (visited.count(key) != 0)
+        {
+            // same state is already reached with less moves
+            ++pruning_.revisited;
+            continue;
+        }
+
+        // new state is built directly in the next layer
+        next_layer.emplace_back(moves, to);
+        move_path_t & new_moves = next_layer.back();
+        if (!ApplyRolls(rolls, new_moves.state))
+        {
+            next_layer.pop_back();
+            continue;
+        }
+        if (solvability_->IsHopeless(hole_order, new_moves.state))
+        {
+            next_layer.pop_back();
+            ++pruning_.hopeless;
+            continue;
+        }
+        if ((upper_bound != std::numeric_limits <size_t>::max()) &&
+            (made + 1 + solvability_->GetLowerBound(hole_order, new_moves.state) >
+             upper_bound))
+        {
+            // best sequences are not longer than the bound
+            next_layer.pop_back();
+            ++pruning_.bounded;
+            continue;
+        }
+        new_moves.settled = (new_moves.state.GetBallsPositions().size() ==
+                             parent.GetBallsPositions().size());
+        if (record)
+        {
+            search_edges_->push_back(SearchEdge{parent.GetKey(), key, to});
+        }
+    }
+}
+
+size_t GameTable::FindUpperBound (const Movement & start_point,
+                                  const SolvabilityCheck::HoleOrder & order,
+                                  size_t width) const
+{
+    typedef std::pair <size_t, Movement> scored_t;
+    std::vector <scored_t> beam (1, scored_t(0, start_point));
+    std::vector <scored_t> children;
+    std::unordered_set <zobrist_key_t> seen;
+    seen.insert(start_point.GetKey());
+
+    ball_order_t vertical;
+    ball_order_t horizontal;
+    std::vector <bool> open_holes;
+    std::vector <BallRoll> rolls;
+    for (size_t depth=1; depth<=UPPER_BOUND_MOVES; ++depth)
+    {
+        children.clear();
+        for (const auto & parent : beam)
+        {
+            DecodeState(parent.second, vertical, horizontal, open_holes);
+            for (Direction to : {Direction::North, Direction::West,
+                                 Direction::South, Direction::East})
             {
-                if (!new_move.SetBallPosition(ball.second, ball.first, previous.first))
+                bool vertical_move = (to == Direction::North) ||
+                                     (to == Direction::South);
+                rolls.clear();
+                if (!RollAllBalls(to, vertical_move ? vertical : horizontal,
+                                  open_holes, rolls))
                 {
-                    return std::list <Movement> ();
+                    continue;
                 }
-                break;
+                children.emplace_back(0, Movement(to, parent.second));
+                Movement & child = children.back().second;
+                if (!ApplyRolls(rolls, child) ||
+                    !seen.insert(child.GetKey()).second ||
+                    solvability_->IsHopeless(order, child))
+                {
+                    children.pop_back();
+                    continue;
+                }
+                if (child.GetBallsPositions().empty())
+                {
+                    return depth;
+                }
+                children.back().first = solvability_->GetMovesLeft(order, child);
             }
         }
+
+        if (children.size() > width)
+        {
+            std::nth_element(children.begin(), children.begin() + width,
+                             children.end(),
+                             [](const scored_t & l, const scored_t & r)
+            {
+                return l.first < r.first;
+            });
+            children.erase(children.begin() + width, children.end());
+        }
+        if (children.empty())
+        {
+            break;
+        }
+        beam.swap(children);
     }
+    return std::numeric_limits <size_t>::max();
+}
+
+void GameTable::DecodeState (const Movement & state,
+                             ball_order_t & vertical,
+                             ball_order_t & horizontal,
+                             std::vector <bool> & open_holes) const
+{
+    DecodeState(state, Direction::North, vertical, open_holes);
+    horizontal.assign(vertical.begin(), vertical.end());
+    SortBalls(horizontal, false);
+}
+
+void GameTable::DecodeState (const Movement & state, Direction to,
+                             ball_order_t & order,
+                             std::vector <bool> & open_holes) const
+{
+    const auto & balls = state.GetBallsPositions();
+    order.assign(balls.begin(), balls.end());
+    SortBalls(order, (to == Direction::North) || (to == Direction::South));
+
+    open_holes.assign(holes_.size() + 1, false);
+    for (auto hole : state.GetHoles())
+    {
+        open_holes[hole.second] = true;
+    }
+}
+
+void GameTable::SortBalls (ball_order_t & balls, bool vertical)
+{
+    // balls of one row or column are next to each other, in the order
+    // along the axis of the move
+    std::sort(balls.begin(), balls.end(),
+              [vertical](const ball_order_t::value_type & l,
+                         const ball_order_t::value_type & r)
+    {
+        if (vertical)
+        {
+            return (l.first.y != r.first.y) ? (l.first.y < r.first.y)
+                                            : (l.first.x < r.first.x);
+        }
+        return (l.first.x != r.first.x) ? (l.first.x < r.first.x)
+                                        : (l.first.y < r.first.y);
+    });
+}
 
-    if (new_move.IsLooped())
+bool GameTable::ApplyRolls (std::vector <BallRoll> & rolls,
+                            Movement & new_move)
+{
+    SortRolls(rolls);
+    for (auto roll : rolls)
     {
-        return std::list <Movement> ();
+        if (!new_move.SetBallPosition(roll.ball, roll.to, roll.from))
+        {
+            return false;
+        }
     }
+    return true;
+}
 
-    std::list <Movement> new_moves_list (moves);
-    new_moves_list.push_back(new_move);
-    return new_moves_list;
+void GameTable::SortRolls(std::vector<BallRoll> &rolls)
+{
+    // Balls fallen into holes are placed first, then the rest of them.
+    // Both groups are placed in order of their destination cells
+    std::sort(rolls.begin(), rolls.end(),
+              [](const BallRoll & l, const BallRoll & r)
+    {
+        return (l.in_hole != r.in_hole) ? l.in_hole : (l.to < r.to);
+    });
+}
+
+bool GameTable::ApplyMove (Movement & move) const
+{
+    // new state still has balls of its parent
+    ball_order_t order;
+    std::vector <bool> open_holes;
+    DecodeState(move, move.GetMove(), order, open_holes);
+
+    std::vector <BallRoll> rolls;
+    if (!RollAllBalls(move.GetMove(), order, open_holes, rolls))
+    {
+        return false;
+    }
+    return ApplyRolls(rolls, move);
 }
 
 
 bool GameTable::RollAllBalls (Direction to,
-                              const std::map <coordinates_t, ball_id_t> & current_position,
-                              std::map <coordinates_t, ball_id_t> open_holes,
-                              std::map <coordinates_t, ball_id_t> & new_position,
-                              std::map <coordinates_t, ball_id_t> & new_position_removed)
-{
-    coordinate_t begin;
-    coordinate_t end;
-    bool x_before_y;
-
-    switch (to)
-    {
-    case Direction::North:
-        begin = 1;
-        end   = table_size_;
-        x_before_y = false;
-        break;
-    case Direction::West:
-        begin = 1;
-        end   = table_size_;
-        x_before_y = true;
-        break;
-    case Direction::South:
-        begin = table_size_;
-        end   = 1;
-        x_before_y = false;
-        break;
-    case Direction::East:
-        begin = table_size_;
-        end   = 1;
-        x_before_y = true;
-        break;
-    }
-
-    for (coordinate_t i=begin; IsValid(i, table_size_); (begin < end) ? ++i : --i)
-    {
-        for (coordinate_t j=begin; IsValid(j, table_size_); (begin < end) ? ++j : --j)
-        {
-            coordinates_t current_cell = (x_before_y) ? coordinates_t (i, j)
-                                                      : coordinates_t (j, i);
-
-            ball_id_t ball;
-            auto ball_iterator = current_position.find(current_cell);
-            if (ball_iterator == current_position.end())
-            {
-                //no ball here
-                continue;
-            }
-            else
+                              const ball_order_t & order,
+                              const std::vector <bool> & open_holes,
+                              std::vector <BallRoll> & rolls) const
+{
+    // balls closest to the wall on the move side are rolled first
+    bool forward = (to == Direction::North) || (to == Direction::West);
+    size_t count = order.size();
+
+    // holes closed by this tilt are the ones balls have fallen into, the
+    // mask of the parent state stays as it is
+    const size_t first_roll = rolls.size();
+    auto closed_now = [&rolls, first_roll](ball_id_t hole)
+    {
+        for (size_t i = first_roll; i < rolls.size(); ++i)
+        {
+            if (rolls[i].in_hole && (rolls[i].ball == hole))
             {
-                ball = ball_iterator->second;
+                return true;
             }
+        }
+        return false;
+    };
 
-            coordinates_t next_hop = move_graph_.at(current_cell).GetNeigbour(to);
-            auto gaps_on_road = move_graph_.at(current_cell).GetHolesOnWayTo(to);
-            bool reach_gap = false;
-
-            // ball can fall into the hole while movig
-            // if hole id and ball's one dont match game lost,
-            // otherwize ball in its hole and we are on our way to win
-            for (auto gap : gaps_on_road)
+    for (size_t n = 0; n < count; ++n)
+    {
+        const auto & current = forward ? order[n] : order[count - 1 - n];
+        coordinates_t current_cell = current.first;
+        ball_id_t ball = current.second;
+
+        const GraphItem & node = move_graph_.at(current_cell);
+        coordinates_t next_hop = node.GetNeigbour(to);
+        bool reach_gap = false;
+
+        // ball can fall into the hole while movig
+        // if hole id and ball's one dont match game lost,
+        // otherwize ball in its hole and we are on our way to win
+        for (auto gap : node.GetHolesOnWayTo(to))
+        {
+            //is gap open?
+            ball_id_t hole = board_.at(gap).HoleId();
+            if (open_holes[hole] && !closed_now(hole))
             {
-                //is gap open?
-                auto hole = open_holes.find(gap);
-                if (hole != open_holes.end())
+                if (hole == ball)
                 {
-                    if (hole->second == ball)
-                    {
-                        // A-ha ball in his hole!
-                        next_hop = hole->first;
-                        reach_gap = true;
-                        // block hole for next balls
-                        open_holes.erase(hole);
-                        break;
-                    }
-                    else
-                    {
-                        // Game over
-                        return false;
-                    }
+                    // A-ha ball in his hole!
+                    // its roll blocks the hole for next balls
+                    next_hop = gap;
+                    reach_gap = true;
+                    break;
+                }
+                else
+                {
+                    // Game over
+                    return false;
                 }
             }
-            //todo several balls in one cell!!!
+        }
 
-            // is cell empty?
-            if (!reach_gap)
+        if (reach_gap)
+        {
+            rolls.push_back({ball, current_cell, next_hop, true});
+            continue;
+        }
+
+        // cell can be occupied by the balls already rolled
+        auto is_occupied = [&rolls](const coordinates_t & cell)
+        {
+            for (const auto & roll : rolls)
             {
-                // cell can be occupied
-                coordinates_t destination=next_hop;
-                while ( (new_position.find(destination) != new_position.end()) &&
-                        (destination != GetNeighbourCell(current_cell, ReverseDirection(to))) )
+                if (!roll.in_hole && roll.to == cell)
                 {
-                    destination = GetNeighbourCell(destination, ReverseDirection(to));
+                    return true;
                 }
-                next_hop = destination;
             }
+            return false;
+        };
 
-            // set new ball position
-            if (reach_gap)
-            {
-                new_position_removed.insert(std::make_pair(next_hop, ball));
-            }
-            else
-            {
-                new_position.insert(std::make_pair(next_hop, ball));
+        coordinates_t stop_guard = GetNeighbourCell(current_cell, ReverseDirection(to));
+        coordinates_t destination = next_hop;
+        while (is_occupied(destination) && (destination != stop_guard))
+        {
+            destination = GetNeighbourCell(destination, ReverseDirection(to));
+        }
 
-            }
+        // only one ball can be placed on the cell
+        if (!is_occupied(destination))
+        {
+            rolls.push_back({ball, current_cell, destination, false});
         }
     }
     return true;
@@ -37,6 +37,11 @@
 #include <string>
 #include <map>
 #include <list>
+#include <unordered_set>
+#include <functional>
+#include <atomic>
+#include <chrono>
+#include <memory>
 
 #include "tg_types.h"
 #include "cell_object.h"
@@ -45,6 +50,14 @@
 #include "ball.h"
 #include "move_graph.h"
 #include "movement.h"
+#include "packed_moves.h"
+#include "zobrist.h"
+#include "arena.h"
+#include "solution_cache.h"
+#include "transposition_cache.h"
+#include "move_graph_cache.h"
+#include "tablebase.h"
+#include "solvability.h"
 
 //!
 //! \brief The GameTable class Contains description of game state. Looking for
@@ -53,20 +66,174 @@
 class GameTable
 {
 public:
+    //!
+    //! \brief The SearchPath struct Sequence of moves being searched: packed
+    //! moves from initial state and the state they lead to. States passed on
+    //! the way are not kept. Allocated in the arena of its search layer
+    //!
+    struct SearchPath
+    {
+        //!
+        //! \brief SearchPath Sequence of initial state, it has no moves
+        //! \param start initial state
+        //!
+        explicit SearchPath (const Movement & start)
+            : state(start)
+            , previous_key(start.GetKey())
+            , settled(false)
+        {}
+
+        //!
+        //! \brief SearchPath Sequence continued by one move. New state still
+        //! has balls of the parent one, they are rolled by caller
+        //! \param parent sequence to be continued
+        //! \param to move direction
+        //!
+        SearchPath (const SearchPath & parent, Direction to)
+            : moves(parent.moves)
+            , state(to, parent.state)
+            , previous_key(parent.state.GetKey())
+            , settled(false)
+        {
+            moves.Push(to);
+        }
+
+        PackedMoves moves; //!< moves made from initial state
+        Movement state;    //!< state after the moves
+        //! \brief previous_key key of the state before the last move, key
+        //! of initial state if there are no moves
+        zobrist_key_t previous_key;
+        //! \brief settled no ball has fallen into a hole by the last move,
+        //! so every ball is stopped by a wall or by a stopped ball and the
+        //! same move again changes nothing
+        bool settled;
+    };
+
+    //!
+    //! \brief move_path_t sequence of moves being searched
+    //!
+    using move_path_t = SearchPath;
+
+    //!
+    //! \brief move_layer_t all sequences of one search layer
+    //!
+    using move_layer_t = std::list <move_path_t, ArenaAllocator <move_path_t> >;
+
+    //!
+    //! \brief The SearchLimits struct Bounds of the search, zero means no
+    //! bound
+    //!
+    struct SearchLimits
+    {
+        size_t max_moves;  //!< longer sequences are not looked for
+        size_t max_states; //!< search is stopped after visiting more states
+    };
+
+    //!
+    //! \brief The Progress struct Search state given to progress callback
+    //!
+    struct Progress
+    {
+        size_t depth;            //!< moves count of the layer being searched
+        size_t frontier;         //!< sequences in the layer being searched
+        size_t visited;          //!< states visited so far
+        double nodes_per_second; //!< states expanded per second so far
+    };
+
+    //!
+    //! \brief progress_callback_t called by search thread to report progress
+    //!
+    using progress_callback_t = std::function <void (const Progress &)>;
+
+    //!
+    //! \brief The TreeEstimate struct Size of the search predicted by random
+    //! probes, see %EstimateSearchTree
+    //!
+    struct TreeEstimate
+    {
+        double states;    //!< states search is expected to expand
+        double branching; //!< mean count of new states after a move
+        double depth;     //!< mean length of probe paths
+    };
+
+    //!
+    //! \brief The Verification struct Outcome of replaying moves sequence,
+    //! see %VerifyMoves
+    //!
+    struct Verification
+    {
+        //!
+        //! \brief The Status enum Describes how sequence ends
+        //!
+        enum class Status
+        {
+            Won,       //!< all the balls are in their holes
+            Lost,      //!< ball has fallen into another's hole
+            Incomplete //!< sequence is over, but balls are on the board
+        };
+
+        Status status; //!< replay outcome
+        //! \brief moves moves made: to the win, up to the losing one
+        //! including it, or whole sequence if it is incomplete
+        size_t moves;
+    };
+
+    //!
+    //! \brief The SearchEdge struct Move kept by the search: keys of the
+    //! states before and after it, see %SetSearchEdges
+    //!
+    struct SearchEdge
+    {
+        zobrist_key_t from; //!< state the move is made from
+        zobrist_key_t to;   //!< state made by the move
+        Direction move;     //!< move direction
+    };
+
+    //!
+    //! \brief The PruningStats struct Moves dropped by the search, counted
+    //! by the rule that dropped them. Rules are checked in the order of
+    //! fields, every move is counted once. All the rules but the last two
+    //! drop moves before their states are built
+    //!
+    struct PruningStats
+    {
+        //! \brief repeated moves in the direction of the previous move when
+        //! no ball has fallen into a hole by it: such tilt changes nothing,
+        //! so they are dropped before rolling
+        size_t repeated;
+        size_t null_moves; //!< moves leaving all the balls in place
+        //! \brief reversed moves bringing back the state before the previous
+        //! move
+        size_t reversed;
+        size_t revisited; //!< moves to states reached with less moves
+        //! \brief hopeless moves to states which can not be won by hole
+        //! order, see %SolvabilityCheck::IsHopeless
+        size_t hopeless;
+        //! \brief bounded moves to states which can not be won within the
+        //! upper bound, see %GetUpperBound, or within the moves already found.
+        //! State of that kind which is not expanded counts once
+        size_t bounded;
+    };
+
     //!
     //! \brief GameTable Create game table from input data.
     //! Input errors must be handled outside of this class
     //! \param in input data
-    //!
-    GameTable (const InputData & in);
-    ~GameTable() = default;
+    //! \param cache solution cache to be consulted by %CalculateMoves, none
+    //! by default
+    //! \param graph_cache cache of move graphs to be used by
+    //! %CalculateMoves, none by default
+    //!
+    GameTable (const InputData & in, SolutionCache * cache = nullptr,
+               MoveGraphCache * graph_cache = nullptr);
+    ~GameTable();
 
     //!
     //! \brief GetBoard gives representation of game board: cells with their
     //! walls and holes
     //! \return game board representation
     //!
-    std::map<const coordinates_t, BoardCell> GetBoard() const;
+    const std::map<const coordinates_t, BoardCell> & GetBoard() const;
 
     //!
     //! \brief GetTableSize Gives size of game board table
@@ -82,15 +249,203 @@ public:
 
     //!
     //! \brief CalculateMoves calculate moves based on initial board and balls
-    //! state. Must be called manually
+    //! state. Must be called manually. If solution cache is given, moves are
+    //! taken from it and move graph is not built; otherwise calculated moves
+    //! are stored there
     //!
     void CalculateMoves ();
 
+    //!
+    //! \brief StartCalculation Start resumable calculation of the same moves
+    //! %CalculateMoves gives. Solution cache, move graph and tablebase are
+    //! handled here, search is done by %ContinueCalculation
+    //! \return true if calculation is finished, no search is needed
+    //!
+    bool StartCalculation ();
+
+    //!
+    //! \brief ContinueCalculation Make next step of calculation started by
+    //! %StartCalculation. Suspended search may be continued on any thread,
+    //! but on one at a time
+    //! \param budget maximal number of search states to be expanded
+    //! \return true if calculation is finished, moves are ready
+    //!
+    bool ContinueCalculation (size_t budget);
+
+    //!
+    //! \brief SetTranspositionCache Give states learned from other puzzles
+    //! of the same board to %CalculateMoves. Search stops at the known states
+    //! and learned states are added to the cache. Cache must belong to the
+    //! board of this table, see %TranspositionCache::Matches
+    //! \param transpositions transposition cache, null to search without it
+    //!
+    void SetTranspositionCache (TranspositionCache * transpositions);
+
+    //!
+    //! \brief SetTablebase Let %CalculateMoves take moves from tablebase
+    //! instead of searching. Search is done if tablebase does not know the
+    //! start state. Tablebase must belong to the board of this table, see
+    //! %Tablebase::Matches
+    //! \param tablebase tablebase, null to search without it
+    //!
+    void SetTablebase (const Tablebase * tablebase);
+
+    //!
+    //! \brief SetSearchLimits Bound the search done by %CalculateMoves.
+    //! No moves are given if the best ones can not be found within limits
+    //! \param limits search bounds, no bounds by default
+    //!
+    void SetSearchLimits (const SearchLimits & limits);
+
+    //!
+    //! \brief IsLimitReached Check if last calculation was stopped by
+    //! search limits. Then game may still be won, moves are not known
+    //! \return true if search limits were reached
+    //!
+    bool IsLimitReached () const;
+
+    //!
+    //! \brief SetCancelFlag Let search be stopped from other thread. Flag is
+    //! checked between expanded states; once it is set %CalculateMoves
+    //! returns without moves as soon as possible
+    //! \param cancel flag owned by caller, null if search can not be cancelled
+    //!
+    void SetCancelFlag (const std::atomic <bool> * cancel);
+
+    //!
+    //! \brief SetSearchEdges Let search record the moves it keeps. Every
+    //! state is reached by the search on one layer only, so the moves of
+    //! all the best sequences lead from one layer to the next one and are
+    //! among the recorded ones. Moves of a state are recorded once, in order
+    //! of directions, and moves of earlier layers come first
+    //! \param edges moves of the last search are put here, null to search
+    //! without recording
+    //!
+    void SetSearchEdges (std::vector <SearchEdge> * edges);
+
+    //!
+    //! \brief GetPruningStats Gives moves dropped by the last search
+    //! \return pruning counters
+    //!
+    const PruningStats & GetPruningStats () const;
+
+    //!
+    //! \brief CheckSolvability Try to prove that game can not be won from
+    //! initial state without searching, see %SolvabilityCheck. Move graph is
+    //! prepared
+    //! \return proof, reason is None if game may be won
+    //!
+    SolvabilityCheck::Result CheckSolvability ();
+
+    //!
+    //! \brief GetForcedOrder Gives holes which must be closed before others
+    //! in initial state, see %SolvabilityCheck::GetForcedOrder. Move graph
+    //! is prepared
+    //! \return pairs of hole ids: first one is closed before second one
+    //!
+    std::vector <std::pair <ball_id_t, ball_id_t> > GetForcedOrder ();
+
+    //!
+    //! \brief GetUnsolvability Gives why last calculation found no moves
+    //! without searching
+    //! \return proof found by %CheckSolvability, reason is None if search
+    //! was done or moves were known
+    //!
+    const SolvabilityCheck::Result & GetUnsolvability () const;
+
+    //!
+    //! \brief GetUpperBound Gives length of the moves found by greedy
+    //! search made by the last search, see %FindUpperBound. Search drops
+    //! states which can not be won within that many moves
+    //! \return moves of the greedy win, maximal size_t if greedy search was
+    //! not made or found no win
+    //!
+    size_t GetUpperBound () const;
+
+    //!
+    //! \brief IsCancelled Check if last calculation was stopped by cancel flag
+    //! \return true if calculation was cancelled
+    //!
+    bool IsCancelled () const;
+
+    //!
+    //! \brief SetProgressCallback Report search progress on the thread of
+    //! %CalculateMoves, at most once per interval and once per search layer
+    //! \param callback progress callback, empty to disable reports
+    //! \param interval minimal time between reports
+    //!
+    void SetProgressCallback (progress_callback_t callback,
+                              std::chrono::milliseconds interval);
+
+    //!
+    //! \brief PrepareMoveGraph Take move graph from the graph cache or build
+    //! it and store there. In validating mode cached graph is compared with
+    //! built one, the built one is used and stored if they differ.
+    //! Called by %CalculateMoves, does nothing if graph is already prepared
+    //!
+    void PrepareMoveGraph ();
+
+    //!
+    //! \brief EstimateSearchTree Predict search size by Knuth estimator:
+    //! every probe walks from initial state by random moves, product of
+    //! branching factors along the walk estimates layer width. Walks stop at
+    //! won or lost game, and layers deeper than the shortest won walk are not
+    //! counted, as search stops there as well. Move graph is prepared
+    //! \param probes number of random walks
+    //! \param seed random seed, same seed gives same estimate
+    //! \return estimate
+    //!
+    TreeEstimate EstimateSearchTree (size_t probes, std::uint64_t seed);
+
+    //!
+    //! \brief MakeMove Roll all the balls of given state as search does.
+    //! Move graph must be prepared
+    //! \param balls cells of balls on the board and their ids, balls fallen
+    //! into their holes are absent. Holes of absent balls are closed
+    //! \param to move direction
+    //! \param result balls after the move
+    //! \return false if game is lost by this move
+    //!
+    bool MakeMove (const std::map <coordinates_t, ball_id_t> & balls,
+                   Direction to,
+                   std::map <coordinates_t, ball_id_t> & result) const;
+
+    //!
+    //! \brief VerifyMoves Replay moves sequence from initial state by the
+    //! rules of search, without searching. Moves after the win are ignored.
+    //! Move graph is built on the first call, so one table can check many
+    //! sequences of its puzzle quickly
+    //! \param moves moves sequence to be checked
+    //! \return replay outcome
+    //!
+    Verification VerifyMoves (const std::vector <Direction> & moves);
+
+    //!
+    //! \brief MakeState Make game state of this board
+    //! \param balls cells of balls on the board and their ids, balls fallen
+    //! into their holes are absent. Holes of absent balls are closed
+    //! \return game state
+    //!
+    Movement MakeState (const std::map <coordinates_t, ball_id_t> & balls) const;
+
+    //!
+    //! \brief CalculateMovesFrom Same as %CalculateMoves, but from given
+    //! state instead of initial one. Solution cache is not used
+    //! \param balls cells of balls on the board and their ids, see %MakeState
+    //!
+    void CalculateMovesFrom (const std::map <coordinates_t, ball_id_t> & balls);
+
     //!
     //! \brief GetMoveGraph gives representation of internal move graph
     //! \return return move graph
     //!
-    std::map<const coordinates_t, GraphItem> GetMoveGraph() const;
+    const std::map<const coordinates_t, GraphItem> & GetMoveGraph() const;
+
+    //!
+    //! \brief GetMoves gives best moves sequences found by %CalculateMoves
+    //! \return moves sequences, empty if game can not be won
+    //!
+    const std::list <std::vector <Direction> > & GetMoves() const;
 
     //!
     //! \brief PrintMoves prints moves sequence to win in this game
@@ -112,12 +467,79 @@ protected:
     //! \brief table_size_ size of board table
     coordinate_t table_size_;
 
-    //! \brief moves_ best moves sequences
-    std::list <std::list <Movement> > moves_;
+    //! \brief moves_ best moves sequences. Only directions are kept:
+    //! search states are released together with their layers
+    std::list <std::vector <Direction> > moves_;
 
     //! \brief holes_ initial holes positions
     std::map <ball_id_t, coordinates_t> holes_;
 
+    //! \brief zobrist_ keys to hash game states
+    ZobristTable zobrist_;
+
+    //! \brief cache_ solution cache, may be null
+    SolutionCache * cache_;
+
+    //! \brief cache_key_ key of this puzzle in %cache_
+    SolutionCache::Key cache_key_;
+
+    //! \brief graph_cache_ move graphs cache, may be null
+    MoveGraphCache * graph_cache_;
+
+    //! \brief graph_key_ key of this board in %graph_cache_
+    MoveGraphCache::Key graph_key_;
+
+    //! \brief transpositions_ states of this board known from other
+    //! searches, may be null
+    TranspositionCache * transpositions_;
+
+    //! \brief limits_ search bounds
+    SearchLimits limits_;
+
+    //! \brief limit_reached_ last calculation was stopped by %limits_
+    bool limit_reached_;
+
+    //! \brief cancel_ search is stopped when set, may be null
+    const std::atomic <bool> * cancel_;
+
+    //! \brief cancelled_ last calculation was stopped by %cancel_
+    bool cancelled_;
+
+    //! \brief pruning_ moves dropped by the last search
+    PruningStats pruning_;
+
+    //! \brief solvability_ check of the states of this board, made with the
+    //! move graph, null until it is needed
+    std::unique_ptr <SolvabilityCheck> solvability_;
+
+    //! \brief unsolvable_ why last calculation found no moves without search
+    SolvabilityCheck::Result unsolvable_;
+
+    //! \brief upper_bound_ upper bound of the last search, see %GetUpperBound
+    size_t upper_bound_;
+
+    //! \brief progress_ progress callback, may be empty
+    progress_callback_t progress_;
+
+    //! \brief progress_interval_ minimal time between progress reports
+    std::chrono::milliseconds progress_interval_;
+
+    //!
+    //! \brief The Search struct State of suspended search
+    //!
+    struct Search;
+
+    //! \brief search_ search being done, null between searches
+    std::unique_ptr <Search> search_;
+
+    //! \brief tablebase_ distances of all the states of this board, may be
+    //! null
+    const Tablebase * tablebase_;
+
+    //! \brief search_edges_ moves kept by the search are recorded here, may
+    //! be null
+    std::vector <SearchEdge> * search_edges_;
+
     //!
     //! \brief BuildMoveGraph build movement graph using initial board state
     //!
@@ -148,20 +570,151 @@ protected:
     //!
     void FindAllMoves ();
 
+    //!
+    //! \brief CheckMovesLimit Drop moves longer than limits allow
+    //!
+    void CheckMovesLimit ();
+
+    //!
+    //! \brief CheckSolvability Same as above for given state. Move graph
+    //! must be prepared
+    //! \param state game state
+    //! \return proof, reason is None if game may be won
+    //!
+    SolvabilityCheck::Result CheckSolvability (const Movement & state);
+
+    //!
+    //! \brief PrepareSolvabilityCheck Make %solvability_ if it is not made
+    //! yet. Move graph must be prepared
+    //!
+    void PrepareSolvabilityCheck ();
+
+    //!
+    //! \brief GetStartPoint Gives initial game state
+    //! \return initial state
+    //!
+    Movement GetStartPoint () const;
+
+    //!
+    //! \brief FindTablebaseMoves Take best sequences from tablebase
+    //! \param start_point initial game state
+    //! \return false if tablebase does not know the start state or does not
+    //! agree with the board
+    //!
+    bool FindTablebaseMoves (const Movement & start_point);
+
+    //!
+    //! \brief lookup_t Gives what is known about the state
+    //!
+    using lookup_t = std::function <bool (const Movement &,
+                                          TranspositionCache::Entry &)>;
+
     //!
     //! \brief SimulateGame Simulate game untill best moves are found or no
-    //! more possible moves. Makes BFS search in move graph simultaniously
-    //! for several nodes
-    //! \param moves
+    //! more possible moves. Makes BFS search in move graph layer by layer:
+    //! every sequence of current layer is expanded into the next one.
+    //! State already reached on one of previous layers cannot be a part of
+    //! the best sequence, so such sequences are dropped.
+    //!
+    //! Every layer is placed in its own arena. Arena of the layer is released
+    //! as soon as the next layer is built and reused for the layer after.
+    //!
+    //! States found in transposition cache are not expanded: their best
+    //! continuations are taken from the cache and search stops at the layer
+    //! where they finish
+    //! \param start_point initial game state
+    //!
+    void SimulateGame (const Movement & start_point);
+
+    //!
+    //! \brief BeginSimulation Prepare %SimulateGame search to be done by
+    //! steps. States proved to lose are not searched, see %unsolvable_
+    //! \param start_point initial game state
+    //! \return false if moves are known without search
+    //!
+    bool BeginSimulation (const Movement & start_point);
+
+    //!
+    //! \brief StepSimulation Continue search started by %BeginSimulation
+    //! \param budget maximal number of sequences to be expanded
+    //! \return true if search is finished
     //!
-    void SimulateGame (std::list <std::list<Movement> > &moves);
+    bool StepSimulation (size_t budget);
+
+    //!
+    //! \brief SearchSequence Expand one sequence of the current layer, or
+    //! save it if game is won, or take its continuation from transposition
+    //! cache
+    //! \param current_moves sequence to be expanded
+    //! \param lookup gives what is known about the states
+    //!
+    void SearchSequence (const move_path_t & current_moves,
+                         const lookup_t & lookup);
+
+    //!
+    //! \brief FinishSimulation Merge known sequences, apply limits and learn
+    //! transpositions. Search state is released
+    //!
+    void FinishSimulation ();
+
+    //!
+    //! \brief CheckSearch Check cancel flag and report progress when it is
+    //! time to
+    //! \param frontier sequences in the layer being searched
+    //! \return false if search is cancelled
+    //!
+    bool CheckSearch (size_t frontier);
+
+    //!
+    //! \brief FinishCalculation Store calculated moves to solution cache and
+    //! apply moves limit
+    //!
+    void FinishCalculation ();
+
+    //!
+    //! \brief GetTranspositionLookup Gives lookup into transposition cache
+    //! \return lookup
+    //!
+    lookup_t GetTranspositionLookup () const;
+
+    //!
+    //! \brief FollowKnownMoves Replay best continuations of the known state
+    //! \param state known state
+    //! \param known what is known about the state
+    //! \param lookup gives what is known about the next states
+    //! \param prefix moves leading to the state, restored on return
+    //! \param found where complete sequences are added
+    //! \return false if known states do not agree with replayed ones
+    //!
+    bool FollowKnownMoves (const Movement & state,
+                           const TranspositionCache::Entry & known,
+                           const lookup_t & lookup,
+                           std::vector <Direction> & prefix,
+                           std::list <std::vector <Direction> > & found) const;
+
+    //!
+    //! \brief LearnTranspositions Put states of the finished search into
+    //! transposition cache: states of the best sequences with their distance
+    //! or all visited states if game can not be won
+    //! \param start_point initial game state
+    //! \param visited keys of all the states reached by search
+    //!
+    void LearnTranspositions (const Movement & start_point,
+                              const std::unordered_set <zobrist_key_t> & visited);
+
+    //!
+    //! \brief GetDirections Gives moves of the sequence
+    //! \param moves moves sequence
+    //! \return directions of the moves
+    //!
+    static std::vector <Direction> GetDirections (const move_path_t & moves);
 
     //!
     //! \brief SaveMoves save move sequence pretending to be one of the best
     //! \param moves moves sequence
     //! \return false if cannot add
     //!
-    bool SaveMoves (const std::list <Movement> & moves);
+    bool SaveMoves (const move_path_t & moves);
 
     //!
     //! \brief IsTooLotMoves check if current moves sequence is longer than
@@ -169,35 +722,132 @@ protected:
     //! \param moves moves sequence
     //! \return true if too long, false in not
     //!
-    bool IsTooLotMoves (const std::list <Movement> & moves);
+    bool IsTooLotMoves (const move_path_t & moves);
+
+    //!
+    //! \brief ball_order_t balls of one state sorted in the order they are
+    //! rolled along one axis: ball position and ball id
+    //!
+    using ball_order_t = std::vector <std::pair <coordinates_t, ball_id_t> >;
+
+    //!
+    //! \brief The BallRoll struct Result of rolling one ball during the tilt
+    //!
+    struct BallRoll
+    {
+        ball_id_t     ball;    //!< id of the rolled ball
+        coordinates_t from;    //!< cell ball started from
+        coordinates_t to;      //!< cell ball stopped at or hole it has fallen to
+        bool          in_hole; //!< true if ball has fallen into its hole
+    };
 
     //!
     //! \brief RollAllBalls Roll all balls to specific direction and get balls
     //! position after move
     //! \param to move direction
-    //! \param current_position current position of the balls
-    //! \param open_holes currently open holes
-    //! \param new_position balls position after roll
-    //! \param new_position_removed some of the balls fall in the holes, thats
-    //! there they have anded their path
+    //! \param order balls sorted along the axis of the move. Vertical order
+    //! for North and South, horizontal one for West and East
+    //! \param open_holes currently open holes, indexed by hole id. Holes
+    //! closed during the move are told by \a rolls, the mask is not changed
+    //! \param rolls where every ball have stopped or fallen during the move.
+    //! Balls stopped on the same cell are reported only once
     //! \return false if game will be lost during that movement, true if
     //! roll gives valid game state
     //!
     bool RollAllBalls (Direction to,
-                       const std::map <coordinates_t, ball_id_t> & current_position,
-                       std::map<coordinates_t, ball_id_t> open_holes,
-                       std::map<coordinates_t, ball_id_t> &new_position,
-                       std::map<coordinates_t, ball_id_t> &new_position_removed);
+                       const ball_order_t & order,
+                       const std::vector <bool> & open_holes,
+                       std::vector <BallRoll> & rolls) const;
 
     //!
-    //! \brief MakeMove make one roll to the desired direction and form sequence
-    //! with that move included
+    //! \brief ExpandMoves make all four rolls from the last state of the
+    //! sequence and put every valid sequence into the next layer.
+    //! Parent state is decoded only once and shared between all the rolls
     //! \param moves current moves sequence
-    //! \param to direction of new move
-    //! \return sequence of moves with new move attached, empty list if move
-    //! cannot be done
+    //! \param visited keys of the states reached on previous layers.
+    //! Rolls leading to these states are skipped
+    //! \param hole_order hole order of the search, states it proves hopeless
+    //! are dropped. May be empty
+    //! \param upper_bound states which can not be won within that many moves
+    //! by %SolvabilityCheck::GetLowerBound are dropped
+    //! \param next_layer layer to store new sequences with new move attached.
+    //! Useless moves are dropped before their states are built and counted
+    //! in %pruning_
+    //!
+    void ExpandMoves (const move_path_t & moves,
+                      const std::unordered_set <zobrist_key_t> & visited,
+                      const SolvabilityCheck::HoleOrder & hole_order,
+                      size_t upper_bound,
+                      move_layer_t & next_layer);
+
+    //!
+    //! \brief FindUpperBound Search for any win by beam search: every layer
+    //! keeps only the states with least moves left by hole order. Fast, but
+    //! moves it finds are not the best ones
+    //! \param start_point state the search starts from
+    //! \param order hole order of the state, hopeless states are dropped
+    //! \param width states kept on every layer
+    //! \return moves of the win found, maximal size_t if none was found
+    //!
+    size_t FindUpperBound (const Movement & start_point,
+                           const SolvabilityCheck::HoleOrder & order,
+                           size_t width) const;
+
+    //!
+    //! \brief DecodeState Sort balls of the state in rolling order of both
+    //! axis and get mask of open holes
+    //! \param state game state
+    //! \param vertical balls in order of North and South rolls
+    //! \param horizontal balls in order of West and East rolls
+    //! \param open_holes open holes, indexed by hole id
+    //!
+    void DecodeState (const Movement & state,
+                      ball_order_t & vertical,
+                      ball_order_t & horizontal,
+                      std::vector <bool> & open_holes) const;
+
+    //!
+    //! \brief DecodeState Same as above for one move only
+    //! \param state game state
+    //! \param to move direction
+    //! \param order balls in rolling order of the move
+    //! \param open_holes open holes, indexed by hole id
+    //!
+    void DecodeState (const Movement & state, Direction to,
+                      ball_order_t & order,
+                      std::vector <bool> & open_holes) const;
+
+    //!
+    //! \brief SortBalls Sort balls in the order they are rolled along one
+    //! axis, the only order %RollAllBalls takes
+    //! \param balls balls to be sorted
+    //! \param vertical true for North and South moves
+    //!
+    static void SortBalls (ball_order_t & balls, bool vertical);
+
+    //!
+    //! \brief ApplyRolls Move balls of new state as rolls tell
+    //! \param rolls rolls of the move, they are sorted in placing order
+    //! \param new_move state made from its parent, still has parent's balls
+    //! \return false if state is invalid
+    //!
+    static bool ApplyRolls (std::vector <BallRoll> & rolls,
+                            Movement & new_move);
+
+    //!
+    //! \brief SortRolls Sort rolls in order balls are placed by the move:
+    //! balls fallen into holes first, then the rest of them, both groups in
+    //! order of their destination cells
+    //! \param rolls rolls of the move
+    //!
+    static void SortRolls (std::vector <BallRoll> & rolls);
+
+    //!
+    //! \brief ApplyMove Make single move without building the whole layer
+    //! \param move state made from its parent by %Movement(to, parent)
+    //! \return false if game is lost by this move
     //!
-    std::list <Movement> MakeMove (std::list<Movement> &moves, Direction to);
+    bool ApplyMove (Movement & move) const;
 };
 
 std::ostream &
@@ -0,0 +1,332 @@
+/*
+ * Copyright (c) 2017, Ivan
+ * 
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "tablebase.h"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "file_ops.h"
+#include "table.h"
+#include "tg_utils.h"
+
+namespace
+{
+
+//!
+//! \brief The FileHeader struct Header of tablebase file, followed by one
+//! record per state
+//!
+struct FileHeader
+{
+    char magic[8];              //!< "TGTBLBAS"
+    std::uint32_t version;      //!< format version
+    std::uint32_t byte_order;   //!< %BYTE_ORDER_MARK in native order
+    std::uint32_t table_size;   //!< size of game board
+    std::uint32_t balls_count;  //!< number of balls
+    std::uint64_t board;        //!< board hash
+    std::uint64_t count;        //!< number of states
+};
+
+const char FILE_MAGIC[8] = {'T', 'G', 'T', 'B', 'L', 'B', 'A', 'S'};
+const std::uint32_t FILE_VERSION = 1;
+const std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+//! \brief NO_STATE move is impossible or state is not reachable
+const std::uint32_t NO_STATE = 0xFFFFFFFF;
+
+const Direction DIRECTIONS[4] = {Direction::North, Direction::West,
+                                 Direction::South, Direction::East};
+
+}
+
+const std::uint16_t Tablebase::UNSOLVABLE;
+const std::uint64_t Tablebase::DEFAULT_MAX_STATES;
+
+Tablebase::Tablebase(const std::string &filename)
+    : status_(Status::CannotOpen)
+    , table_size_(0)
+    , balls_count_(0)
+    , board_(0)
+    , count_(0)
+    , mapped_(nullptr)
+    , mapped_size_(0)
+    , records_(nullptr)
+{
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return;
+    }
+
+    struct stat st;
+    if ((fstat(fd, &st) != 0) || (st.st_size == 0))
+    {
+        close(fd);
+        return;
+    }
+
+    size_t size = static_cast <size_t> (st.st_size);
+    void * mapped = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED)
+    {
+        return;
+    }
+    mapped_ = mapped;
+    mapped_size_ = size;
+
+    const FileHeader * header = static_cast <const FileHeader*> (mapped);
+    if ((size < sizeof(FileHeader)) ||
+        (std::memcmp(header->magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0) ||
+        (header->version != FILE_VERSION) ||
+        (header->byte_order != BYTE_ORDER_MARK))
+    {
+        status_ = Status::InvalidHeader;
+        return;
+    }
+
+    if (header->count > (size - sizeof(FileHeader)) / sizeof(Record))
+    {
+        status_ = Status::Truncated;
+        return;
+    }
+
+    table_size_ = header->table_size;
+    balls_count_ = header->balls_count;
+    board_ = header->board;
+    count_ = header->count;
+    records_ = reinterpret_cast <const Record*> (
+                   static_cast <const char*> (mapped) + sizeof(FileHeader));
+    status_ = Status::Ok;
+}
+
+Tablebase::~Tablebase()
+{
+    if (mapped_ != nullptr)
+    {
+        munmap(mapped_, mapped_size_);
+    }
+}
+
+Tablebase::Status Tablebase::GetStatus() const
+{
+    return status_;
+}
+
+bool Tablebase::Matches(const InputData &in) const
+{
+    return (status_ == Status::Ok) && (in.GetBoardHash() == board_);
+}
+
+std::uint64_t Tablebase::GetStatesCount() const
+{
+    return count_;
+}
+
+bool Tablebase::Build(const InputData &board, const std::string &filename,
+                      std::uint64_t max_states)
+{
+    if (InputData::Status::Ok != board.GetDataStatus())
+    {
+        return false;
+    }
+
+    coordinate_t table_size = board.GetTableSize();
+    ball_id_t balls_count = board.GetBallCount();
+    std::uint64_t cells = static_cast <std::uint64_t> (table_size) * table_size;
+    std::uint64_t radix = cells + 1;
+
+    // four moves of every state must be addressed by 32 bit index
+    std::uint64_t limit = std::min <std::uint64_t> (max_states, NO_STATE / 4);
+    std::uint64_t count = 1;
+    for (ball_id_t i=0; i<balls_count; ++i)
+    {
+        if (count > limit / radix)
+        {
+            return false;
+        }
+        count *= radix;
+    }
+
+    GameTable table (board);
+    table.PrepareMoveGraph();
+
+    // hole id of every cell, INVALID_ID if none
+    std::vector <ball_id_t> hole_at (cells, INVALID_ID);
+    ball_id_t hole_id = 1;
+    for (const auto & hole : board.GetHoles())
+    {
+        hole_at[static_cast <std::uint64_t> (hole.x - 1) * table_size +
+                (hole.y - 1)] = hole_id++;
+    }
+
+    // roll every possible state in all four directions. All balls are in
+    // the holes in the last state, it is not rolled
+    std::vector <std::uint32_t> next (4 * count, NO_STATE);
+    std::vector <std::uint64_t> digits (balls_count + 1);
+    std::map <coordinates_t, ball_id_t> balls;
+    std::map <coordinates_t, ball_id_t> rolled;
+    std::uint64_t win = count - 1;
+
+    for (std::uint64_t index=0; index<win; ++index)
+    {
+        std::uint64_t rest = index;
+        for (ball_id_t ball=1; ball<=balls_count; ++ball)
+        {
+            digits[ball] = rest % radix;
+            rest /= radix;
+        }
+
+        // balls can not share the cell or stand on open hole
+        bool possible = true;
+        balls.clear();
+        for (ball_id_t ball=1; possible && (ball<=balls_count); ++ball)
+        {
+            if (digits[ball] == cells)
+            {
+                continue;
+            }
+            ball_id_t hole = hole_at[digits[ball]];
+            coordinates_t cell ((digits[ball] / table_size + 1) & 0xFFFFFFFF,
+                                (digits[ball] % table_size + 1) & 0xFFFFFFFF);
+            possible = ((hole == INVALID_ID) || (digits[hole] == cells)) &&
+                       balls.insert(std::make_pair(cell, ball)).second;
+        }
+        if (!possible)
+        {
+            continue;
+        }
+
+        for (unsigned d=0; d<4; ++d)
+        {
+            std::uint64_t rolled_index = 0;
+            if (table.MakeMove(balls, DIRECTIONS[d], rolled) &&
+                GetIndex(rolled, table_size, balls_count, rolled_index))
+            {
+                next[4 * index + d] = rolled_index & 0xFFFFFFFF;
+            }
+        }
+    }
+
+    // reverse moves: previous states of every state
+    std::vector <std::uint32_t> first (count + 1, 0);
+    for (auto state : next)
+    {
+        if (state != NO_STATE)
+        {
+            ++first[state + 1];
+        }
+    }
+    for (std::uint64_t i=0; i<count; ++i)
+    {
+        first[i + 1] += first[i];
+    }
+    std::vector <std::uint32_t> previous (first[count]);
+    {
+        std::vector <std::uint32_t> fill (first.begin(), first.end() - 1);
+        for (std::uint64_t i=0; i<next.size(); ++i)
+        {
+            if (next[i] != NO_STATE)
+            {
+                previous[fill[next[i]]++] = (i / 4) & 0xFFFFFFFF;
+            }
+        }
+    }
+
+    // BFS backward from the win
+    std::vector <std::uint16_t> distance (count, UNSOLVABLE);
+    std::vector <std::uint32_t> queue;
+    distance[win] = 0;
+    queue.push_back(win & 0xFFFFFFFF);
+    for (size_t head=0; head<queue.size(); ++head)
+    {
+        std::uint32_t state = queue[head];
+        if (distance[state] + 1 >= UNSOLVABLE)
+        {
+            return false;
+        }
+        for (std::uint32_t i=first[state]; i<first[state + 1]; ++i)
+        {
+            std::uint32_t parent = previous[i];
+            if (distance[parent] == UNSOLVABLE)
+            {
+                distance[parent] = distance[state] + 1;
+                queue.push_back(parent);
+            }
+        }
+    }
+
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+    header.version = FILE_VERSION;
+    header.byte_order = BYTE_ORDER_MARK;
+    header.table_size = table_size;
+    header.balls_count = balls_count;
+    header.board = board.GetBoardHash();
+    header.count = count;
+
+    return WriteFileAtomically(filename, [&] (std::ostream & file)
+    {
+        file.write(reinterpret_cast <const char*> (&header), sizeof(header));
+
+        // best moves lead to states one move closer to the win
+        std::vector <Record> records;
+        records.reserve(4096);
+        for (std::uint64_t i=0; i<count; ++i)
+        {
+            Record record = {distance[i], 0, 0};
+            for (unsigned d=0; (d<4) && (distance[i] != UNSOLVABLE); ++d)
+            {
+                std::uint32_t state = next[4 * i + d];
+                if ((state != NO_STATE) && (distance[state] + 1 == distance[i]))
+                {
+                    record.moves |= 1 << static_cast <unsigned> (DIRECTIONS[d]);
+                }
+            }
+            records.push_back(record);
+            if ((records.size() == records.capacity()) || (i + 1 == count))
+            {
+                file.write(reinterpret_cast <const char*> (records.data()),
+                           records.size() * sizeof(Record));
+                records.clear();
+            }
+        }
+    });
+}
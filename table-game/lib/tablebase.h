@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2017, Ivan
+ * 
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TG_TABLEBASE_H
+#define TG_TABLEBASE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "input.h"
+#include "tg_types.h"
+#include "transposition_cache.h"
+
+//!
+//! \brief The Tablebase class Distance to the win and best moves of every
+//! state of one board, computed offline by %Build. Board is table size,
+//! walls and holes; balls may start anywhere.
+//!
+//! State is addressed by perfect hash: every ball is either on one of
+//! N*N cells or in its hole, so state is a number of K digits in radix
+//! N*N+1, digit of ball 1 being the lowest one. Hole state follows from
+//! ball state: hole is closed when its ball has fallen there.
+//!
+//! Tablebase file is written in native byte order: header and one record
+//! per state. File is mapped into memory and read in place. Lookups may be
+//! done from several threads at once.
+//!
+class Tablebase
+{
+public:
+    //!
+    //! \brief Entry What is known about the state, same as kept by
+    //! transposition cache
+    //!
+    using Entry = TranspositionCache::Entry;
+
+    //!
+    //! \brief UNSOLVABLE distance of states game can not be won from and
+    //! of impossible states
+    //!
+    static const std::uint16_t UNSOLVABLE = TranspositionCache::UNSOLVABLE;
+
+    //!
+    //! \brief DEFAULT_MAX_STATES states limit of %Build. Building takes
+    //! about 40 bytes of memory per state
+    //!
+    static const std::uint64_t DEFAULT_MAX_STATES = 1ULL << 24;
+
+    //!
+    //! \brief The Status enum Describes result of opening tablebase
+    //!
+    enum class Status
+    {
+        Ok,            //!< tablebase can be used
+        CannotOpen,    //!< file can not be opened or mapped
+        InvalidHeader, //!< file is not a tablebase or of unsupported version
+        Truncated      //!< file is shorter than its header tells
+    };
+
+    //!
+    //! \brief Tablebase Map tablebase file
+    //! \param filename tablebase file
+    //!
+    explicit Tablebase (const std::string & filename);
+    ~Tablebase ();
+
+    Tablebase (const Tablebase &) = delete;
+    Tablebase & operator= (const Tablebase &) = delete;
+
+    //!
+    //! \brief GetStatus Gives result of opening tablebase
+    //! \return opening status
+    //!
+    Status GetStatus () const;
+
+    //!
+    //! \brief Matches Check if puzzle is played on the board of tablebase
+    //! \param in valid puzzle
+    //! \return true if board hash is the same
+    //!
+    bool Matches (const InputData & in) const;
+
+    //!
+    //! \brief GetStatesCount Gives number of states in tablebase
+    //! \return states count
+    //!
+    std::uint64_t GetStatesCount () const;
+
+    //!
+    //! \brief Find Look for the state
+    //! \param balls cells of balls on the board and their ids, balls fallen
+    //! into their holes are absent
+    //! \param entry what is known about the state
+    //! \return false if state can not be addressed on this board
+    //!
+    template <typename CellsMap>
+    bool Find (const CellsMap & balls, Entry & entry) const
+    {
+        std::uint64_t index = 0;
+        if ((status_ != Status::Ok) ||
+            !GetIndex(balls, table_size_, balls_count_, index) ||
+            (index >= count_))
+        {
+            return false;
+        }
+        entry.distance = records_[index].distance;
+        entry.moves = records_[index].moves;
+        return true;
+    }
+
+    //!
+    //! \brief Build Compute tablebase of the board by retrograde analysis:
+    //! every state is rolled in four directions, then distances are spread
+    //! backward from the winning state by BFS
+    //! \param board valid puzzle, only its board is taken into account
+    //! \param filename tablebase file to be written
+    //! \param max_states refuse boards with more states
+    //! \return false if board has too many states or file can not be written
+    //!
+    static bool Build (const InputData & board, const std::string & filename,
+                       std::uint64_t max_states = DEFAULT_MAX_STATES);
+
+    //!
+    //! \brief GetIndex Perfect hash of the state
+    //! \param balls cells of balls on the board and their ids
+    //! \param table_size size of game board
+    //! \param balls_count number of balls
+    //! \param index state index
+    //! \return false if some ball is out of the table
+    //!
+    template <typename CellsMap>
+    static bool GetIndex (const CellsMap & balls, coordinate_t table_size,
+                          ball_id_t balls_count, std::uint64_t & index)
+    {
+        std::uint64_t cells = static_cast <std::uint64_t> (table_size) * table_size;
+        std::uint64_t radix = cells + 1;
+
+        // every ball is in its hole unless found on the board
+        std::uint64_t weight = 1;
+        index = 0;
+        for (ball_id_t ball=1; ball<=balls_count; ++ball)
+        {
+            index += cells * weight;
+            weight *= radix;
+        }
+
+        for (const auto & ball : balls)
+        {
+            if ((ball.second == INVALID_ID) || (ball.second > balls_count) ||
+                (ball.first.x == 0) || (ball.first.x > table_size) ||
+                (ball.first.y == 0) || (ball.first.y > table_size))
+            {
+                return false;
+            }
+            weight = 1;
+            for (ball_id_t i=1; i<ball.second; ++i)
+            {
+                weight *= radix;
+            }
+            std::uint64_t cell = static_cast <std::uint64_t> (ball.first.x - 1) * table_size +
+                                 (ball.first.y - 1);
+            index -= (cells - cell) * weight;
+        }
+        return true;
+    }
+
+private:
+    //!
+    //! \brief The Record struct Tablebase entry of one state
+    //!
+    struct Record
+    {
+        std::uint16_t distance; //!< see %Entry
+        std::uint8_t moves;     //!< see %Entry
+        std::uint8_t reserved;  //!< zero
+    };
+
+    Status status_; //!< opening status
+    coordinate_t table_size_; //!< size of game board
+    ball_id_t balls_count_; //!< number of balls
+    std::uint64_t board_; //!< board hash
+    std::uint64_t count_; //!< number of states
+    void * mapped_; //!< mapped file
+    size_t mapped_size_; //!< size of mapped file
+    const Record * records_; //!< records indexed by state
+};
+
+#endif // TG_TABLEBASE_H
@@ -33,7 +33,11 @@
 #define TG_UTILS_H
 
 #include "tg_types.h"
+#include <algorithm>
+#include <cstdint>
 #include <cstring>
+#include <string>
+#include <utility>
 
 
 
@@ -183,22 +187,114 @@ GetNeighbourCell (const coordinates_t & cell, Direction side)
 }
 
 //!
-//! /brief Find duplicated items in vector
+//! \brief DuplicateKey Key to sort items by when looking for duplicates.
+//! Items are equal if and only if their keys are equal
+//! \param v item
+//! \return item itself
+//!
+template < typename T >
+inline T DuplicateKey (const T & v)
+{
+    return v;
+}
+
+//!
+//! \brief DuplicateKey Wall key: pair of its cells, smaller cell first, so
+//! the same wall given in both directions has the same key, as %operator==
+//! assumes
+//! \param w wall coordinates
+//! \return normalized pair of cells
+//!
+inline std::pair <coordinates_t, coordinates_t>
+DuplicateKey (const wall_coordinates_t & w)
+{
+    return (w.second < w.first) ? std::make_pair(w.second, w.first)
+                                : std::make_pair(w.first, w.second);
+}
+
+//!
+//! \brief Find duplicated items in vector. Items keys are sorted and
+//! neighbours compared, so it takes O(n log n)
+//! \see %DuplicateKey
 //!
 template < typename T >
 inline bool HasDuplicates (const std::vector<T> & v)
 {
-    for(size_t i = 0; i < v.size() - 1; ++i)
+    using key_t = decltype(DuplicateKey(v.front()));
+
+    std::vector <key_t> keys;
+    keys.reserve(v.size());
+    for (const auto & item : v)
+    {
+        keys.push_back(DuplicateKey(item));
+    }
+
+    std::sort(keys.begin(), keys.end());
+    return std::adjacent_find(keys.begin(), keys.end()) != keys.end();
+}
+
+//!
+//! \brief HasCommonItems Check if two vectors have at least one equal item.
+//! Both vectors are sorted, so it takes O(n log n)
+//!
+template < typename T >
+inline bool HasCommonItems (const std::vector<T> & l, const std::vector<T> & r)
+{
+    std::vector <T> left (l);
+    std::vector <T> right (r);
+    std::sort(left.begin(), left.end());
+    std::sort(right.begin(), right.end());
+
+    auto i = left.begin();
+    auto j = right.begin();
+    while ((i != left.end()) && (j != right.end()))
     {
-        for(size_t j = i+1; j < v.size(); ++j)
+        if (*i < *j)
+            ++i;
+        else if (*j < *i)
+            ++j;
+        else
+            return true;
+    }
+    return false;
+}
+
+//!
+//! \brief Fnv1a 64-bit FNV-1a hash of coordinates, every coordinate is
+//! taken as four bytes, least significant first
+//! \param data coordinates to hash
+//! \return hash value
+//!
+inline std::uint64_t Fnv1a (const input_data_t & data)
+{
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (auto value : data)
+    {
+        for (unsigned i=0; i<4; ++i)
         {
-            if (v[i] == v[j])
-            {
-                return true;
-            }
+            hash ^= (value >> (8 * i)) & 0xFF;
+            hash *= 1099511628211ULL;
         }
     }
-    return false;
+    return hash;
+}
+
+//!
+//! \brief HashName File name for the coordinates: %Fnv1a hash written as
+//! 16 lowercase hex digits
+//! \param data coordinates to hash
+//! \return file name
+//!
+inline std::string HashName (const input_data_t & data)
+{
+    const std::uint64_t hash = Fnv1a(data);
+    const char digits[] = "0123456789abcdef";
+    std::string name (16, '0');
+    for (unsigned i=0; i<16; ++i)
+    {
+        name[15 - i] = digits[(hash >> (4 * i)) & 0xF];
+    }
+    return name;
 }
 
 template <typename T>
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2017, Ivan
+ * 
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "thread_pool.h"
+
+ThreadPool::ThreadPool(size_t workers)
+    : running_(0)
+    , stop_(false)
+{
+    if (workers == 0)
+    {
+        workers = std::thread::hardware_concurrency();
+    }
+    if (workers == 0)
+    {
+        workers = 1;
+    }
+
+    workers_.reserve(workers);
+    for (size_t i=0; i<workers; ++i)
+    {
+        workers_.emplace_back(&ThreadPool::WorkerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard <std::mutex> lock (mutex_);
+        stop_ = true;
+    }
+    task_ready_.notify_all();
+
+    for (auto & worker : workers_)
+    {
+        worker.join();
+    }
+}
+
+void ThreadPool::Submit(task_t task)
+{
+    {
+        std::lock_guard <std::mutex> lock (mutex_);
+        tasks_.push_back(std::move(task));
+    }
+    task_ready_.notify_one();
+}
+
+void ThreadPool::Wait()
+{
+    std::unique_lock <std::mutex> lock (mutex_);
+    all_done_.wait(lock, [this] { return tasks_.empty() && (running_ == 0); });
+}
+
+size_t ThreadPool::GetWorkersCount() const
+{
+    return workers_.size();
+}
+
+void ThreadPool::WorkerLoop()
+{
+    std::unique_lock <std::mutex> lock (mutex_);
+    while (1)
+    {
+        task_ready_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+        if (tasks_.empty())
+        {
+            // stopped and nothing left to do
+            return;
+        }
+
+        task_t task = std::move(tasks_.front());
+        tasks_.pop_front();
+        ++running_;
+
+        lock.unlock();
+        task();
+        lock.lock();
+
+        --running_;
+        if (tasks_.empty() && (running_ == 0))
+        {
+            all_done_.notify_all();
+        }
+    }
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2017, Ivan
+ * 
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TG_THREAD_POOL_H
+#define TG_THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//!
+//! \brief The ThreadPool class Fixed set of worker threads running submitted
+//! tasks in submission order
+//!
+class ThreadPool
+{
+public:
+    //!
+    //! \brief task_t task to be run by worker
+    //!
+    using task_t = std::function <void ()>;
+
+    //!
+    //! \brief ThreadPool Start workers
+    //! \param workers number of worker threads. If 0, one worker per
+    //! hardware thread is started
+    //!
+    explicit ThreadPool (size_t workers = 0);
+
+    //!
+    //! \brief ~ThreadPool Run all pending tasks and stop workers
+    //!
+    ~ThreadPool ();
+
+    ThreadPool (const ThreadPool &) = delete;
+    ThreadPool & operator= (const ThreadPool &) = delete;
+
+    //!
+    //! \brief Submit Add task to the queue
+    //! \param task task to be run
+    //!
+    void Submit (task_t task);
+
+    //!
+    //! \brief Wait Block until all submitted tasks are done
+    //!
+    void Wait ();
+
+    //!
+    //! \brief GetWorkersCount Gives number of worker threads
+    //! \return workers count
+    //!
+    size_t GetWorkersCount () const;
+
+private:
+    std::vector <std::thread> workers_; //!< worker threads
+    std::deque <task_t> tasks_; //!< tasks waiting for worker
+    std::mutex mutex_; //!< guards queue and counters
+    std::condition_variable task_ready_; //!< signalled on new task or stop
+    std::condition_variable all_done_; //!< signalled when queue is drained
+    size_t running_; //!< number of tasks being run now
+    bool stop_; //!< workers must exit when queue is empty
+
+    //!
+    //! \brief WorkerLoop Take tasks from the queue until pool is stopped
+    //!
+    void WorkerLoop ();
+};
+
+#endif // TG_THREAD_POOL_H
@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) 2017, Ivan
+ * 
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "transposition_cache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "file_ops.h"
+
+namespace
+{
+
+//!
+//! \brief The FileHeader struct Header of cache file. File is written in
+//! native byte order, byte_order field detects foreign files
+//!
+struct FileHeader
+{
+    char magic[8];              //!< "TGTRANSP"
+    std::uint32_t version;      //!< format version
+    std::uint32_t byte_order;   //!< %BYTE_ORDER_MARK in native order
+    std::uint64_t board;        //!< board hash
+    std::uint64_t count;        //!< number of records
+};
+
+const char FILE_MAGIC[8] = {'T', 'G', 'T', 'R', 'A', 'N', 'S', 'P'};
+const std::uint32_t FILE_VERSION = 1;
+const std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+}
+
+const std::uint16_t TranspositionCache::UNSOLVABLE;
+
+TranspositionCache::TranspositionCache(const InputData &board)
+    : board_(board.GetBoardHash())
+    , mapped_(nullptr)
+    , mapped_size_(0)
+    , records_(nullptr)
+    , records_count_(0)
+{
+}
+
+TranspositionCache::~TranspositionCache()
+{
+    Unmap();
+}
+
+bool TranspositionCache::Matches(const InputData &in) const
+{
+    return in.GetBoardHash() == board_;
+}
+
+bool TranspositionCache::Load(const std::string &filename)
+{
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat st;
+    if ((fstat(fd, &st) != 0) ||
+        (static_cast <size_t> (st.st_size) < sizeof(FileHeader)))
+    {
+        close(fd);
+        return false;
+    }
+
+    size_t size = static_cast <size_t> (st.st_size);
+    void * mapped = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED)
+    {
+        return false;
+    }
+
+    const FileHeader * header = static_cast <const FileHeader*> (mapped);
+    if ((std::memcmp(header->magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0) ||
+        (header->version != FILE_VERSION) ||
+        (header->byte_order != BYTE_ORDER_MARK) ||
+        (header->board != board_) ||
+        (header->count > (size - sizeof(FileHeader)) / sizeof(Record)))
+    {
+        munmap(mapped, size);
+        return false;
+    }
+
+    Unmap();
+    mapped_ = mapped;
+    mapped_size_ = size;
+    records_ = reinterpret_cast <const Record*> (
+                   static_cast <const char*> (mapped) + sizeof(FileHeader));
+    records_count_ = header->count;
+    return true;
+}
+
+bool TranspositionCache::Save(const std::string &filename) const
+{
+    std::vector <Record> records;
+    records.reserve(records_count_ + entries_.size());
+
+    // added entries take precedence over mapped ones
+    for (size_t i=0; i<records_count_; ++i)
+    {
+        if (entries_.count(records_[i].key) == 0)
+        {
+            records.push_back(records_[i]);
+        }
+    }
+    for (const auto & entry : entries_)
+    {
+        Record record;
+        std::memset(&record, 0, sizeof(record));
+        record.key = entry.first;
+        record.distance = entry.second.distance;
+        record.moves = entry.second.moves;
+        records.push_back(record);
+    }
+    std::sort(records.begin(), records.end(),
+              [] (const Record & l, const Record & r) { return l.key < r.key; });
+
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+    header.version = FILE_VERSION;
+    header.byte_order = BYTE_ORDER_MARK;
+    header.board = board_;
+    header.count = records.size();
+
+    // mapped file stays valid while new one replaces it
+    return WriteFileAtomically(filename, [&] (std::ostream & file)
+    {
+        file.write(reinterpret_cast <const char*> (&header), sizeof(header));
+        file.write(reinterpret_cast <const char*> (records.data()),
+                   records.size() * sizeof(Record));
+    });
+}
+
+bool TranspositionCache::Find(zobrist_key_t key, Entry &entry) const
+{
+    auto found = entries_.find(key);
+    if (found != entries_.end())
+    {
+        entry = found->second;
+        return true;
+    }
+
+    const Record * end = records_ + records_count_;
+    const Record * record = std::lower_bound(records_, end, key,
+        [] (const Record & r, zobrist_key_t k) { return r.key < k; });
+    if ((record != end) && (record->key == key))
+    {
+        entry.distance = record->distance;
+        entry.moves = record->moves;
+        return true;
+    }
+    return false;
+}
+
+void TranspositionCache::Add(zobrist_key_t key, std::uint16_t distance,
+                             Direction to)
+{
+    std::uint8_t move = 1 << static_cast <unsigned> (to);
+
+    Entry known;
+    if (Find(key, known) && (known.distance == distance))
+    {
+        known.moves |= move;
+    }
+    else
+    {
+        known.distance = distance;
+        known.moves = move;
+    }
+    entries_[key] = known;
+}
+
+void TranspositionCache::AddUnsolvable(zobrist_key_t key)
+{
+    entries_[key] = Entry{UNSOLVABLE, 0};
+}
+
+size_t TranspositionCache::GetSize() const
+{
+    return entries_.size() + records_count_;
+}
+
+void TranspositionCache::Unmap()
+{
+    if (mapped_ != nullptr)
+    {
+        munmap(mapped_, mapped_size_);
+        mapped_ = nullptr;
+        mapped_size_ = 0;
+        records_ = nullptr;
+        records_count_ = 0;
+    }
+}
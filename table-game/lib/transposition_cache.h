@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2017, Ivan
+ * 
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TG_TRANSPOSITION_CACHE_H
+#define TG_TRANSPOSITION_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include "input.h"
+#include "zobrist.h"
+
+//!
+//! \brief The TranspositionCache class Game states of one board with proven
+//! distance to the win, learned by earlier searches. Puzzles of one board
+//! have the same table size, walls and holes and differ only in balls start
+//! positions, so they share states and the same cache.
+//!
+//! For every known state the cache keeps number of moves to the win and
+//! mask of moves starting the best sequences, or that the game can not be
+//! won from the state. States are identified by their Zobrist keys.
+//!
+//! Entries are kept in memory and can be saved to a file. Saved file is
+//! mapped into memory by %Load and searched in place, without parsing.
+//! Cache must not be used from several threads at once.
+//!
+class TranspositionCache
+{
+public:
+    //!
+    //! \brief The Entry struct What is known about the state
+    //!
+    struct Entry
+    {
+        std::uint16_t distance; //!< moves to the win, %UNSOLVABLE if none
+        std::uint8_t moves;     //!< bit (1 << Direction) for every best move
+    };
+
+    //!
+    //! \brief UNSOLVABLE distance of states game can not be won from
+    //!
+    static const std::uint16_t UNSOLVABLE = 0xFFFF;
+
+    //!
+    //! \brief TranspositionCache Create empty cache for the board of puzzle
+    //! \param board valid puzzle, only its board is taken into account
+    //!
+    explicit TranspositionCache (const InputData & board);
+    ~TranspositionCache ();
+
+    TranspositionCache (const TranspositionCache &) = delete;
+    TranspositionCache & operator= (const TranspositionCache &) = delete;
+
+    //!
+    //! \brief Matches Check if puzzle is played on the board of the cache
+    //! \param in valid puzzle
+    //! \return true if table size, balls count, walls and holes are the same
+    //!
+    bool Matches (const InputData & in) const;
+
+    //!
+    //! \brief Load Map saved cache. Entries added later take precedence
+    //! \param filename cache file
+    //! \return false if file can not be mapped or belongs to another board
+    //!
+    bool Load (const std::string & filename);
+
+    //!
+    //! \brief Save Write all the entries, mapped and added, into file
+    //! \param filename cache file, may be the one being mapped
+    //! \return false if file can not be written
+    //!
+    bool Save (const std::string & filename) const;
+
+    //!
+    //! \brief Find Look for the state
+    //! \param key state key
+    //! \param entry what is known about the state
+    //! \return false if state is unknown
+    //!
+    bool Find (zobrist_key_t key, Entry & entry) const;
+
+    //!
+    //! \brief Add Remember best move of the state. Moves of the same distance
+    //! are merged
+    //! \param key state key
+    //! \param distance moves to the win
+    //! \param to first move of the best sequence
+    //!
+    void Add (zobrist_key_t key, std::uint16_t distance, Direction to);
+
+    //!
+    //! \brief AddUnsolvable Remember that game can not be won from the state
+    //! \param key state key
+    //!
+    void AddUnsolvable (zobrist_key_t key);
+
+    //!
+    //! \brief GetSize Gives number of entries, mapped ones included
+    //! \return entries count, states known in both places are counted twice
+    //!
+    size_t GetSize () const;
+
+private:
+    //!
+    //! \brief The Record struct Entry of cache file
+    //!
+    struct Record
+    {
+        std::uint64_t key;       //!< state key
+        std::uint16_t distance;  //!< see %Entry
+        std::uint8_t moves;      //!< see %Entry
+        std::uint8_t reserved[5]; //!< padding, zeros
+    };
+
+    std::uint64_t board_; //!< hash of the board
+    //! \brief entries_ entries added since the file was loaded
+    std::unordered_map <zobrist_key_t, Entry> entries_;
+    void * mapped_; //!< mapped cache file
+    size_t mapped_size_; //!< size of mapped file
+    const Record * records_; //!< mapped records sorted by key
+    size_t records_count_; //!< number of mapped records
+
+    //!
+    //! \brief Unmap Release mapped file
+    //!
+    void Unmap ();
+};
+
+#endif // TG_TRANSPOSITION_CACHE_H
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2017, Ivan
+ * 
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "zobrist.h"
+
+namespace
+{
+
+//!
+//! \brief SplitMix64 Generate next pseudo random number. Simple and good
+//! enough to fill the table with well distributed keys
+//! \param state generator state
+//! \return next random number
+//!
+zobrist_key_t SplitMix64 (zobrist_key_t & state)
+{
+    zobrist_key_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+//! Fixed seed, keys must not change from run to run
+const zobrist_key_t zobrist_seed = 0x7467616D65ULL;
+
+}
+
+ZobristTable::ZobristTable(coordinate_t table_size, ball_id_t balls_count)
+    : table_size_(table_size)
+{
+    zobrist_key_t state = zobrist_seed;
+    size_t cells = static_cast<size_t>(table_size) * table_size;
+
+    // ball ids and hole ids start from 1
+    ball_keys_.resize((balls_count + 1) * cells);
+    for (auto & key : ball_keys_)
+    {
+        key = SplitMix64(state);
+    }
+
+    hole_keys_.resize(balls_count + 1);
+    for (auto & key : hole_keys_)
+    {
+        key = SplitMix64(state);
+    }
+}
+
+zobrist_key_t ZobristTable::BallKey(ball_id_t ball, const coordinates_t &cell) const
+{
+    size_t cells = static_cast<size_t>(table_size_) * table_size_;
+    size_t index = (cell.y - 1) * static_cast<size_t>(table_size_) + (cell.x - 1);
+    return ball_keys_[ball * cells + index];
+}
+
+zobrist_key_t ZobristTable::HoleKey(ball_id_t hole) const
+{
+    return hole_keys_[hole];
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2017, Ivan
+ * 
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TG_ZOBRIST_H
+#define TG_ZOBRIST_H
+
+#include <cstdint>
+#include <vector>
+
+#include "tg_types.h"
+
+//! \brief 64-bit Zobrist key of the game state
+using zobrist_key_t = std::uint64_t;
+
+//!
+//! \brief The ZobristTable class Holds random keys for every ball on every
+//! cell and for every open hole. Key of the game state is XOR of keys of all
+//! balls on the board and all open holes, so moving a ball or closing a hole
+//! updates state key with a couple of XORs.
+//!
+//! Keys are generated from fixed seed: same board gives same keys in every
+//! run, so state keys can be stored and compared between runs
+//!
+class ZobristTable
+{
+public:
+    //!
+    //! \brief ZobristTable Generate keys for the game board
+    //! \param table_size size of game board
+    //! \param balls_count number of balls (and holes) on the board
+    //!
+    ZobristTable (coordinate_t table_size, ball_id_t balls_count);
+    ~ZobristTable() = default;
+
+    //!
+    //! \brief BallKey key of the ball standing on the cell
+    //! \param ball ball id
+    //! \param cell cell address
+    //! \return key
+    //!
+    zobrist_key_t BallKey (ball_id_t ball, const coordinates_t & cell) const;
+
+    //!
+    //! \brief HoleKey key of the open hole
+    //! \param hole hole id
+    //! \return key
+    //!
+    zobrist_key_t HoleKey (ball_id_t hole) const;
+
+    //!
+    //! \brief StateKey Calculate key of the state from scratch. Needed only
+    //! for initial state, all the next ones are updated incrementally
+    //! \param balls balls on the board and their ids
+    //! \param holes open holes and their ids
+    //! \return state key
+    //!
+    template <typename CellsMap>
+    zobrist_key_t StateKey (const CellsMap & balls, const CellsMap & holes) const
+    {
+        zobrist_key_t key = 0;
+        for (const auto & ball : balls)
+        {
+            key ^= BallKey(ball.second, ball.first);
+        }
+        for (const auto & hole : holes)
+        {
+            key ^= HoleKey(hole.second);
+        }
+        return key;
+    }
+
+private:
+    //! \brief table_size_ size of game board
+    coordinate_t table_size_;
+
+    //! \brief ball_keys_ keys of balls, table_size_^2 keys for every ball
+    std::vector <zobrist_key_t> ball_keys_;
+
+    //! \brief hole_keys_ keys of open holes, indexed by hole id
+    std::vector <zobrist_key_t> hole_keys_;
+};
+
+#endif // TG_ZOBRIST_H
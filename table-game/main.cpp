@@ -30,14 +30,113 @@
  */
 
 #include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <memory>
 #include <string>
 #include <iostream>
 #include <getopt.h>
+#include <csignal>
 
 #include "tg_types.h"
 #include "file_ops.h"
 #include "input.h"
 #include "table.h"
+#include "batch.h"
+#include "corpus.h"
+#include "serve.h"
+#include "solver.h"
+#include "solution_dag.h"
+#include "packed_moves.h"
+#include "solve_service.h"
+#include "transposition_cache.h"
+#include "move_graph_cache.h"
+#include "tablebase.h"
+
+//! \brief Long options without short form
+enum LongOption
+{
+    CacheSizeOption = 256,
+    GraphVerifyOption,
+    BuildTablebaseOption,
+    SliceOption,
+    ScheduleOption,
+    TimingsOption,
+    VerifyOption,
+    DagOption,
+    BinaryOption
+};
+
+//! \brief running_service service to be stopped by signal
+static SolveService * running_service = NULL;
+
+//!
+//! \brief VerifyMoves Check moves sequence, or every line of standard input
+//! if sequence is "-", and print verification results
+//! \return 0 if every sequence wins
+//!
+int VerifyMoves (const InputData & data, const std::string & moves)
+{
+    std::ios_base::sync_with_stdio(false);
+    GameTable table (data);
+    int exit_code = 0;
+
+    auto verify = [&table, &exit_code] (const std::string & text)
+    {
+        std::vector <Direction> sequence;
+        if (!ParseMoves(text, sequence))
+        {
+            std::cout << "ERR Bad move in \"" << text << "\"\n";
+            exit_code = 1;
+            return;
+        }
+        GameTable::Verification verification = table.VerifyMoves(sequence);
+        if (verification.status != GameTable::Verification::Status::Won)
+        {
+            exit_code = 1;
+        }
+        std::cout << verification;
+    };
+
+    if (moves != "-")
+    {
+        verify(moves);
+        return exit_code;
+    }
+
+    std::string line;
+    while (std::getline(std::cin, line))
+    {
+        verify(line);
+    }
+    return exit_code;
+}
+
+void StopService (int)
+{
+    if (running_service != NULL)
+    {
+        running_service->Stop();
+    }
+}
+
+//!
+//! \brief ReportGraphCache Report validation of move graphs cache
+//! \param graph_cache move graphs cache, may be null
+//! \return exit code: 1 if validation found mismatching graphs
+//!
+int ReportGraphCache (const MoveGraphCache * graph_cache)
+{
+    if ((graph_cache == NULL) || !graph_cache->IsValidating())
+    {
+        return 0;
+    }
+
+    std::cerr << "Move graphs validated: " << graph_cache->GetLoads()
+              << ", mismatches: " << graph_cache->GetMismatches() << std::endl;
+    return (graph_cache->GetMismatches() == 0) ? 0 : 1;
+}
 
 void Usage (std::string program_name)
 {
@@ -54,6 +153,61 @@ void Usage (std::string program_name)
            "  -f, --file        File name containing input data\n"
            "  -h, --help        Display this help and exit\n"
            "  -d, --debug       Show debug output\n"
+           "  -b, --batch       File with puzzles separated by \"" << PUZZLE_DELIMITER << "\"\n"
+           "                    lines or directory with puzzle files to be solved\n"
+           "  -j, --jobs        Number of worker threads in batch mode, all\n"
+           "                    hardware threads by default\n"
+           "  -o, --ordered     Print batch results in input order instead of\n"
+           "                    order of completion\n"
+           "      --slice       Solve all the batch puzzles at once, switching\n"
+           "                    between them after given number of search states,\n"
+           "                    so short puzzles are not waiting for long ones\n"
+           "      --schedule    Order of solving batch puzzles by predicted\n"
+           "                    difficulty: \"sjf\" for shortest first, \"ljf\"\n"
+           "                    for longest first, \"input\" by default\n"
+           "      --timings     File to write predicted cost and actual solving\n"
+           "                    time of every batch puzzle to\n"
+           "      --verify      Check moves sequence like \"N W S E\" for the puzzle\n"
+           "                    given by --file instead of solving it. Prints\n"
+           "                    \"WON|LOST|INCOMPLETE <moves>\": moves to the win,\n"
+           "                    to the losing move or all of them. \"-\" checks\n"
+           "                    every line of standard input\n"
+           "      --dag         Print graph of all the best moves sequences of\n"
+           "                    the --file puzzle instead of the sequences: \"s\"\n"
+           "                    line per state and \"e <from> <to> <move>\" line per\n"
+           "                    move. Its size grows with states, not sequences\n"
+           "      --binary      Write best moves sequences of the --file puzzle\n"
+           "                    in binary form, 2 bits per move\n"
+           "  -s, --serve       Stay resident and solve puzzles read from standard\n"
+           "                    input, one \"<id> <coordinates>\" request per line.\n"
+           "                    One \"<id> OK|NONE|ERR ...\" line is written per request\n"
+           "  -l, --listen      Run local solve service on given Unix socket. Clients\n"
+           "                    use the same protocol as --serve. Workers count is\n"
+           "                    set by --jobs\n"
+           "  -q, --queue       Maximum number of puzzles being solved by service,\n"
+           "                    reading requests is paused above it. 1024 by default\n"
+           "  -c, --corpus      Convert puzzles given by --batch into binary\n"
+           "                    corpus file instead of solving them. Corpus can\n"
+           "                    be given to --batch later\n"
+           "  -C, --cache       Directory of solution cache. Solved puzzles are\n"
+           "                    stored there and taken from there next time.\n"
+           "                    Not used with --debug\n"
+           "      --cache-size  Maximum number of cached puzzles, 100000 by default.\n"
+           "                    Least recently used puzzles are removed first\n"
+           "  -G, --graph-cache Directory of move graphs cache. Graph of the board\n"
+           "                    is built once and loaded from there next time.\n"
+           "                    Used by --file and --batch\n"
+           "      --graph-verify  Rebuild graphs taken from --graph-cache and\n"
+           "                    compare them, mismatching graphs are replaced.\n"
+           "                    Number of mismatches is reported on stderr\n"
+           "  -t, --tablebase   Tablebase file of one board. Puzzles of --file and\n"
+           "                    --batch on its board are answered from it\n"
+           "      --build-tablebase  Build --tablebase for the board of --file\n"
+           "                    puzzle instead of solving it\n"
+           "  -T, --transpositions  File of states learned from puzzles of the same\n"
+           "                    board: table size, walls and holes. Search of --file\n"
+           "                    puzzle stops at known states, new states are saved\n"
+           "                    back. File of another board is replaced\n"
               << std::endl;
 }
 
@@ -65,17 +219,57 @@ int main(int argc, char *argv[])
         {"file",    required_argument, NULL, 'f'},
         {"help",    no_argument,       NULL, 'h'},
         {"debug",   no_argument,       NULL, 'd'},
+        {"batch",   required_argument, NULL, 'b'},
+        {"jobs",    required_argument, NULL, 'j'},
+        {"ordered", no_argument,       NULL, 'o'},
+        {"corpus",  required_argument, NULL, 'c'},
+        {"serve",   no_argument,       NULL, 's'},
+        {"listen",  required_argument, NULL, 'l'},
+        {"queue",   required_argument, NULL, 'q'},
+        {"cache",   required_argument, NULL, 'C'},
+        {"cache-size", required_argument, NULL, CacheSizeOption},
+        {"transpositions", required_argument, NULL, 'T'},
+        {"graph-cache", required_argument, NULL, 'G'},
+        {"graph-verify", no_argument,    NULL, GraphVerifyOption},
+        {"tablebase", required_argument, NULL, 't'},
+        {"build-tablebase", no_argument, NULL, BuildTablebaseOption},
+        {"slice",   required_argument, NULL, SliceOption},
+        {"schedule", required_argument, NULL, ScheduleOption},
+        {"timings", required_argument, NULL, TimingsOption},
+        {"verify",  required_argument, NULL, VerifyOption},
+        {"dag",     no_argument,       NULL, DagOption},
+        {"binary",  no_argument,       NULL, BinaryOption},
         {NULL, 0, NULL, 0}
     };
 
     bool parse_error = false;
     bool enable_debug = false;
+    bool serve = false;
     std::string filename;
+    std::string batch_path;
+    std::string corpus_path;
+    std::string socket_path;
+    size_t max_queue = 1024;
+    std::string cache_path;
+    size_t cache_size = 100000;
+    std::string transpositions_path;
+    std::string graph_cache_path;
+    bool graph_verify = false;
+    std::string tablebase_path;
+    bool build_tablebase = false;
+    size_t jobs = 0;
+    size_t slice = 0;
+    BatchSolver::Schedule schedule = BatchSolver::Schedule::Input;
+    std::string timings_path;
+    std::string verify_moves;
+    bool print_dag = false;
+    bool binary_output = false;
+    BatchSolver::Order order = BatchSolver::Order::Completion;
 
     while (1)
     {
         int long_index = 0;
-        int opt = getopt_long(argc, argv, "f:h:d", longopts, &long_index);
+        int opt = getopt_long(argc, argv, "f:h:db:j:oc:sl:q:C:T:G:t:", longopts, &long_index);
 
         if (opt == -1)
             break;	/* No more options */
@@ -89,6 +283,93 @@ int main(int argc, char *argv[])
             enable_debug = true;
             break;
 
+        case 'b':
+            batch_path = optarg;
+            break;
+
+        case 'j':
+            jobs = std::strtoul(optarg, NULL, 10);
+            break;
+
+        case 'o':
+            order = BatchSolver::Order::Input;
+            break;
+
+        case 'c':
+            corpus_path = optarg;
+            break;
+
+        case 's':
+            serve = true;
+            break;
+
+        case 'l':
+            socket_path = optarg;
+            break;
+
+        case 'q':
+            max_queue = std::strtoul(optarg, NULL, 10);
+            break;
+
+        case 'C':
+            cache_path = optarg;
+            break;
+
+        case 'T':
+            transpositions_path = optarg;
+            break;
+
+        case 'G':
+            graph_cache_path = optarg;
+            break;
+
+        case GraphVerifyOption:
+            graph_verify = true;
+            break;
+
+        case 't':
+            tablebase_path = optarg;
+            break;
+
+        case BuildTablebaseOption:
+            build_tablebase = true;
+            break;
+
+        case SliceOption:
+            slice = std::strtoul(optarg, NULL, 10);
+            break;
+
+        case ScheduleOption:
+            if (std::string(optarg) == "sjf")
+                schedule = BatchSolver::Schedule::ShortestFirst;
+            else if (std::string(optarg) == "ljf")
+                schedule = BatchSolver::Schedule::LongestFirst;
+            else if (std::string(optarg) == "input")
+                schedule = BatchSolver::Schedule::Input;
+            else
+                parse_error = true;
+            break;
+
+        case TimingsOption:
+            timings_path = optarg;
+            break;
+
+        case VerifyOption:
+            verify_moves = optarg;
+            break;
+
+        case DagOption:
+            print_dag = true;
+            break;
+
+        case BinaryOption:
+            binary_output = true;
+            break;
+
+        case CacheSizeOption:
+            cache_size = std::strtoul(optarg, NULL, 10);
+            break;
+
         case 'h':
         default:
             parse_error = true;
@@ -96,7 +377,14 @@ int main(int argc, char *argv[])
         }
     }
 
-    if (parse_error || filename.empty())
+    // exactly one of the modes must be chosen
+    int modes = (filename.empty() ? 0 : 1) + (batch_path.empty() ? 0 : 1) +
+                (serve ? 1 : 0) + (socket_path.empty() ? 0 : 1);
+    if (parse_error || (modes != 1) ||
+        (!corpus_path.empty() && batch_path.empty()) ||
+        (!transpositions_path.empty() && filename.empty()) ||
+        (graph_verify && graph_cache_path.empty()) ||
+        (build_tablebase && (tablebase_path.empty() || filename.empty())))
     {
         Usage(argv[0]);
         return 1;
@@ -104,8 +392,136 @@ int main(int argc, char *argv[])
 
     optind = 1;		/* reset 'extern optind' from the getopt lib */
 
-    FileInput fi (filename);
-    InputData data (fi.GetData());
+    std::unique_ptr <SolutionCache> cache;
+    if (!cache_path.empty() && !enable_debug)
+    {
+        cache.reset(new SolutionCache(cache_path, cache_size));
+        if (!cache->IsOpen())
+        {
+            std::cout << "Can not open cache " << cache_path << std::endl;
+            return 1;
+        }
+    }
+
+    std::unique_ptr <MoveGraphCache> graph_cache;
+    if (!graph_cache_path.empty())
+    {
+        graph_cache.reset(new MoveGraphCache(graph_cache_path, graph_verify));
+        if (!graph_cache->IsOpen())
+        {
+            std::cout << "Can not open graph cache " << graph_cache_path << std::endl;
+            return 1;
+        }
+    }
+
+    std::unique_ptr <Tablebase> tablebase;
+    if (!tablebase_path.empty() && !build_tablebase)
+    {
+        tablebase.reset(new Tablebase(tablebase_path));
+        if (Tablebase::Status::Ok != tablebase->GetStatus())
+        {
+            std::cout << "Can not read tablebase " << tablebase_path << std::endl;
+            return 1;
+        }
+    }
+
+    std::ofstream timings;
+    if (!timings_path.empty())
+    {
+        timings.open(timings_path);
+        if (!timings)
+        {
+            std::cout << "Can not write timings " << timings_path << std::endl;
+            return 1;
+        }
+    }
+
+    if (!socket_path.empty())
+    {
+        SolveService service (socket_path, jobs, max_queue, cache.get());
+        if (!service.Start())
+        {
+            std::cout << "Can not listen on " << socket_path << std::endl;
+            return 1;
+        }
+
+        running_service = &service;
+        signal(SIGINT, StopService);
+        signal(SIGTERM, StopService);
+        service.Run();
+        running_service = NULL;
+        return 0;
+    }
+
+    if (serve)
+    {
+        std::ios_base::sync_with_stdio(false);
+        std::cin.tie(NULL);
+        Serve(std::cin, std::cout, cache.get());
+        return 0;
+    }
+
+    if (!batch_path.empty() && CorpusReader::IsCorpus(batch_path))
+    {
+        CorpusReader corpus (batch_path);
+        if (CorpusReader::Status::Ok != corpus.GetStatus())
+        {
+            std::cout << "Can not read corpus " << batch_path << std::endl;
+            return 1;
+        }
+
+        BatchSolver solver (jobs, order);
+        solver.SetCache(cache.get());
+        solver.SetMoveGraphCache(graph_cache.get());
+        solver.SetTablebase(tablebase.get());
+        solver.SetTimeSlice(slice);
+        solver.SetSchedule(schedule);
+        solver.SetTimingReport(timings_path.empty() ? NULL : &timings);
+        solver.Solve(corpus, std::cout);
+        return ReportGraphCache(graph_cache.get());
+    }
+
+    if (!batch_path.empty())
+    {
+        puzzles_t puzzles;
+        if (!ReadPuzzles(batch_path, puzzles))
+        {
+            std::cout << "Can not read puzzles from " << batch_path << std::endl;
+            return 1;
+        }
+
+        if (!corpus_path.empty())
+        {
+            CorpusWriter writer;
+            for (const auto & puzzle : puzzles)
+            {
+                InputData puzzle_data (puzzle.data);
+                if (!writer.Add(puzzle_data))
+                {
+                    std::cout << "Puzzle " << puzzle.id << " skipped: "
+                              << puzzle_data.GetErrorString() << std::endl;
+                }
+            }
+            if (!writer.Save(corpus_path))
+            {
+                std::cout << "Can not write corpus " << corpus_path << std::endl;
+                return 1;
+            }
+            return 0;
+        }
+
+        BatchSolver solver (jobs, order);
+        solver.SetCache(cache.get());
+        solver.SetMoveGraphCache(graph_cache.get());
+        solver.SetTablebase(tablebase.get());
+        solver.SetTimeSlice(slice);
+        solver.SetSchedule(schedule);
+        solver.SetTimingReport(timings_path.empty() ? NULL : &timings);
+        solver.Solve(puzzles, std::cout);
+        return ReportGraphCache(graph_cache.get());
+    }
+
+    InputData data (ReadInputData(filename));
 
     if (InputData::Status::Ok != data.GetDataStatus())
     {
@@ -113,15 +529,89 @@ int main(int argc, char *argv[])
         return 1;
     }
 
-    GameTable t(data);
+    if (build_tablebase)
+    {
+        if (!Tablebase::Build(data, tablebase_path))
+        {
+            std::cout << "Can not build tablebase " << tablebase_path << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    if (!verify_moves.empty())
+    {
+        return VerifyMoves(data, verify_moves);
+    }
+
+    if (print_dag)
+    {
+        std::cout << SolutionDag(data);
+        return 0;
+    }
+
+    GameTable t(data, cache.get(), graph_cache.get());
+    if (tablebase && tablebase->Matches(data))
+    {
+        t.SetTablebase(tablebase.get());
+    }
+
+    std::unique_ptr <TranspositionCache> transpositions;
+    if (!transpositions_path.empty())
+    {
+        // missing file or file of another board gives empty cache
+        transpositions.reset(new TranspositionCache(data));
+        transpositions->Load(transpositions_path);
+        t.SetTranspositionCache(transpositions.get());
+    }
+
     t.CalculateMoves();
 
+    if (transpositions && !transpositions->Save(transpositions_path))
+    {
+        std::cout << "Can not write " << transpositions_path << std::endl;
+    }
+
     if (enable_debug)
     {
         std::cout << t;
+        const GameTable::PruningStats & pruning = t.GetPruningStats();
+        std::cout << "Pruned moves: repeated " << pruning.repeated
+                  << ", null " << pruning.null_moves
+                  << ", reversed " << pruning.reversed
+                  << ", revisited " << pruning.revisited
+                  << ", hopeless " << pruning.hopeless
+                  << ", bounded " << pruning.bounded << std::endl;
+        if (t.GetUpperBound() != std::numeric_limits <size_t>::max())
+        {
+            std::cout << "Upper bound: " << t.GetUpperBound() << " moves";
+            if (!t.GetMoves().empty())
+            {
+                std::cout << ", " << t.GetUpperBound() - t.GetMoves().front().size()
+                          << " above the best";
+            }
+            std::cout << std::endl;
+        }
+        std::cout << "Forced hole order:";
+        for (const auto & forced : t.GetForcedOrder())
+        {
+            std::cout << " " << forced.first << "<" << forced.second;
+        }
+        std::cout << std::endl;
+        if (t.GetUnsolvability().reason != SolvabilityCheck::Reason::None)
+        {
+            std::cout << t.GetUnsolvability() << std::endl;
+        }
     }
 
-    t.PrintMoves(std::cout);
+    if (binary_output)
+    {
+        WriteBinaryMoves(std::cout, t.GetMoves());
+    }
+    else
+    {
+        t.PrintMoves(std::cout);
+    }
 
-    return 0;
+    return ReportGraphCache(graph_cache.get());
 }
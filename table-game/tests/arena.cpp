@@ -0,0 +1,85 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "TG_arena"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <list>
+#include <map>
+
+#include "arena.h"
+
+BOOST_AUTO_TEST_CASE( allocate_and_release )
+{
+    Arena arena (128);
+
+    void * first = arena.Allocate(10, 1);
+    void * aligned = arena.Allocate(8, 8);
+    BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(aligned) % 8, 0);
+    BOOST_CHECK(arena.GetUsed() >= 18);
+
+    // bigger than chunk
+    void * big = arena.Allocate(1000, 16);
+    BOOST_CHECK(big != nullptr);
+    BOOST_CHECK(arena.GetReserved() >= 1128);
+
+    size_t reserved = arena.GetReserved();
+    arena.Release();
+    BOOST_CHECK_EQUAL(arena.GetUsed(), 0);
+    BOOST_CHECK_EQUAL(arena.GetReserved(), reserved);
+
+    // memory is reused after release
+    BOOST_CHECK_EQUAL(arena.Allocate(10, 1), first);
+}
+
+BOOST_AUTO_TEST_CASE( current_arena )
+{
+    Arena arena;
+    BOOST_CHECK(Arena::GetCurrent() == nullptr);
+    {
+        Arena::Scope scope (&arena);
+        BOOST_CHECK(Arena::GetCurrent() == &arena);
+        {
+            Arena::Scope heap (nullptr);
+            BOOST_CHECK(Arena::GetCurrent() == nullptr);
+        }
+        BOOST_CHECK(Arena::GetCurrent() == &arena);
+    }
+    BOOST_CHECK(Arena::GetCurrent() == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE( containers )
+{
+    using arena_map_t = std::map <int, int, std::less<int>,
+                                  ArenaAllocator <std::pair <const int, int> > >;
+    using arena_list_t = std::list <arena_map_t, ArenaAllocator <arena_map_t> >;
+
+    Arena first;
+    Arena second;
+
+    Arena::Scope scope (&first);
+    arena_list_t list;
+    list.emplace_back();
+    list.back()[1] = 1;
+    list.back()[2] = 2;
+    BOOST_CHECK(list.get_allocator().GetArena() == &first);
+    BOOST_CHECK(first.GetUsed() > 0);
+
+    // copies are placed in current arena
+    size_t used = first.GetUsed();
+    {
+        Arena::Scope copy_scope (&second);
+        arena_list_t copy (list);
+        BOOST_CHECK(copy.get_allocator().GetArena() == &second);
+        BOOST_CHECK(copy.back().get_allocator().GetArena() == &second);
+        BOOST_CHECK_EQUAL(copy.back().at(2), 2);
+        BOOST_CHECK(second.GetUsed() > 0);
+    }
+    BOOST_CHECK_EQUAL(first.GetUsed(), used);
+
+    // moved container keeps its arena
+    ArenaAllocator <arena_map_t> second_allocator (&second);
+    arena_list_t moved (second_allocator);
+    moved = std::move(list);
+    BOOST_CHECK(moved.get_allocator().GetArena() == &first);
+}
@@ -0,0 +1,122 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "TG_async_solve"
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <vector>
+
+#include "async_solve.h"
+#include "solver.h"
+#include "table.h"
+#include "thread_pool.h"
+#include "tests_config.h"
+
+BOOST_AUTO_TEST_CASE( cancel_search )
+{
+    InputData in (sample);
+    std::atomic <bool> cancel (true);
+
+    GameTable table (in);
+    table.SetCancelFlag(&cancel);
+    table.CalculateMoves();
+    BOOST_CHECK(table.IsCancelled());
+    BOOST_CHECK(table.GetMoves().empty());
+
+    // same table can be used again once flag is cleared
+    cancel = false;
+    table.CalculateMoves();
+    BOOST_CHECK(!table.IsCancelled());
+    BOOST_CHECK(!table.GetMoves().empty());
+}
+
+BOOST_AUTO_TEST_CASE( progress_reports )
+{
+    InputData in (sample);
+    GameTable expected (in);
+    expected.CalculateMoves();
+
+    std::vector <GameTable::Progress> reports;
+    GameTable table (in);
+    table.SetProgressCallback([&reports] (const GameTable::Progress & progress)
+                              {
+                                  reports.push_back(progress);
+                              },
+                              std::chrono::milliseconds(0));
+    table.CalculateMoves();
+    BOOST_CHECK(table.GetMoves() == expected.GetMoves());
+
+    // every layer is reported with zero interval
+    BOOST_REQUIRE(!reports.empty());
+    BOOST_CHECK_EQUAL(reports.front().depth, 0u);
+    BOOST_CHECK_EQUAL(reports.front().frontier, 1u);
+    BOOST_CHECK(reports.back().depth + 1 >= expected.GetMoves().front().size());
+    for (size_t i=1; i<reports.size(); ++i)
+    {
+        BOOST_CHECK(reports[i].depth >= reports[i - 1].depth);
+        BOOST_CHECK(reports[i].visited >= reports[i - 1].visited);
+    }
+
+    // and cancelling from callback stops the search
+    std::atomic <bool> cancel (false);
+    GameTable cancelled (in);
+    cancelled.SetCancelFlag(&cancel);
+    cancelled.SetProgressCallback([&cancel] (const GameTable::Progress & progress)
+                                  {
+                                      if (progress.depth == 2)
+                                      {
+                                          cancel = true;
+                                      }
+                                  },
+                                  std::chrono::milliseconds(0));
+    cancelled.CalculateMoves();
+    BOOST_CHECK(cancelled.IsCancelled());
+    BOOST_CHECK(cancelled.GetMoves().empty());
+}
+
+BOOST_AUTO_TEST_CASE( solve_async )
+{
+    ThreadPool pool (2);
+    std::atomic <int> done (0);
+
+    AsyncSolveOptions options = AsyncSolveOptions();
+    options.done = [&done] (const SolveResult & result)
+    {
+        if (result.status == SolveResult::Status::Solved)
+        {
+            ++done;
+        }
+    };
+
+    SolveHandle handle = SolveAsync(pool, sample, &options);
+    BOOST_REQUIRE(handle.IsValid());
+    const SolveResult & result = handle.Get();
+    BOOST_CHECK(handle.IsDone());
+    BOOST_CHECK(result.status == SolveResult::Status::Solved);
+    BOOST_CHECK(result.moves == SolvePuzzle(sample).moves);
+
+    pool.Wait();
+    BOOST_CHECK_EQUAL(done.load(), 1);
+    BOOST_CHECK(!SolveHandle().IsValid());
+}
+
+BOOST_AUTO_TEST_CASE( cancel_async )
+{
+    ThreadPool pool (1);
+
+    // keep the only worker busy until puzzle is cancelled
+    std::promise <void> release;
+    std::shared_future <void> released = release.get_future().share();
+    pool.Submit([released] () { released.wait(); });
+
+    SolveHandle handle = SolveAsync(pool, sample);
+    BOOST_CHECK(!handle.WaitFor(std::chrono::milliseconds(10)));
+    handle.Cancel();
+    release.set_value();
+
+    BOOST_CHECK(handle.WaitFor(std::chrono::seconds(10)));
+    BOOST_CHECK(handle.Get().status == SolveResult::Status::Cancelled);
+    BOOST_CHECK(handle.Get().moves.empty());
+}
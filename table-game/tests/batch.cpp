@@ -0,0 +1,111 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "TG_batch"
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <sstream>
+
+#include "batch.h"
+#include "solver.h"
+#include "thread_pool.h"
+#include "tests_config.h"
+
+BOOST_AUTO_TEST_CASE( thread_pool )
+{
+    std::atomic <int> counter (0);
+    ThreadPool pool (4);
+    BOOST_CHECK_EQUAL(pool.GetWorkersCount(), 4u);
+
+    for (int i=0; i<100; ++i)
+    {
+        pool.Submit([&counter] () { ++counter; });
+    }
+    pool.Wait();
+    BOOST_CHECK_EQUAL(counter.load(), 100);
+}
+
+BOOST_AUTO_TEST_CASE( split_puzzles )
+{
+    std::string text ("4 2 2\n---\n\n  ---  \n5 1 0\r\n---\n3 0 0\n");
+    puzzles_t puzzles;
+
+    SplitPuzzles(text.data(), text.data() + text.size(), "", puzzles);
+    BOOST_REQUIRE_EQUAL(puzzles.size(), 3u);
+    BOOST_CHECK_EQUAL(puzzles[0].id, "1");
+    BOOST_CHECK_EQUAL(puzzles[2].id, "3");
+    input_data_t expected {5, 1, 0};
+    BOOST_CHECK_EQUAL_COLLECTIONS(expected.begin(), expected.end(),
+                                  puzzles[1].data.begin(), puzzles[1].data.end());
+
+    puzzles.clear();
+    SplitPuzzles(text.data(), text.data() + 6, "file", puzzles);
+    BOOST_REQUIRE_EQUAL(puzzles.size(), 1u);
+    BOOST_CHECK_EQUAL(puzzles[0].id, "file");
+}
+
+BOOST_AUTO_TEST_CASE( read_directory )
+{
+    puzzles_t puzzles;
+
+    BOOST_CHECK(ReadPuzzles(SAMPLES_DIR, puzzles));
+    BOOST_REQUIRE_EQUAL(puzzles.size(), 6u);
+    BOOST_CHECK_EQUAL(puzzles[0].id, "sample_1.txt");
+    BOOST_CHECK_EQUAL(puzzles[5].id, "sample_6.txt");
+
+    BOOST_CHECK(!ReadPuzzles(SAMPLES_DIR "/missing", puzzles));
+}
+
+BOOST_AUTO_TEST_CASE( solve_ordered )
+{
+    puzzles_t puzzles;
+    BOOST_REQUIRE(ReadPuzzles(SAMPLES_DIR, puzzles));
+    puzzles.push_back(Puzzle{"invalid", input_data_t {4, 1, 0, 0, 1}});
+
+    std::ostringstream expected;
+    for (const auto & puzzle : puzzles)
+    {
+        expected << "# " << puzzle.id << "\n" << SolvePuzzle(puzzle.data);
+    }
+
+    std::ostringstream output;
+    BatchSolver solver (3, BatchSolver::Order::Input);
+    solver.Solve(puzzles, output);
+    BOOST_CHECK_EQUAL(output.str(), expected.str());
+
+    // same results in any order
+    std::ostringstream completion;
+    BatchSolver unordered (3, BatchSolver::Order::Completion);
+    unordered.Solve(puzzles, completion);
+    BOOST_CHECK_EQUAL(completion.str().size(), expected.str().size());
+}
+
+BOOST_AUTO_TEST_CASE( solve_result )
+{
+    SolveResult solved = SolvePuzzle(sample);
+    BOOST_CHECK(solved.status == SolveResult::Status::Solved);
+    BOOST_CHECK(!solved.moves.empty());
+
+    SolveResult invalid = SolvePuzzle(input_data_t {4, 1, 0, 0, 1});
+    BOOST_CHECK(invalid.status == SolveResult::Status::InvalidInput);
+    BOOST_CHECK(!invalid.error.empty());
+}
+
+BOOST_AUTO_TEST_CASE( parse_moves )
+{
+    std::vector <Direction> moves;
+    BOOST_CHECK(ParseMoves("N W\tS E \n", moves));
+    BOOST_CHECK(moves == (std::vector <Direction> {Direction::North, Direction::West,
+                                                   Direction::South, Direction::East}));
+
+    moves.clear();
+    BOOST_CHECK(ParseMoves("NWSE", moves));
+    BOOST_CHECK_EQUAL(moves.size(), 4);
+
+    BOOST_CHECK(!ParseMoves("N X", moves));
+
+    GameTable::Verification verification = {GameTable::Verification::Status::Lost, 3};
+    std::ostringstream os;
+    os << verification;
+    BOOST_CHECK_EQUAL(os.str(), "LOST 3\n");
+}
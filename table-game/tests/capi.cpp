@@ -0,0 +1,187 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "TG_capi"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "table_game.h"
+#include "tests_config.h"
+
+namespace
+{
+
+const std::string sample_text = "4 2 2  2 2 1 4  1 1 4 3  1 2 1 3  3 2 4 2\n";
+
+//! \brief All the sequences of result, one after another
+std::vector <uint8_t> AllMoves (const tg_result * result)
+{
+    size_t length = tg_result_length(result);
+    std::vector <uint8_t> moves (tg_result_count(result) * length);
+    for (size_t i=0; i<tg_result_count(result); ++i)
+    {
+        size_t written = 0;
+        BOOST_REQUIRE_EQUAL(tg_result_get(result, i, moves.data() + i * length,
+                                          length, &written), TG_OK);
+        BOOST_CHECK_EQUAL(written, length);
+    }
+    return moves;
+}
+
+}
+
+BOOST_AUTO_TEST_CASE( solve_board )
+{
+    BOOST_CHECK_EQUAL(tg_api_version(), TG_API_VERSION);
+
+    tg_board * board = nullptr;
+    BOOST_REQUIRE_EQUAL(tg_board_create(sample_text.data(), sample_text.size(),
+                                        &board, nullptr, 0), TG_OK);
+
+    tg_result * result = nullptr;
+    BOOST_REQUIRE_EQUAL(tg_solve(board, nullptr, &result), TG_OK);
+    BOOST_CHECK_EQUAL(tg_result_status(result), TG_OK);
+    BOOST_CHECK(tg_result_count(result) > 0);
+    BOOST_CHECK(tg_result_length(result) > 0);
+    std::vector <uint8_t> moves = AllMoves(result);
+    for (auto move : moves)
+    {
+        BOOST_CHECK(move <= TG_EAST);
+    }
+
+    // board given by numbers is the same puzzle
+    tg_board * same = nullptr;
+    BOOST_REQUIRE_EQUAL(tg_board_create_from_values(sample.data(), sample.size(),
+                                                    &same, nullptr, 0), TG_OK);
+    tg_result * same_result = nullptr;
+    BOOST_REQUIRE_EQUAL(tg_solve(same, nullptr, &same_result), TG_OK);
+    BOOST_CHECK(AllMoves(same_result) == moves);
+
+    tg_result_free(same_result);
+    tg_result_free(result);
+    tg_board_free(same);
+    tg_board_free(board);
+}
+
+BOOST_AUTO_TEST_CASE( invalid_input )
+{
+    char error[16];
+    tg_board * board = nullptr;
+
+    const std::string garbage = "4 2 x";
+    BOOST_CHECK_EQUAL(tg_board_create(garbage.data(), garbage.size(), &board,
+                                      error, sizeof(error)), TG_INVALID_INPUT);
+    BOOST_CHECK(board == nullptr);
+    BOOST_CHECK(std::strlen(error) < sizeof(error));
+
+    const std::string short_data = "4 2 2 2 2";
+    BOOST_CHECK_EQUAL(tg_board_create(short_data.data(), short_data.size(),
+                                      &board, error, sizeof(error)),
+                      TG_INVALID_INPUT);
+    BOOST_CHECK(board == nullptr);
+
+    BOOST_CHECK_EQUAL(tg_board_create(nullptr, 1, &board, nullptr, 0),
+                      TG_INVALID_ARGUMENT);
+    BOOST_CHECK_EQUAL(tg_solve(nullptr, nullptr, nullptr), TG_INVALID_ARGUMENT);
+    BOOST_CHECK(std::string(tg_status_string(TG_NO_SOLUTION)).size() > 0);
+}
+
+BOOST_AUTO_TEST_CASE( caller_buffers )
+{
+    tg_board * board = nullptr;
+    BOOST_REQUIRE_EQUAL(tg_board_create(sample_text.data(), sample_text.size(),
+                                        &board, nullptr, 0), TG_OK);
+    tg_result * result = nullptr;
+    BOOST_REQUIRE_EQUAL(tg_solve(board, nullptr, &result), TG_OK);
+
+    // required size is reported when buffer is too small
+    size_t length = 0;
+    BOOST_CHECK_EQUAL(tg_result_get(result, 0, nullptr, 0, &length),
+                      TG_BUFFER_TOO_SMALL);
+    BOOST_CHECK_EQUAL(length, tg_result_length(result));
+
+    std::vector <uint8_t> moves (length);
+    BOOST_CHECK_EQUAL(tg_result_get(result, tg_result_count(result),
+                                    moves.data(), moves.size(), &length),
+                      TG_OUT_OF_RANGE);
+
+    tg_result_free(result);
+    tg_board_free(board);
+}
+
+BOOST_AUTO_TEST_CASE( search_limits )
+{
+    tg_board * board = nullptr;
+    BOOST_REQUIRE_EQUAL(tg_board_create(sample_text.data(), sample_text.size(),
+                                        &board, nullptr, 0), TG_OK);
+    tg_result * result = nullptr;
+    BOOST_REQUIRE_EQUAL(tg_solve(board, nullptr, &result), TG_OK);
+    size_t best = tg_result_length(result);
+    std::vector <uint8_t> moves = AllMoves(result);
+    tg_result_free(result);
+
+    tg_options options;
+    tg_options_init(&options);
+    options.max_moves = best - 1;
+    BOOST_CHECK_EQUAL(tg_solve(board, &options, &result), TG_LIMIT_REACHED);
+    BOOST_CHECK_EQUAL(tg_result_count(result), 0);
+    tg_result_free(result);
+
+    options.max_moves = best;
+    BOOST_CHECK_EQUAL(tg_solve(board, &options, &result), TG_OK);
+    BOOST_CHECK(AllMoves(result) == moves);
+    tg_result_free(result);
+
+    options.max_moves = 0;
+    options.max_states = 1;
+    BOOST_CHECK_EQUAL(tg_solve(board, &options, &result), TG_LIMIT_REACHED);
+    tg_result_free(result);
+
+    // tablebase algorithm needs tablebase
+    tg_options_init(&options);
+    options.algorithm = TG_ALGORITHM_TABLEBASE;
+    BOOST_CHECK_EQUAL(tg_solve(board, &options, &result), TG_INVALID_ARGUMENT);
+    BOOST_CHECK(result == nullptr);
+
+    // older callers pass shorter options, missing fields are defaults
+    tg_options_init(&options);
+    options.size = offsetof(tg_options, threads);
+    options.max_moves = 1;
+    BOOST_CHECK_EQUAL(tg_solve(board, &options, &result), TG_OK);
+    tg_result_free(result);
+
+    options.size = 0;
+    BOOST_CHECK_EQUAL(tg_solve(board, &options, &result), TG_INVALID_ARGUMENT);
+
+    tg_board_free(board);
+}
+
+BOOST_AUTO_TEST_CASE( solve_batch )
+{
+    tg_board * board = nullptr;
+    BOOST_REQUIRE_EQUAL(tg_board_create(sample_text.data(), sample_text.size(),
+                                        &board, nullptr, 0), TG_OK);
+    tg_result * single = nullptr;
+    BOOST_REQUIRE_EQUAL(tg_solve(board, nullptr, &single), TG_OK);
+
+    const size_t count = 8;
+    std::vector <const tg_board *> boards (count, board);
+    std::vector <tg_result *> results (count, nullptr);
+    tg_options options;
+    tg_options_init(&options);
+    options.threads = 3;
+    BOOST_REQUIRE_EQUAL(tg_solve_batch(boards.data(), count, &options,
+                                       results.data()), TG_OK);
+    for (auto result : results)
+    {
+        BOOST_CHECK_EQUAL(tg_result_status(result), TG_OK);
+        BOOST_CHECK(AllMoves(result) == AllMoves(single));
+        tg_result_free(result);
+    }
+
+    tg_result_free(single);
+    tg_board_free(board);
+}
@@ -0,0 +1,97 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "TG_corpus"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "corpus.h"
+#include "tg_utils.h"
+#include "tests_config.h"
+#include "test_files.h"
+
+BOOST_AUTO_TEST_CASE( write_and_read )
+{
+    std::string filename (TempFile("tg_corpus_test"));
+    InputData first (sample);
+    InputData second (input_data_t {200, 1, 1, 150, 199, 1, 200, 7, 7, 7, 8});
+
+    CorpusWriter writer;
+    BOOST_CHECK(writer.Add(first));
+    BOOST_CHECK(writer.Add(second));
+    BOOST_CHECK(!writer.Add(InputData(input_data_t {4, 1, 0, 0, 1})));
+    BOOST_CHECK_EQUAL(writer.GetCount(), 2u);
+    BOOST_REQUIRE(writer.Save(filename));
+    BOOST_CHECK(!writer.Save(filename + ".missing/corpus"));
+
+    BOOST_CHECK(CorpusReader::IsCorpus(filename));
+    BOOST_CHECK(!CorpusReader::IsCorpus(SAMPLE_FILE));
+
+    CorpusReader reader (filename);
+    BOOST_REQUIRE(CorpusReader::Status::Ok == reader.GetStatus());
+    BOOST_REQUIRE_EQUAL(reader.GetCount(), 2u);
+
+    const InputData * expected[] = { &first, &second };
+    for (size_t i=0; i<2; ++i)
+    {
+        InputData read = reader.GetPuzzle(i);
+        BOOST_CHECK(InputData::Status::Ok == read.GetDataStatus());
+        BOOST_CHECK_EQUAL(read.GetTableSize(), expected[i]->GetTableSize());
+        BOOST_CHECK_EQUAL_COLLECTIONS(read.GetBalls().begin(), read.GetBalls().end(),
+                                      expected[i]->GetBalls().begin(),
+                                      expected[i]->GetBalls().end());
+        BOOST_CHECK_EQUAL_COLLECTIONS(read.GetHoles().begin(), read.GetHoles().end(),
+                                      expected[i]->GetHoles().begin(),
+                                      expected[i]->GetHoles().end());
+        BOOST_CHECK(read.GetWalls() == expected[i]->GetWalls());
+    }
+
+    BOOST_CHECK(InputData::Status::Ok != reader.GetPuzzle(2).GetDataStatus());
+    std::remove(filename.c_str());
+}
+
+BOOST_AUTO_TEST_CASE( damaged_corpus )
+{
+    std::string filename (TempFile("tg_corpus_test"));
+    BOOST_CHECK(CorpusReader::Status::CannotOpen ==
+                CorpusReader(filename + ".missing").GetStatus());
+    BOOST_CHECK(CorpusReader::Status::InvalidHeader ==
+                CorpusReader(SAMPLE_FILE).GetStatus());
+
+    CorpusWriter writer;
+    writer.Add(InputData(sample));
+    BOOST_REQUIRE(writer.Save(filename));
+
+    // cut the last record
+    std::ifstream in (filename, std::ios_base::binary);
+    std::string contents ((std::istreambuf_iterator <char> (in)),
+                          std::istreambuf_iterator <char> ());
+    in.close();
+    std::ofstream out (filename, std::ios_base::binary | std::ios_base::trunc);
+    out.write(contents.data(), contents.size() - 3);
+    out.close();
+
+    CorpusReader reader (filename);
+    BOOST_REQUIRE(CorpusReader::Status::Ok == reader.GetStatus());
+    BOOST_CHECK(InputData::Status::IncompliteData == reader.GetPuzzle(0).GetDataStatus());
+
+    // walls count 0x80000000 fits the record once doubled in 32 bits
+    std::string header (contents, 0, 16);
+    const unsigned char offsets[] = {1, 0, 0, 0, 0, 0, 0, 0,
+                                     40, 0, 0, 0, 0, 0, 0, 0,
+                                     51, 0, 0, 0, 0, 0, 0, 0};
+    const unsigned char record[] = {4, 1, 0x80, 0x80, 0x80, 0x80, 0x08,
+                                    1, 2, 3, 4};
+    out.open(filename, std::ios_base::binary | std::ios_base::trunc);
+    out.write(header.data(), header.size());
+    out.write(reinterpret_cast <const char*> (offsets), sizeof(offsets));
+    out.write(reinterpret_cast <const char*> (record), sizeof(record));
+    out.close();
+
+    CorpusReader huge (filename);
+    BOOST_REQUIRE(CorpusReader::Status::Ok == huge.GetStatus());
+    BOOST_CHECK(InputData::Status::Ok != huge.GetPuzzle(0).GetDataStatus());
+    std::remove(filename.c_str());
+}
@@ -0,0 +1,82 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "TG_difficulty"
+
+#include <boost/test/unit_test.hpp>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "batch.h"
+#include "difficulty.h"
+#include "tests_config.h"
+
+namespace
+{
+
+//! \brief One ball one move away from its hole
+const input_data_t short_puzzle = { 4, 1, 0, 1, 1, 1, 2 };
+
+}
+
+BOOST_AUTO_TEST_CASE( estimate )
+{
+    Difficulty hard = EstimateDifficulty(InputData(sample));
+    BOOST_CHECK(hard.cost > 0);
+    BOOST_CHECK(hard.tree.states >= 1);
+    BOOST_CHECK(hard.tree.depth > 0);
+
+    // same puzzle gets the same estimate
+    Difficulty again = EstimateDifficulty(InputData(sample));
+    BOOST_CHECK_EQUAL(again.cost, hard.cost);
+
+    Difficulty easy = EstimateDifficulty(InputData(short_puzzle));
+    BOOST_CHECK_EQUAL(easy.balls, 1);
+    BOOST_CHECK(easy.cost > 0);
+    BOOST_CHECK(easy.cost < hard.cost);
+
+    Difficulty invalid = EstimateDifficulty(InputData(input_data_t {4, 1, 0, 0, 1}));
+    BOOST_CHECK_EQUAL(invalid.cost, 0);
+}
+
+BOOST_AUTO_TEST_CASE( rank_correlation )
+{
+    BOOST_CHECK_CLOSE(RankCorrelation({1, 2, 3}, {10, 50, 60}), 1.0, 1e-9);
+    BOOST_CHECK_CLOSE(RankCorrelation({1, 2, 3}, {3, 2, 1}), -1.0, 1e-9);
+    BOOST_CHECK_CLOSE(RankCorrelation({1, 1, 2}, {1, 1, 2}), 1.0, 1e-9);
+    BOOST_CHECK_EQUAL(RankCorrelation({1, 1}, {1, 2}), 0);
+    BOOST_CHECK_EQUAL(RankCorrelation({1}, {1}), 0);
+}
+
+BOOST_AUTO_TEST_CASE( scheduled_batch )
+{
+    puzzles_t puzzles = { {"hard", sample}, {"easy", short_puzzle} };
+
+    // single worker prints results in solving order
+    std::ostringstream shortest;
+    std::ostringstream report;
+    BatchSolver sjf (1, BatchSolver::Order::Completion);
+    sjf.SetSchedule(BatchSolver::Schedule::ShortestFirst);
+    sjf.SetTimingReport(&report);
+    sjf.Solve(puzzles, shortest);
+    BOOST_CHECK_EQUAL(shortest.str().find("# easy"), 0);
+
+    std::string line;
+    std::vector <std::string> lines;
+    std::istringstream report_lines (report.str());
+    while (std::getline(report_lines, line))
+    {
+        lines.push_back(line);
+    }
+    BOOST_REQUIRE_EQUAL(lines.size(), 3);
+    BOOST_CHECK_EQUAL(lines[0].find("hard "), 0);
+    BOOST_CHECK_EQUAL(lines[1].find("easy "), 0);
+    BOOST_CHECK_EQUAL(lines[2].find("# rank correlation"), 0);
+
+    std::ostringstream longest;
+    BatchSolver ljf (1, BatchSolver::Order::Completion);
+    ljf.SetSchedule(BatchSolver::Schedule::LongestFirst);
+    ljf.Solve(puzzles, longest);
+    BOOST_CHECK_EQUAL(longest.str().find("# hard"), 0);
+    BOOST_CHECK_EQUAL(longest.str().size(), shortest.str().size());
+}
@@ -4,7 +4,9 @@
 #include <boost/test/unit_test.hpp>
 
 #include "file_ops.h"
+#include "input.h"
 #include "tests_config.h"
+#include "tg_utils.h"
 
 
 BOOST_AUTO_TEST_CASE( input_data )
@@ -17,3 +19,59 @@ BOOST_AUTO_TEST_CASE( input_data )
     BOOST_CHECK_EQUAL_COLLECTIONS(sample.begin(), sample.end(), data.begin(), data.end());
 
 }
+
+BOOST_AUTO_TEST_CASE( mapped_input_data )
+{
+    std::string sample_file (SAMPLE_FILE);
+
+    InputData streamed (FileInput(sample_file).GetData());
+    InputData mapped = ReadInputData(sample_file);
+
+    BOOST_CHECK(mapped.GetDataStatus() == streamed.GetDataStatus());
+    BOOST_CHECK_EQUAL(mapped.GetTableSize(), streamed.GetTableSize());
+    BOOST_CHECK(mapped.GetBalls() == streamed.GetBalls());
+    BOOST_CHECK(mapped.GetHoles() == streamed.GetHoles());
+    BOOST_CHECK(mapped.GetWalls() == streamed.GetWalls());
+}
+
+BOOST_AUTO_TEST_CASE( parse_coordinates )
+{
+    std::string text (" 4 2\n\t1 10\r\n4294967295 7x 8");
+    input_data_t data;
+
+    const char * stop = ParseCoordinates(text.data(), text.data() + text.size(), data);
+
+    input_data_t expected {4, 2, 1, 10, 4294967295, 7};
+    BOOST_CHECK_EQUAL_COLLECTIONS(expected.begin(), expected.end(), data.begin(), data.end());
+    BOOST_CHECK_EQUAL(*stop, 'x');
+
+    std::string overflow ("3 4294967296");
+    data.clear();
+    ParseCoordinates(overflow.data(), overflow.data() + overflow.size(), data);
+    BOOST_CHECK_EQUAL(data.size(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE( parse_input_data )
+{
+    InputData expected (sample);
+    InputData read = ReadInputData(SAMPLE_FILE);
+    BOOST_CHECK(read.GetDataStatus() == InputData::Status::Ok);
+    BOOST_CHECK_EQUAL(read.GetTableSize(), expected.GetTableSize());
+    BOOST_CHECK(read.GetBalls() == expected.GetBalls());
+    BOOST_CHECK(read.GetHoles() == expected.GetHoles());
+    BOOST_CHECK(read.GetWalls() == expected.GetWalls());
+
+    // statuses are the ones of coordinates decoded by InputData
+    std::vector <std::string> texts {"4 1", "4 1 0 1 1 2", "4 1 0 1 1 2 2 3",
+                                     "4 0 0", "4 1 0 1 1 5 2", "4 1 0 1 1 1 1",
+                                     "4 4294967295 4294967295 1 1",
+                                     "4 1 1 1 1 2 2 1 1 1 2 x 7"};
+    for (const auto & text : texts)
+    {
+        input_data_t coordinates;
+        ParseCoordinates(text.data(), text.data() + text.size(), coordinates);
+        InputData parsed = ParseInputData(text.data(), text.data() + text.size());
+        BOOST_CHECK_EQUAL(parsed.GetDataStatus(),
+                          InputData(coordinates).GetDataStatus());
+    }
+}
@@ -0,0 +1,106 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "TG_game_session"
+
+#include <boost/test/unit_test.hpp>
+
+#include <set>
+#include <vector>
+
+#include "game_session.h"
+#include "table.h"
+#include "tests_config.h"
+#include "tg_utils.h"
+
+namespace
+{
+
+//! \brief First moves of the best sequences
+std::vector <Direction> FirstMoves (const std::list <std::vector <Direction> > & moves)
+{
+    std::set <Direction> first;
+    for (const auto & sequence : moves)
+    {
+        first.insert(sequence.front());
+    }
+    return std::vector <Direction> (first.begin(), first.end());
+}
+
+}
+
+BOOST_AUTO_TEST_CASE( follow_hints )
+{
+    InputData in (sample);
+    GameTable table (in);
+    table.CalculateMoves();
+    BOOST_REQUIRE(!table.GetMoves().empty());
+
+    GameSession session (in);
+    BOOST_CHECK(GameSession::State::Playing == session.GetState());
+
+    std::vector <Direction> hints;
+    size_t distance = 0;
+    BOOST_REQUIRE(session.GetHints(hints, distance));
+    BOOST_CHECK_EQUAL(distance, table.GetMoves().front().size());
+    BOOST_CHECK(hints == FirstMoves(table.GetMoves()));
+
+    // every hint brings the win one move closer
+    while (session.GetState() == GameSession::State::Playing)
+    {
+        size_t left = distance;
+        BOOST_REQUIRE(session.GetHints(hints, distance));
+        BOOST_REQUIRE(!hints.empty());
+        BOOST_CHECK(distance == left || session.GetMovesCount() == 0);
+        session.Move(hints.front());
+        --distance;
+    }
+    BOOST_CHECK(GameSession::State::Won == session.GetState());
+    BOOST_CHECK_EQUAL(session.GetMovesCount(), table.GetMoves().front().size());
+    BOOST_CHECK(session.GetBalls().empty());
+}
+
+BOOST_AUTO_TEST_CASE( hints_after_any_move )
+{
+    InputData in (sample);
+
+    for (Direction first : {Direction::North, Direction::West,
+                            Direction::South, Direction::East})
+    {
+        GameSession session (in);
+        std::vector <Direction> hints;
+        size_t distance = 0;
+        session.GetHints(hints, distance);
+
+        if (GameSession::State::Playing != session.Move(first))
+        {
+            continue;
+        }
+
+        // hints are the same as found by search from the new state
+        GameTable table (in);
+        table.CalculateMovesFrom(session.GetBalls());
+        bool can_win = session.GetHints(hints, distance);
+        BOOST_CHECK_EQUAL(can_win, !table.GetMoves().empty());
+        if (can_win)
+        {
+            BOOST_CHECK(hints == FirstMoves(table.GetMoves()));
+            BOOST_CHECK_EQUAL(distance, table.GetMoves().front().size());
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( lost_game )
+{
+    // ball 1 rolls over hole 2 on the way south
+    InputData in (input_data_t {3, 2, 0, 1,1, 3,3, 3,1, 1,3});
+    BOOST_REQUIRE(InputData::Status::Ok == in.GetDataStatus());
+
+    GameSession session (in);
+    BOOST_CHECK(GameSession::State::Lost == session.Move(Direction::South));
+    BOOST_CHECK(GameSession::State::Lost == session.Move(Direction::North));
+    BOOST_CHECK_EQUAL(session.GetMovesCount(), 1u);
+
+    std::vector <Direction> hints;
+    size_t distance = 0;
+    BOOST_CHECK(!session.GetHints(hints, distance));
+    BOOST_CHECK(hints.empty());
+}
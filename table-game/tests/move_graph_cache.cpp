@@ -0,0 +1,92 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "TG_move_graph_cache"
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+
+#include "move_graph_cache.h"
+#include "table.h"
+#include "tg_utils.h"
+#include "tests_config.h"
+#include "test_files.h"
+
+BOOST_AUTO_TEST_CASE( board_key )
+{
+    MoveGraphCache::Key key = MoveGraphCache::MakeKey(InputData(sample));
+    BOOST_CHECK_EQUAL(key.name.size(), 16u);
+
+    // balls, hole ids and walls order do not change the graph
+    InputData other_balls (input_data_t {SAMPLE_TABLE_SIZE, SAMPLE_BALLS_COUNT,
+                                         SAMPLE_WALLS_COUNT,
+                                         3,3, 2,4,
+                                         SAMPLE_HOLE_2, SAMPLE_HOLE_1,
+                                         4,2,3,2, SAMPLE_WALL_1});
+    BOOST_CHECK_EQUAL(key.name, MoveGraphCache::MakeKey(other_balls).name);
+
+    InputData other_wall (input_data_t {SAMPLE_TABLE_SIZE, SAMPLE_BALLS_COUNT,
+                                        SAMPLE_WALLS_COUNT,
+                                        SAMPLE_BALL_1, SAMPLE_BALL_2,
+                                        SAMPLE_HOLE_1, SAMPLE_HOLE_2,
+                                        SAMPLE_WALL_1, 3,3,4,3});
+    BOOST_CHECK(key.name != MoveGraphCache::MakeKey(other_wall).name);
+}
+
+BOOST_AUTO_TEST_CASE( store_and_load )
+{
+    std::string directory (TempDirectory("tg_graph_cache_test"));
+    InputData in (sample);
+
+    GameTable built (in);
+    built.CalculateMoves();
+
+    MoveGraphCache cache (directory);
+    BOOST_REQUIRE(cache.IsOpen());
+    MoveGraphCache::Key key = MoveGraphCache::MakeKey(in);
+
+    MoveGraphCache::graph_t graph;
+    BOOST_CHECK(!cache.Load(key, graph));
+    BOOST_CHECK(cache.Store(key, built.GetMoveGraph()));
+    BOOST_REQUIRE(cache.Load(key, graph));
+    BOOST_CHECK(graph == built.GetMoveGraph());
+    BOOST_CHECK_EQUAL(cache.GetLoads(), 1u);
+
+    // table takes graph from the cache and finds the same moves
+    GameTable cached (in, nullptr, &cache);
+    cached.CalculateMoves();
+    BOOST_CHECK_EQUAL(cache.GetLoads(), 2u);
+    BOOST_CHECK(cached.GetMoveGraph() == built.GetMoveGraph());
+    BOOST_CHECK(cached.GetMoves() == built.GetMoves());
+
+    RemoveDirectory(directory);
+}
+
+BOOST_AUTO_TEST_CASE( validation )
+{
+    std::string directory (TempDirectory("tg_graph_cache_test"));
+    InputData in (sample);
+    MoveGraphCache::Key key = MoveGraphCache::MakeKey(in);
+
+    GameTable built (in);
+    built.CalculateMoves();
+
+    // damaged graph is stored under the key of the board
+    MoveGraphCache::graph_t damaged (built.GetMoveGraph());
+    damaged.begin()->second.AddHole(Direction::North, coordinates_t(1, 1));
+    MoveGraphCache cache (directory, true);
+    BOOST_REQUIRE(cache.Store(key, damaged));
+
+    GameTable validated (in, nullptr, &cache);
+    validated.CalculateMoves();
+    BOOST_CHECK_EQUAL(cache.GetMismatches(), 1u);
+    BOOST_CHECK(validated.GetMoveGraph() == built.GetMoveGraph());
+    BOOST_CHECK(validated.GetMoves() == built.GetMoves());
+
+    // mismatching graph is replaced
+    GameTable again (in, nullptr, &cache);
+    again.CalculateMoves();
+    BOOST_CHECK_EQUAL(cache.GetMismatches(), 1u);
+    BOOST_CHECK_EQUAL(cache.GetLoads(), 2u);
+
+    RemoveDirectory(directory);
+}
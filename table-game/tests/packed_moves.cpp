@@ -0,0 +1,85 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "TG_packed_moves"
+
+#include <boost/test/unit_test.hpp>
+
+#include <sstream>
+
+#include "packed_moves.h"
+#include "table.h"
+#include "tests_config.h"
+#include "tg_utils.h"
+
+BOOST_AUTO_TEST_CASE( pack_and_unpack )
+{
+    std::vector <Direction> moves = {Direction::North, Direction::West,
+                                     Direction::South, Direction::East,
+                                     Direction::East, Direction::North};
+    PackedMoves packed (moves);
+    BOOST_CHECK_EQUAL(packed.GetSize(), moves.size());
+    BOOST_CHECK_EQUAL(packed.GetBytes().size(), 2);
+    BOOST_CHECK(packed.Get(3) == Direction::East);
+    BOOST_CHECK(packed.Unpack() == moves);
+
+    packed.Push(Direction::South);
+    BOOST_CHECK(packed.Get(6) == Direction::South);
+    BOOST_CHECK_EQUAL(packed.GetBytes().size(), 2);
+
+    BOOST_CHECK(PackedMoves().Unpack().empty());
+}
+
+BOOST_AUTO_TEST_CASE( packed_in_arena )
+{
+    Arena arena;
+    Arena::Scope scope (&arena);
+    PackedMoves packed;
+    packed.Push(Direction::West);
+    BOOST_CHECK(packed.GetBytes().get_allocator().GetArena() == &arena);
+    BOOST_CHECK(arena.GetUsed() > 0);
+}
+
+BOOST_AUTO_TEST_CASE( text_and_binary )
+{
+    GameTable table (sample);
+    table.CalculateMoves();
+
+    // formatter writes the same text as the moves stream output did
+    std::ostringstream expected;
+    for (const auto & sequence : table.GetMoves())
+    {
+        for (auto move : sequence)
+        {
+            expected << move << " ";
+        }
+        expected << "\n";
+    }
+    std::string text;
+    FormatMoves(table.GetMoves(), text);
+    BOOST_CHECK_EQUAL(text, expected.str());
+
+    std::ostringstream printed;
+    table.PrintMoves(printed);
+    BOOST_CHECK_EQUAL(printed.str(), expected.str());
+
+    std::stringstream binary;
+    WriteBinaryMoves(binary, table.GetMoves());
+    BOOST_CHECK_EQUAL(binary.str().substr(0, 4), "TGMV");
+
+    moves_list_t read;
+    BOOST_CHECK(ReadBinaryMoves(binary, read));
+    BOOST_CHECK(read == table.GetMoves());
+
+    // truncated input is refused
+    std::string truncated = binary.str();
+    truncated.resize(truncated.size() - 1);
+    std::istringstream short_input (truncated);
+    moves_list_t partial;
+    BOOST_CHECK(!ReadBinaryMoves(short_input, partial));
+    BOOST_CHECK(partial.empty());
+
+    // huge sequence length without the moves behind it is refused
+    std::string huge ("TGMV\x01\x00\x00\x00\xff\xff\xff\xff\x1b", 13);
+    std::istringstream huge_input (huge);
+    BOOST_CHECK(!ReadBinaryMoves(huge_input, partial));
+    BOOST_CHECK(partial.empty());
+}
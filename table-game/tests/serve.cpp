@@ -0,0 +1,38 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "TG_serve"
+
+#include <boost/test/unit_test.hpp>
+
+#include <sstream>
+
+#include "serve.h"
+#include "tests_config.h"
+
+BOOST_AUTO_TEST_CASE( serve_request )
+{
+    std::string response;
+
+    BOOST_CHECK(ServeRequest("a1 4 2 2 2 2 1 4 1 1 4 3 1 2 1 3 3 2 4 2", response));
+    BOOST_CHECK_EQUAL(response, "a1 OK NWE NEW WNE ENW");
+
+    BOOST_CHECK(ServeRequest("7 4 1 0 0 1 2 2", response));
+    BOOST_CHECK_EQUAL(response.substr(0, 6), "7 ERR ");
+
+    BOOST_CHECK(ServeRequest("x 4 2 z", response));
+    BOOST_CHECK_EQUAL(response, "x ERR Request contains non-numeric data.");
+
+    BOOST_CHECK(!ServeRequest("  \r", response));
+    BOOST_CHECK(response.empty());
+}
+
+BOOST_AUTO_TEST_CASE( serve_stream )
+{
+    std::istringstream in ("1 4 2 2 2 2 1 4 1 1 4 3 1 2 1 3 3 2 4 2\n"
+                           "\n"
+                           "2 2 1 2 1 1 2 2 2 2 1 2 2 2 2 1\n");
+    std::ostringstream out;
+
+    Serve(in, out);
+    BOOST_CHECK_EQUAL(out.str(), "1 OK NWE NEW WNE ENW\n"
+                                 "2 NONE\n");
+}
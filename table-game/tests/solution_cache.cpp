@@ -0,0 +1,116 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "TG_solution_cache"
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+
+#include "solution_cache.h"
+#include "table.h"
+#include "tests_config.h"
+#include "test_files.h"
+
+BOOST_AUTO_TEST_CASE( canonical_key )
+{
+    std::string directory (TempDirectory("tg_cache_test"));
+    SolutionCache cache (directory, 10);
+    BOOST_REQUIRE(cache.IsOpen());
+
+    // the same puzzle with swapped ball and hole pairs and reversed walls
+    InputData in (sample);
+    InputData reordered (input_data_t {SAMPLE_TABLE_SIZE, SAMPLE_BALLS_COUNT,
+                                       SAMPLE_WALLS_COUNT,
+                                       SAMPLE_BALL_2, SAMPLE_BALL_1,
+                                       SAMPLE_HOLE_2, SAMPLE_HOLE_1,
+                                       3,2,4,2, 1,3,1,2});
+    // holes are swapped with balls
+    InputData other (input_data_t {SAMPLE_TABLE_SIZE, SAMPLE_BALLS_COUNT,
+                                   SAMPLE_WALLS_COUNT,
+                                   SAMPLE_BALL_1, SAMPLE_BALL_2,
+                                   SAMPLE_HOLE_2, SAMPLE_HOLE_1,
+                                   SAMPLE_WALL_1, SAMPLE_WALL_2});
+
+    SolutionCache::Key key = cache.MakeKey(in);
+    BOOST_CHECK_EQUAL(key.name.size(), 16u);
+    BOOST_CHECK_EQUAL(key.name, cache.MakeKey(reordered).name);
+    BOOST_CHECK(key.name != cache.MakeKey(other).name);
+
+    RemoveDirectory(directory);
+}
+
+BOOST_AUTO_TEST_CASE( store_and_lookup )
+{
+    std::string directory (TempDirectory("tg_cache_test"));
+    SolutionCache::moves_t moves = {{Direction::North, Direction::West},
+                                    {Direction::East}};
+    SolutionCache::Key key;
+    {
+        SolutionCache cache (directory, 10);
+        key = cache.MakeKey(InputData(sample));
+
+        SolutionCache::moves_t found;
+        BOOST_CHECK(!cache.Lookup(key, found));
+        cache.Store(key, moves);
+        BOOST_CHECK(cache.Lookup(key, found));
+        BOOST_CHECK(found == moves);
+        BOOST_CHECK_EQUAL(cache.GetHits(), 1u);
+        BOOST_CHECK_EQUAL(cache.GetMisses(), 1u);
+    }
+
+    // entries survive reopening, collisions are detected
+    SolutionCache cache (directory, 10);
+    BOOST_CHECK_EQUAL(cache.GetSize(), 1u);
+    SolutionCache::moves_t found;
+    BOOST_CHECK(cache.Lookup(key, found));
+    BOOST_CHECK(found == moves);
+
+    SolutionCache::Key collision = key;
+    collision.canonical.back() += 1;
+    BOOST_CHECK(!cache.Lookup(collision, found));
+
+    RemoveDirectory(directory);
+}
+
+BOOST_AUTO_TEST_CASE( lru_eviction )
+{
+    std::string directory (TempDirectory("tg_cache_test"));
+    SolutionCache cache (directory, 2);
+    SolutionCache::moves_t moves = {{Direction::South}};
+    SolutionCache::moves_t found;
+
+    SolutionCache::Key first = cache.MakeKey(InputData(input_data_t {4, 1, 0, 1, 1, 4, 4}));
+    SolutionCache::Key second = cache.MakeKey(InputData(input_data_t {4, 1, 0, 2, 1, 4, 4}));
+    SolutionCache::Key third = cache.MakeKey(InputData(input_data_t {4, 1, 0, 3, 1, 4, 4}));
+
+    cache.Store(first, moves);
+    cache.Store(second, moves);
+    BOOST_CHECK(cache.Lookup(first, found));
+    cache.Store(third, moves);
+
+    // second is least recently used
+    BOOST_CHECK_EQUAL(cache.GetSize(), 2u);
+    BOOST_CHECK(cache.Lookup(first, found));
+    BOOST_CHECK(!cache.Lookup(second, found));
+    BOOST_CHECK(cache.Lookup(third, found));
+
+    RemoveDirectory(directory);
+}
+
+BOOST_AUTO_TEST_CASE( table_uses_cache )
+{
+    std::string directory (TempDirectory("tg_cache_test"));
+    SolutionCache cache (directory, 10);
+    InputData in (sample);
+
+    GameTable solved (in, &cache);
+    solved.CalculateMoves();
+    BOOST_CHECK_EQUAL(cache.GetSize(), 1u);
+
+    GameTable cached (in, &cache);
+    cached.CalculateMoves();
+    BOOST_CHECK_EQUAL(cache.GetHits(), 1u);
+    BOOST_CHECK(cached.GetMoves() == solved.GetMoves());
+    BOOST_CHECK(cached.GetMoveGraph().empty());
+
+    RemoveDirectory(directory);
+}
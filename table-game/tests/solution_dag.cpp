@@ -0,0 +1,84 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "TG_solution_dag"
+
+#include <boost/test/unit_test.hpp>
+
+#include <sstream>
+
+#include "solution_dag.h"
+#include "table.h"
+#include "tests_config.h"
+#include "tg_utils.h"
+
+BOOST_AUTO_TEST_CASE( same_paths_as_search )
+{
+    GameTable table (sample);
+    table.CalculateMoves();
+    BOOST_REQUIRE(!table.GetMoves().empty());
+
+    SolutionDag dag ((InputData(sample)));
+    BOOST_REQUIRE(dag.GetStatus() == SolutionDag::Status::Solved);
+    BOOST_CHECK_EQUAL(dag.GetMovesCount(), table.GetMoves().front().size());
+    BOOST_CHECK_EQUAL(dag.CountPaths(), table.GetMoves().size());
+
+    std::list <std::vector <Direction> > paths;
+    dag.GetPaths(paths);
+    BOOST_CHECK(paths == table.GetMoves());
+
+    // start first, win last, every move goes one step deeper
+    BOOST_CHECK_EQUAL(dag.GetDepths().front(), 0);
+    BOOST_CHECK(dag.GetStates().back().empty());
+    for (const auto & edge : dag.GetEdges())
+    {
+        BOOST_CHECK_EQUAL(dag.GetDepths()[edge.to], dag.GetDepths()[edge.from] + 1);
+    }
+
+    // ball 3 passes the closed hole 2 and stops on its own hole at the wall
+    input_data_t holes_in_row {3, 3, 2, 1, 2, 2, 1, 3, 2, 1, 3, 2, 2, 2, 3,
+                               1, 2, 1, 3, 1, 2, 2, 2};
+    GameTable rows_table ((InputData(holes_in_row)));
+    rows_table.CalculateMoves();
+    BOOST_REQUIRE(!rows_table.GetMoves().empty());
+    SolutionDag rows_dag ((InputData(holes_in_row)));
+    BOOST_REQUIRE(rows_dag.GetStatus() == SolutionDag::Status::Solved);
+    paths.clear();
+    rows_dag.GetPaths(paths);
+    BOOST_CHECK(paths == rows_table.GetMoves());
+}
+
+BOOST_AUTO_TEST_CASE( two_orders )
+{
+    // two balls on an open board: each of them goes to its hole by one move
+    // in any order, both orders pass different states
+    SolutionDag dag (InputData(input_data_t {4, 2, 0, 1, 1, 4, 4, 4, 1, 1, 4}));
+    BOOST_REQUIRE(dag.GetStatus() == SolutionDag::Status::Solved);
+    BOOST_CHECK_EQUAL(dag.GetMovesCount(), 2);
+    BOOST_CHECK_EQUAL(dag.CountPaths(), 2);
+    BOOST_CHECK_EQUAL(dag.GetStates().size(), 4);
+    BOOST_CHECK_EQUAL(dag.GetEdges().size(), 4);
+
+    std::ostringstream os;
+    os << dag;
+    BOOST_CHECK_EQUAL(os.str().find("moves 2 states 4 edges 4 paths 2\n"), 0);
+    BOOST_CHECK(os.str().find("e 0 1 W\n") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE( not_solved )
+{
+    SolutionDag invalid (InputData(input_data_t {4, 1, 0, 0, 1}));
+    BOOST_CHECK(invalid.GetStatus() == SolutionDag::Status::InvalidInput);
+    BOOST_CHECK_EQUAL(invalid.CountPaths(), 0);
+
+    // ball can not leave the corner closed by walls
+    SolutionDag unsolvable (InputData(input_data_t {4, 1, 2, 1, 1, 4, 4,
+                                                    1, 1, 1, 2, 1, 1, 2, 1}));
+    BOOST_CHECK(unsolvable.GetStatus() == SolutionDag::Status::NoSolution);
+    BOOST_CHECK(unsolvable.GetStates().empty());
+
+    SolutionDag limited ((InputData(sample)), 2);
+    BOOST_CHECK(limited.GetStatus() == SolutionDag::Status::LimitReached);
+
+    std::ostringstream os;
+    os << limited;
+    BOOST_CHECK(os.str().empty());
+}
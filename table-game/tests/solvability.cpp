@@ -0,0 +1,164 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "TG_solvability"
+
+#include <boost/test/unit_test.hpp>
+
+#include <sstream>
+
+#include "solvability.h"
+#include "table.h"
+#include "tests_config.h"
+#include "tg_utils.h"
+
+namespace
+{
+
+//! ball 1 in the corner can only roll West over the hole of ball 2, ball 2
+//! can not stop in the column of its hole without ball 1
+const input_data_t waiting {3, 2, 1, 3, 1, 3, 3, 1, 1, 2, 1, 3, 1, 3, 2};
+
+//! ball 1 needs hole 2 closed first, ball 2 can not get there first
+const input_data_t blocked {3, 2, 2, 1, 3, 1, 1, 1, 2, 2, 1,
+                            1, 2, 1, 3, 2, 1, 3, 1};
+
+}
+
+BOOST_AUTO_TEST_CASE( proved_unsolvable )
+{
+    // ball rolls between the corners, its hole is in the middle
+    GameTable alone (InputData(input_data_t {3, 1, 0, 1, 1, 2, 2}));
+    SolvabilityCheck::Result result = alone.CheckSolvability();
+    BOOST_CHECK(result.reason == SolvabilityCheck::Reason::Unreachable);
+    BOOST_CHECK_EQUAL(result.ball, 1);
+
+    GameTable crossing ((InputData(blocked)));
+    result = crossing.CheckSolvability();
+    BOOST_CHECK(result.reason == SolvabilityCheck::Reason::Blocked);
+    BOOST_CHECK_EQUAL(result.ball, 1);
+
+    std::ostringstream os;
+    os << result;
+    BOOST_CHECK_EQUAL(os.str(), "Game can not be won: ball 1 can not reach "
+                                "its hole before holes on its way are closed");
+
+    GameTable cycle ((InputData(waiting)));
+    result = cycle.CheckSolvability();
+    BOOST_CHECK(result.reason == SolvabilityCheck::Reason::Cycle);
+    BOOST_CHECK_EQUAL(result.ball, 1);
+}
+
+BOOST_AUTO_TEST_CASE( solvable_not_proved )
+{
+    GameTable table (sample);
+    BOOST_CHECK(table.CheckSolvability().reason == SolvabilityCheck::Reason::None);
+
+    // both balls get to their holes by one move
+    GameTable both (InputData(input_data_t {4, 2, 0, 1, 1, 4, 4, 4, 1, 1, 4}));
+    SolvabilityCheck::Result result = both.CheckSolvability();
+    BOOST_CHECK(result.reason == SolvabilityCheck::Reason::None);
+    BOOST_CHECK_EQUAL(result.ball, 0);
+}
+
+BOOST_AUTO_TEST_CASE( closed_holes )
+{
+    GameTable table ((InputData(waiting)));
+    table.PrepareMoveGraph();
+    SolvabilityCheck check (table.GetBoard(), table.GetMoveGraph(),
+                            table.GetTableSize());
+
+    // ball 1 crosses hole 2 once ball 2 is in it
+    std::map <coordinates_t, ball_id_t> balls {{coordinates_t(3, 1), 1}};
+    BOOST_CHECK(check.Check(table.MakeState(balls)).reason ==
+                SolvabilityCheck::Reason::None);
+
+    balls.emplace(coordinates_t(3, 3), 2);
+    BOOST_CHECK(check.Check(table.MakeState(balls)).reason ==
+                SolvabilityCheck::Reason::Cycle);
+}
+
+BOOST_AUTO_TEST_CASE( hole_order )
+{
+    GameTable table ((InputData(waiting)));
+    std::vector <std::pair <ball_id_t, ball_id_t> > forced {{1, 2}, {2, 1}};
+    BOOST_CHECK(table.GetForcedOrder() == forced);
+
+    SolvabilityCheck check (table.GetBoard(), table.GetMoveGraph(),
+                            table.GetTableSize());
+    std::map <coordinates_t, ball_id_t> balls {{coordinates_t(3, 1), 1},
+                                               {coordinates_t(3, 3), 2}};
+    Movement start = table.MakeState(balls);
+    SolvabilityCheck::HoleOrder order = check.MakeHoleOrder(start);
+    BOOST_CHECK(check.IsHopeless(order, start));
+
+    // ball 1 waits for nobody once hole 2 is closed
+    balls.erase(coordinates_t(3, 3));
+    Movement closed = table.MakeState(balls);
+    order = check.MakeHoleOrder(closed);
+    BOOST_CHECK(!check.IsHopeless(order, closed));
+    BOOST_CHECK(check.GetForcedOrder(order, closed).empty());
+
+    GameTable blocking ((InputData(blocked)));
+    forced = {{2, 1}};
+    BOOST_CHECK(blocking.GetForcedOrder() == forced);
+
+    GameTable solvable (sample);
+    solvable.PrepareMoveGraph();
+    SolvabilityCheck sample_check (solvable.GetBoard(), solvable.GetMoveGraph(),
+                                   solvable.GetTableSize());
+    std::map <coordinates_t, ball_id_t> sample_balls;
+    for (const auto & ball : solvable.GetBalls())
+    {
+        sample_balls.emplace(ball.first, ball.second.GetId());
+    }
+    Movement sample_start = solvable.MakeState(sample_balls);
+    BOOST_CHECK(!sample_check.IsHopeless(sample_check.MakeHoleOrder(sample_start),
+                                         sample_start));
+}
+
+BOOST_AUTO_TEST_CASE( lower_bound )
+{
+    // ball falls into its hole by one roll to the east
+    GameTable near (InputData(input_data_t {3, 1, 0, 1, 1, 3, 1}));
+    near.PrepareMoveGraph();
+    SolvabilityCheck check (near.GetBoard(), near.GetMoveGraph(),
+                            near.GetTableSize());
+    std::map <coordinates_t, ball_id_t> balls {{coordinates_t(1, 1), 1}};
+    Movement start = near.MakeState(balls);
+    SolvabilityCheck::HoleOrder order = check.MakeHoleOrder(start);
+    BOOST_CHECK_EQUAL(check.GetLowerBound(order, start), 1);
+    BOOST_CHECK_EQUAL(check.GetMovesLeft(order, start), 1);
+    BOOST_CHECK_EQUAL(check.GetLowerBound(order, near.MakeState({})), 0);
+    BOOST_CHECK_EQUAL(check.GetLowerBound(SolvabilityCheck::HoleOrder {0, {}, {}},
+                                          start), 0);
+
+    GameTable solvable (sample);
+    solvable.CalculateMoves();
+    SolvabilityCheck sample_check (solvable.GetBoard(), solvable.GetMoveGraph(),
+                                   solvable.GetTableSize());
+    std::map <coordinates_t, ball_id_t> sample_balls;
+    for (const auto & ball : solvable.GetBalls())
+    {
+        sample_balls.emplace(ball.first, ball.second.GetId());
+    }
+    Movement sample_start = solvable.MakeState(sample_balls);
+    order = sample_check.MakeHoleOrder(sample_start);
+    size_t bound = sample_check.GetLowerBound(order, sample_start);
+    BOOST_CHECK(bound > 0);
+    BOOST_CHECK(bound <= solvable.GetMoves().front().size());
+    BOOST_CHECK(sample_check.GetMovesLeft(order, sample_start) >= bound);
+}
+
+BOOST_AUTO_TEST_CASE( search_skipped )
+{
+    GameTable table ((InputData(blocked)));
+    table.CalculateMoves();
+    BOOST_CHECK(table.GetMoves().empty());
+    BOOST_CHECK(table.GetUnsolvability().reason == SolvabilityCheck::Reason::Blocked);
+    BOOST_CHECK_EQUAL(table.GetPruningStats().revisited, 0);
+    BOOST_CHECK_EQUAL(table.GetPruningStats().hopeless, 0);
+
+    GameTable solvable (sample);
+    solvable.CalculateMoves();
+    BOOST_CHECK(!solvable.GetMoves().empty());
+    BOOST_CHECK(solvable.GetUnsolvability().reason == SolvabilityCheck::Reason::None);
+}
@@ -0,0 +1,102 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "TG_solve_scheduler"
+
+#include <boost/test/unit_test.hpp>
+
+#include <future>
+#include <mutex>
+#include <vector>
+
+#include "solve_scheduler.h"
+#include "solver.h"
+#include "table.h"
+#include "tests_config.h"
+
+namespace
+{
+
+//! \brief One ball one move away from its hole
+const input_data_t short_puzzle = { 4, 1, 0, 1, 1, 1, 2 };
+
+}
+
+BOOST_AUTO_TEST_CASE( step_calculation )
+{
+    InputData in (sample);
+    GameTable expected (in);
+    expected.CalculateMoves();
+
+    GameTable table (in);
+    BOOST_REQUIRE(!table.StartCalculation());
+    size_t steps = 1;
+    while (!table.ContinueCalculation(1))
+    {
+        ++steps;
+    }
+    BOOST_CHECK(steps > expected.GetMoves().front().size());
+    BOOST_CHECK(table.GetMoves() == expected.GetMoves());
+
+    // finished calculation stays finished
+    BOOST_CHECK(table.ContinueCalculation(1));
+    BOOST_CHECK(table.GetMoves() == expected.GetMoves());
+}
+
+BOOST_AUTO_TEST_CASE( scheduled_results )
+{
+    std::vector <input_data_t> puzzles = { sample, short_puzzle, { 4, 2, 0 },
+                                           sample };
+    std::vector <SolveResult> results (puzzles.size());
+
+    SolveScheduler scheduler (2, 3);
+    for (size_t i=0; i<puzzles.size(); ++i)
+    {
+        scheduler.Submit(InputData(puzzles[i]),
+                         [&results, i] (const SolveResult & result)
+                         {
+                             results[i] = result;
+                         });
+    }
+    scheduler.Wait();
+    BOOST_CHECK(scheduler.GetSlicesCount() > puzzles.size());
+
+    for (size_t i=0; i<puzzles.size(); ++i)
+    {
+        SolveResult expected = SolvePuzzle(puzzles[i]);
+        BOOST_CHECK(results[i].status == expected.status);
+        BOOST_CHECK(results[i].moves == expected.moves);
+        BOOST_CHECK_EQUAL(results[i].error, expected.error);
+    }
+}
+
+BOOST_AUTO_TEST_CASE( short_puzzles_first )
+{
+    std::mutex mutex;
+    std::vector <size_t> finished;
+    auto done = [&mutex, &finished] (size_t i)
+    {
+        return [&mutex, &finished, i] (const SolveResult &)
+        {
+            std::lock_guard <std::mutex> lock (mutex);
+            finished.push_back(i);
+        };
+    };
+
+    // the only worker waits until all the puzzles are queued
+    std::promise <void> release;
+    std::shared_future <void> released = release.get_future().share();
+    SolveScheduler scheduler (1, 1);
+    scheduler.Submit(InputData(short_puzzle),
+                     [released] (const SolveResult &) { released.wait(); });
+
+    // long puzzle submitted first does not hold the worker
+    scheduler.Submit(InputData(sample), done(0));
+    for (size_t i=1; i<4; ++i)
+    {
+        scheduler.Submit(InputData(short_puzzle), done(i));
+    }
+    release.set_value();
+    scheduler.Wait();
+
+    BOOST_REQUIRE_EQUAL(finished.size(), 4u);
+    BOOST_CHECK_EQUAL(finished.back(), 0u);
+}
@@ -0,0 +1,218 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "TG_solve_service"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "solve_service.h"
+#include "tests_config.h"
+
+namespace
+{
+
+const std::string sample_request ("4 2 2 2 2 1 4 1 1 4 3 1 2 1 3 3 2 4 2");
+const std::string sample_moves ("OK NWE NEW WNE ENW");
+const std::string unsolvable_request ("2 1 2 1 1 2 2 2 2 1 2 2 2 2 1");
+//! no moves, but only after searching for seconds
+const std::string long_request ("9 6 23 3 2 5 6 3 1 3 9 6 4 2 7 2 6 9 8 9 7 7 "
+                                "7 8 4 7 4 4 6 4 7 1 4 1 5 2 7 2 8 8 5 8 6 6 1 "
+                                "6 2 7 6 7 7 9 8 9 9 6 7 7 7 3 4 4 4 6 5 7 5 6 "
+                                "2 7 2 5 1 6 1 8 4 9 4 1 7 2 7 5 4 6 4 4 1 4 2 "
+                                "3 8 3 9 6 2 6 3 5 8 6 8 3 5 4 5 1 6 2 6 6 3 7 "
+                                "3 4 2 4 3");
+
+std::string SocketPath (const std::string & name)
+{
+    return "/tmp/tg_service_test_" + name + "_" + std::to_string(getpid());
+}
+
+int Connect (const std::string & path)
+{
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::strcpy(address.sun_path, path.c_str());
+    if (connect(fd, reinterpret_cast<struct sockaddr*>(&address),
+                sizeof(address)) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool WriteAll (int fd, const std::string & text)
+{
+    size_t sent = 0;
+    while (sent < text.size())
+    {
+        ssize_t size = write(fd, text.data() + sent, text.size() - sent);
+        if (size <= 0)
+            return false;
+        sent += size;
+    }
+    return true;
+}
+
+//! read lines until server closes connection
+std::vector <std::string> ReadLines (int fd)
+{
+    std::string text;
+    char buffer[4096];
+    ssize_t size;
+    while ((size = read(fd, buffer, sizeof(buffer))) > 0)
+    {
+        text.append(buffer, size);
+    }
+
+    std::vector <std::string> lines;
+    size_t start = 0;
+    size_t end;
+    while ((end = text.find('\n', start)) != std::string::npos)
+    {
+        lines.push_back(text.substr(start, end - start));
+        start = end + 1;
+    }
+    std::sort(lines.begin(), lines.end());
+    return lines;
+}
+
+}
+
+BOOST_AUTO_TEST_CASE( merge_identical )
+{
+    std::string path (SocketPath("merge"));
+    SolveService service (path, 2, 16);
+    BOOST_REQUIRE(service.Start());
+    std::thread loop ([&service] () { service.Run(); });
+
+    int fd = Connect(path);
+    BOOST_REQUIRE(fd >= 0);
+    BOOST_REQUIRE(WriteAll(fd, "a " + sample_request + "\n"
+                 "b " + sample_request + "\n"
+                 "\n"
+                 "c " + unsolvable_request + "\n"
+                 "d 4 1 0 0 1 2 2\n"
+                 "e 4 x\n"
+                 "f " + sample_request));
+    shutdown(fd, SHUT_WR);
+
+    std::vector <std::string> lines = ReadLines(fd);
+    close(fd);
+
+    BOOST_REQUIRE_EQUAL(lines.size(), 6u);
+    BOOST_CHECK_EQUAL(lines[0], "a " + sample_moves);
+    BOOST_CHECK_EQUAL(lines[1], "b " + sample_moves);
+    BOOST_CHECK_EQUAL(lines[2], "c NONE");
+    BOOST_CHECK_EQUAL(lines[3].substr(0, 6), "d ERR ");
+    BOOST_CHECK_EQUAL(lines[4], "e ERR Request contains non-numeric data.");
+    BOOST_CHECK_EQUAL(lines[5], "f " + sample_moves);
+
+    service.Stop();
+    loop.join();
+
+    SolveService::Stats stats = service.GetStats();
+    BOOST_CHECK_EQUAL(stats.requests, 6u);
+    // all the requests were read at once, so "b" and "f" wait for "a"
+    BOOST_CHECK_EQUAL(stats.merged, 2u);
+    BOOST_CHECK_EQUAL(stats.solved, 3u);
+}
+
+BOOST_AUTO_TEST_CASE( backpressure )
+{
+    std::string path (SocketPath("queue"));
+    SolveService service (path, 1, 1);
+    BOOST_REQUIRE(service.Start());
+    std::thread loop ([&service] () { service.Run(); });
+
+    const size_t clients = 4;
+    const size_t requests = 50;
+    std::vector <std::thread> threads;
+    std::vector <size_t> answered (clients, 0);
+
+    for (size_t c=0; c<clients; ++c)
+    {
+        threads.emplace_back([&, c] ()
+        {
+            // no test assertions here: they are not thread safe
+            int fd = Connect(path);
+            if (fd < 0)
+                return;
+            std::string text;
+            for (size_t i=0; i<requests; ++i)
+            {
+                // different puzzles to fill the queue
+                text += std::to_string(c) + "_" + std::to_string(i) + " " +
+                        ((i % 2) ? sample_request : unsolvable_request) + "\n";
+            }
+            if (!WriteAll(fd, text))
+            {
+                close(fd);
+                return;
+            }
+            shutdown(fd, SHUT_WR);
+
+            for (const auto & line : ReadLines(fd))
+            {
+                std::string id = line.substr(0, line.find(' '));
+                size_t i = std::stoul(id.substr(id.find('_') + 1));
+                std::string expected = id + " " +
+                        ((i % 2) ? sample_moves : std::string("NONE"));
+                if (line == expected)
+                    ++answered[c];
+            }
+            close(fd);
+        });
+    }
+
+    for (auto & t : threads)
+    {
+        t.join();
+    }
+    service.Stop();
+    loop.join();
+
+    for (size_t c=0; c<clients; ++c)
+    {
+        BOOST_CHECK_EQUAL(answered[c], requests);
+    }
+    BOOST_CHECK_EQUAL(service.GetStats().requests, clients * requests);
+}
+
+BOOST_AUTO_TEST_CASE( stop_cancels )
+{
+    std::string path (SocketPath("stop"));
+    int fd = -1;
+    std::chrono::steady_clock::time_point stopped;
+    {
+        SolveService service (path, 1, 16);
+        BOOST_REQUIRE(service.Start());
+        std::thread loop ([&service] () { service.Run(); });
+
+        fd = Connect(path);
+        BOOST_REQUIRE(fd >= 0);
+        BOOST_REQUIRE(WriteAll(fd, "a " + long_request + "\n"));
+        // let the worker take the puzzle
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+        service.Stop();
+        loop.join();
+        stopped = std::chrono::steady_clock::now();
+    }
+
+    // puzzle being solved is cancelled, not solved to the end
+    BOOST_CHECK(std::chrono::steady_clock::now() - stopped <
+                std::chrono::seconds(1));
+    close(fd);
+}
@@ -327,3 +327,137 @@ BOOST_AUTO_TEST_CASE( check_table )
     t.CalculateMoves();
     t.CkeckMoveGraph();
 }
+
+BOOST_AUTO_TEST_CASE( verify_moves )
+{
+    GameTable table (sample);
+    table.CalculateMoves();
+    BOOST_REQUIRE(!table.GetMoves().empty());
+    for (const auto & moves : table.GetMoves())
+    {
+        GameTable::Verification verification = table.VerifyMoves(moves);
+        BOOST_CHECK(verification.status == GameTable::Verification::Status::Won);
+        BOOST_CHECK_EQUAL(verification.moves, moves.size());
+    }
+
+    // ball 1 is on the way of hole 2 to the south, ball 2 on the way of
+    // hole 1 to the north; they reach own holes one by one to the east
+    // and to the west. Nothing is done after the game is over
+    GameTable crossed (input_data_t {4, 2, 0, 1, 1, 4, 4, 4, 1, 1, 4});
+    using Status = GameTable::Verification::Status;
+
+    GameTable::Verification lost = crossed.VerifyMoves({Direction::South,
+                                                        Direction::East});
+    BOOST_CHECK(lost.status == Status::Lost);
+    BOOST_CHECK_EQUAL(lost.moves, 1);
+
+    GameTable::Verification incomplete = crossed.VerifyMoves({Direction::East});
+    BOOST_CHECK(incomplete.status == Status::Incomplete);
+    BOOST_CHECK_EQUAL(incomplete.moves, 1);
+
+    GameTable::Verification won = crossed.VerifyMoves({Direction::East,
+                                                       Direction::West,
+                                                       Direction::North});
+    BOOST_CHECK(won.status == Status::Won);
+    BOOST_CHECK_EQUAL(won.moves, 2);
+
+    BOOST_CHECK(crossed.VerifyMoves({}).status == Status::Incomplete);
+}
+
+namespace
+{
+
+//! five balls won by 23 moves, search is large enough for greedy search
+const input_data_t deep {8, 5, 17, 2, 2, 4, 3, 8, 4, 2, 3, 4, 6, 5, 8, 2, 4,
+                         3, 5, 1, 4, 6, 7, 3, 6, 3, 7, 5, 5, 6, 5, 6, 5, 6, 6,
+                         7, 3, 7, 4, 3, 2, 3, 3, 1, 7, 1, 8, 3, 2, 4, 2, 6, 8,
+                         7, 8, 5, 5, 5, 6, 6, 7, 7, 7, 6, 6, 6, 7, 1, 2, 2, 2,
+                         3, 6, 4, 6, 7, 6, 8, 6, 6, 4, 7, 4, 2, 7, 3, 7, 5, 4,
+                         6, 4};
+
+}
+
+//! \brief Table expanding single states of the search
+class ExpandTable : public GameTable
+{
+public:
+    explicit ExpandTable (const InputData & in) : GameTable(in)
+    {
+        PrepareMoveGraph();
+        PrepareSolvabilityCheck();
+    }
+
+    //! \brief Expand Make all rolls from \a state, states of \a visited
+    //! are dropped
+    //! \return number of new states
+    size_t Expand (const Movement & state,
+                   const std::unordered_set <zobrist_key_t> & visited)
+    {
+        Arena arena (4096);
+        Arena::Scope scope (&arena);
+        move_layer_t layer;
+        ExpandMoves(move_path_t(state), visited,
+                    SolvabilityCheck::HoleOrder{0, {}, {}},
+                    std::numeric_limits <size_t>::max(), layer);
+        return layer.size();
+    }
+};
+
+BOOST_AUTO_TEST_CASE( child_keys )
+{
+    // ball 1 passes the closed hole 2 and stops on its own hole at the
+    // wall, the move graph has no hole on that way
+    ExpandTable table ((InputData({3, 2, 0, 1, 1, 3, 3, 2, 3, 2, 2})));
+    Movement state = table.MakeState({{coordinates_t(2, 1), 1}});
+    std::unordered_set <zobrist_key_t> visited;
+    BOOST_CHECK_EQUAL(table.Expand(state, visited), 3);
+
+    // key of the won state matches the state the roll builds
+    visited.insert(table.MakeState({}).GetKey());
+    BOOST_CHECK_EQUAL(table.Expand(state, visited), 2);
+    BOOST_CHECK_EQUAL(table.GetPruningStats().revisited, 1);
+}
+
+BOOST_AUTO_TEST_CASE( pruning_stats )
+{
+    GameTable table (sample);
+    const GameTable::PruningStats & pruning = table.GetPruningStats();
+    BOOST_CHECK_EQUAL(pruning.repeated + pruning.null_moves +
+                      pruning.reversed + pruning.revisited, 0);
+
+    table.CalculateMoves();
+    BOOST_CHECK(!table.GetMoves().empty());
+    BOOST_CHECK(pruning.repeated > 0);
+    BOOST_CHECK(pruning.null_moves > 0);
+    BOOST_CHECK(pruning.reversed > 0);
+    BOOST_CHECK(pruning.revisited > 0);
+
+    // counters belong to the last search
+    GameTable::PruningStats first = pruning;
+    table.CalculateMoves();
+    BOOST_CHECK_EQUAL(pruning.repeated, first.repeated);
+    BOOST_CHECK_EQUAL(pruning.revisited, first.revisited);
+}
+
+BOOST_AUTO_TEST_CASE( upper_bound )
+{
+    // search of the sample is over before greedy search is made
+    GameTable small (sample);
+    small.CalculateMoves();
+    BOOST_CHECK_EQUAL(small.GetUpperBound(), std::numeric_limits <size_t>::max());
+
+    GameTable table ((InputData(deep)));
+    table.CalculateMoves();
+    BOOST_REQUIRE(!table.GetMoves().empty());
+    BOOST_CHECK_EQUAL(table.GetMoves().front().size(), 23);
+    BOOST_CHECK(table.GetUpperBound() >= table.GetMoves().front().size());
+    BOOST_CHECK(table.GetUpperBound() != std::numeric_limits <size_t>::max());
+    BOOST_CHECK(table.GetPruningStats().bounded > 0);
+
+    // bound prunes nothing the best moves go through
+    for (const auto & moves : table.GetMoves())
+    {
+        BOOST_CHECK(table.VerifyMoves(moves).status ==
+                    GameTable::Verification::Status::Won);
+    }
+}
@@ -0,0 +1,139 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "TG_tablebase"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <string>
+
+#include "tablebase.h"
+#include "table.h"
+#include "tests_config.h"
+#include "test_files.h"
+#include "tg_utils.h"
+
+namespace
+{
+
+//! \brief Table answering only from tablebase
+class TablebaseTable : public GameTable
+{
+public:
+    TablebaseTable (const InputData & in, const Tablebase & tablebase)
+        : GameTable(in)
+    {
+        SetTablebase(&tablebase);
+        PrepareMoveGraph();
+    }
+
+    bool Answer ()
+    {
+        return FindTablebaseMoves(GetStartPoint());
+    }
+};
+
+}
+
+BOOST_AUTO_TEST_CASE( state_index )
+{
+    const coordinate_t size = 4;
+    const std::uint64_t radix = size * size + 1;
+    std::uint64_t index = 0;
+
+    // all balls in their holes
+    std::map <coordinates_t, ball_id_t> balls;
+    BOOST_REQUIRE(Tablebase::GetIndex(balls, size, 2, index));
+    BOOST_CHECK_EQUAL(index, radix * radix - 1);
+
+    balls[coordinates_t(1,1)] = 1;
+    balls[coordinates_t(2,3)] = 2;
+    BOOST_REQUIRE(Tablebase::GetIndex(balls, size, 2, index));
+    BOOST_CHECK_EQUAL(index, 0 + (1 * size + 2) * radix);
+
+    balls[coordinates_t(5,1)] = 1;
+    BOOST_CHECK(!Tablebase::GetIndex(balls, size, 2, index));
+}
+
+BOOST_AUTO_TEST_CASE( build_and_open )
+{
+    std::string filename (TempFile("tg_tablebase"));
+    InputData in (sample);
+    BOOST_REQUIRE(Tablebase::Build(in, filename));
+
+    // too many states
+    BOOST_CHECK(!Tablebase::Build(in, filename + ".small", 100));
+
+    Tablebase tablebase (filename);
+    BOOST_REQUIRE(Tablebase::Status::Ok == tablebase.GetStatus());
+    BOOST_CHECK_EQUAL(tablebase.GetStatesCount(), 17u * 17u);
+    BOOST_CHECK(tablebase.Matches(in));
+    BOOST_CHECK(!tablebase.Matches(InputData(input_data_t {
+        SAMPLE_TABLE_SIZE, SAMPLE_BALLS_COUNT, SAMPLE_WALLS_COUNT,
+        SAMPLE_BALL_1, SAMPLE_BALL_2, SAMPLE_HOLE_2, SAMPLE_HOLE_1,
+        SAMPLE_WALL_1, SAMPLE_WALL_2})));
+
+    GameTable table (in);
+    table.CalculateMoves();
+    BOOST_REQUIRE(!table.GetMoves().empty());
+
+    std::map <coordinates_t, ball_id_t> start;
+    start[coordinates_t(SAMPLE_BALL_1)] = 1;
+    start[coordinates_t(SAMPLE_BALL_2)] = 2;
+    Tablebase::Entry entry;
+    BOOST_REQUIRE(tablebase.Find(start, entry));
+    BOOST_CHECK_EQUAL(entry.distance, table.GetMoves().front().size());
+
+    BOOST_CHECK(Tablebase::Status::CannotOpen ==
+                Tablebase(filename + ".missing").GetStatus());
+
+    // cut the file in the middle of records
+    std::string truncated = filename + ".truncated";
+    {
+        std::ifstream source (filename, std::ios_base::binary);
+        std::string contents ((std::istreambuf_iterator <char> (source)),
+                              std::istreambuf_iterator <char> ());
+        std::ofstream target (truncated, std::ios_base::binary);
+        target.write(contents.data(), contents.size() / 2);
+    }
+    BOOST_CHECK(Tablebase::Status::Truncated == Tablebase(truncated).GetStatus());
+    BOOST_CHECK(Tablebase::Status::InvalidHeader == Tablebase(SAMPLE_FILE).GetStatus());
+
+    std::remove(truncated.c_str());
+    std::remove(filename.c_str());
+}
+
+BOOST_AUTO_TEST_CASE( answers_from_tablebase )
+{
+    std::string filename (TempFile("tg_tablebase"));
+    BOOST_REQUIRE(Tablebase::Build(InputData(sample), filename));
+    Tablebase tablebase (filename);
+    BOOST_REQUIRE(Tablebase::Status::Ok == tablebase.GetStatus());
+
+    // every start of the board is answered the same way search does
+    for (coordinate_t x=1; x<=SAMPLE_TABLE_SIZE; ++x)
+    {
+        for (coordinate_t y=1; y<=SAMPLE_TABLE_SIZE; ++y)
+        {
+            InputData in (input_data_t {SAMPLE_TABLE_SIZE, SAMPLE_BALLS_COUNT,
+                                        SAMPLE_WALLS_COUNT,
+                                        x, y, 2, 4,
+                                        SAMPLE_HOLE_1, SAMPLE_HOLE_2,
+                                        SAMPLE_WALL_1, SAMPLE_WALL_2});
+            if (InputData::Status::Ok != in.GetDataStatus())
+            {
+                continue;
+            }
+
+            GameTable searched (in);
+            searched.CalculateMoves();
+
+            TablebaseTable answered (in, tablebase);
+            BOOST_CHECK(answered.Answer());
+            BOOST_CHECK(answered.GetMoves() == searched.GetMoves());
+        }
+    }
+
+    std::remove(filename.c_str());
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2017, Ivan
+ * 
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of ofp-pfe nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TG_TEST_FILES_H
+#define TG_TEST_FILES_H
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+
+// Temporary files and directories for tests writing to disk
+
+//!
+//! \brief TempFile Create new empty file in /tmp
+//! \param prefix beginning of the file name
+//! \return path of the file
+//!
+inline std::string TempFile (const std::string & prefix)
+{
+    std::string name = "/tmp/" + prefix + "_XXXXXX";
+    int fd = mkstemp(&name[0]);
+    BOOST_REQUIRE(fd >= 0);
+    close(fd);
+    return name;
+}
+
+//!
+//! \brief TempDirectory Create new empty directory in /tmp
+//! \param prefix beginning of the directory name
+//! \return path of the directory
+//!
+inline std::string TempDirectory (const std::string & prefix)
+{
+    std::string name = "/tmp/" + prefix + "_XXXXXX";
+    BOOST_REQUIRE(mkdtemp(&name[0]) != NULL);
+    return name;
+}
+
+//!
+//! \brief RemoveDirectory Remove the directory with all its contents
+//! \param name path of the directory
+//!
+inline void RemoveDirectory (const std::string & name)
+{
+    std::string command = "rm -rf " + name;
+    BOOST_CHECK_EQUAL(std::system(command.c_str()), 0);
+}
+
+#endif // TG_TEST_FILES_H
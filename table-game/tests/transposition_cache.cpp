@@ -0,0 +1,146 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "TG_transposition_cache"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdio>
+#include <string>
+
+#include "transposition_cache.h"
+#include "table.h"
+#include "tests_config.h"
+#include "test_files.h"
+
+namespace
+{
+
+//! \brief Puzzle of the sample board with balls at given cells
+InputData SampleBoard (coordinate_t x1, coordinate_t y1,
+                       coordinate_t x2, coordinate_t y2)
+{
+    return InputData(input_data_t {SAMPLE_TABLE_SIZE, SAMPLE_BALLS_COUNT,
+                                   SAMPLE_WALLS_COUNT,
+                                   x1, y1, x2, y2,
+                                   SAMPLE_HOLE_1, SAMPLE_HOLE_2,
+                                   SAMPLE_WALL_1, SAMPLE_WALL_2});
+}
+
+std::list <std::vector <Direction> > Solve (const InputData & in,
+                                            TranspositionCache * cache)
+{
+    GameTable table (in);
+    table.SetTranspositionCache(cache);
+    table.CalculateMoves();
+    return table.GetMoves();
+}
+
+}
+
+BOOST_AUTO_TEST_CASE( board_match )
+{
+    TranspositionCache cache ((InputData(sample)));
+
+    // balls do not matter, walls order does not matter
+    BOOST_CHECK(cache.Matches(SampleBoard(3, 3, 2, 4)));
+    BOOST_CHECK(cache.Matches(InputData(input_data_t {
+        SAMPLE_TABLE_SIZE, SAMPLE_BALLS_COUNT, SAMPLE_WALLS_COUNT,
+        SAMPLE_BALL_1, SAMPLE_BALL_2, SAMPLE_HOLE_1, SAMPLE_HOLE_2,
+        4,2,3,2, SAMPLE_WALL_1})));
+
+    // holes are swapped
+    BOOST_CHECK(!cache.Matches(InputData(input_data_t {
+        SAMPLE_TABLE_SIZE, SAMPLE_BALLS_COUNT, SAMPLE_WALLS_COUNT,
+        SAMPLE_BALL_1, SAMPLE_BALL_2, SAMPLE_HOLE_2, SAMPLE_HOLE_1,
+        SAMPLE_WALL_1, SAMPLE_WALL_2})));
+}
+
+BOOST_AUTO_TEST_CASE( add_and_find )
+{
+    TranspositionCache cache ((InputData(sample)));
+    TranspositionCache::Entry entry;
+    BOOST_CHECK(!cache.Find(1, entry));
+
+    cache.Add(1, 3, Direction::North);
+    cache.Add(1, 3, Direction::East);
+    BOOST_REQUIRE(cache.Find(1, entry));
+    BOOST_CHECK_EQUAL(entry.distance, 3);
+    BOOST_CHECK_EQUAL(entry.moves, (1 << static_cast <unsigned> (Direction::North)) |
+                                   (1 << static_cast <unsigned> (Direction::East)));
+
+    // other distance replaces the moves
+    cache.Add(1, 2, Direction::West);
+    BOOST_REQUIRE(cache.Find(1, entry));
+    BOOST_CHECK_EQUAL(entry.distance, 2);
+    BOOST_CHECK_EQUAL(entry.moves, 1 << static_cast <unsigned> (Direction::West));
+
+    cache.AddUnsolvable(2);
+    BOOST_REQUIRE(cache.Find(2, entry));
+    BOOST_CHECK_EQUAL(entry.distance, TranspositionCache::UNSOLVABLE);
+    BOOST_CHECK_EQUAL(cache.GetSize(), 2u);
+}
+
+BOOST_AUTO_TEST_CASE( save_and_load )
+{
+    std::string filename (TempFile("tg_transpositions"));
+    {
+        TranspositionCache cache ((InputData(sample)));
+        cache.Add(10, 1, Direction::South);
+        cache.AddUnsolvable(20);
+        BOOST_CHECK(cache.Save(filename));
+    }
+
+    TranspositionCache cache ((InputData(sample)));
+    BOOST_REQUIRE(cache.Load(filename));
+    BOOST_CHECK_EQUAL(cache.GetSize(), 2u);
+
+    TranspositionCache::Entry entry;
+    BOOST_REQUIRE(cache.Find(10, entry));
+    BOOST_CHECK_EQUAL(entry.distance, 1);
+    BOOST_REQUIRE(cache.Find(20, entry));
+    BOOST_CHECK_EQUAL(entry.distance, TranspositionCache::UNSOLVABLE);
+    BOOST_CHECK(!cache.Find(15, entry));
+
+    // added entries take precedence over mapped ones and are saved with them
+    cache.Add(10, 2, Direction::North);
+    cache.Add(30, 1, Direction::West);
+    BOOST_CHECK(cache.Save(filename));
+    BOOST_REQUIRE(cache.Load(filename));
+    BOOST_REQUIRE(cache.Find(10, entry));
+    BOOST_CHECK_EQUAL(entry.distance, 2);
+
+    // file of another board is not loaded
+    TranspositionCache other ((InputData(input_data_t {5, 1, 0, 1,1, 5,5})));
+    BOOST_CHECK(!other.Load(filename));
+    BOOST_CHECK(!other.Load(filename + ".missing"));
+
+    std::remove(filename.c_str());
+}
+
+BOOST_AUTO_TEST_CASE( table_reuses_states )
+{
+    InputData in (sample);
+    TranspositionCache cache (in);
+
+    auto expected = Solve(in, nullptr);
+    BOOST_CHECK(Solve(in, &cache) == expected);
+    size_t learned = cache.GetSize();
+    BOOST_CHECK(learned > 0);
+
+    // known start state gives the same moves
+    BOOST_CHECK(Solve(in, &cache) == expected);
+    BOOST_CHECK_EQUAL(cache.GetSize(), learned);
+
+    // other puzzles of the board meet known states
+    for (coordinate_t x=1; x<=SAMPLE_TABLE_SIZE; ++x)
+    {
+        for (coordinate_t y=1; y<=SAMPLE_TABLE_SIZE; ++y)
+        {
+            InputData other = SampleBoard(x, y, 2, 4);
+            if (InputData::Status::Ok != other.GetDataStatus())
+            {
+                continue;
+            }
+            BOOST_CHECK(Solve(other, &cache) == Solve(other, nullptr));
+        }
+    }
+}
@@ -173,6 +173,38 @@ BOOST_AUTO_TEST_CASE( duplicates )
     std::vector <int> v_dup = {1, 1, 3, 4, 5, 6, 7, 8, 9};
 
     BOOST_CHECK_EQUAL(HasDuplicates(v_dup), true);
+
+    std::vector <int> v_empty;
+
+    BOOST_CHECK_EQUAL(HasDuplicates(v_empty), false);
+}
+
+BOOST_AUTO_TEST_CASE( walls_duplicates )
+{
+    std::vector <wall_coordinates_t> w_no_dup = { wall_coordinates_t(3, 2, 4, 2),
+                                                  wall_coordinates_t(3, 2, 3, 3),
+                                                  wall_coordinates_t(1, 1, 1, 2) };
+
+    BOOST_CHECK_EQUAL(HasDuplicates(w_no_dup), false);
+
+    // the same wall given from another side
+    std::vector <wall_coordinates_t> w_dup = { wall_coordinates_t(3, 2, 4, 2),
+                                               wall_coordinates_t(3, 2, 3, 3),
+                                               wall_coordinates_t(4, 2, 3, 2) };
+
+    BOOST_CHECK_EQUAL(HasDuplicates(w_dup), true);
+}
+
+BOOST_AUTO_TEST_CASE( common_items )
+{
+    std::vector <coordinates_t> balls = { coordinates_t(1, 1), coordinates_t(3, 2) };
+    std::vector <coordinates_t> holes = { coordinates_t(2, 3), coordinates_t(1, 2) };
+
+    BOOST_CHECK_EQUAL(HasCommonItems(balls, holes), false);
+
+    holes.push_back(coordinates_t(3, 2));
+
+    BOOST_CHECK_EQUAL(HasCommonItems(balls, holes), true);
 }
 
 BOOST_AUTO_TEST_CASE( get_neigbour )
@@ -0,0 +1,56 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "TG_zobrist"
+
+#include <boost/test/unit_test.hpp>
+
+#include "zobrist.h"
+#include "movement.h"
+#include "tg_utils.h"
+#include "tests_config.h"
+
+BOOST_AUTO_TEST_CASE( stable_keys )
+{
+    ZobristTable one (SAMPLE_TABLE_SIZE, SAMPLE_BALLS_COUNT);
+    ZobristTable two (SAMPLE_TABLE_SIZE, SAMPLE_BALLS_COUNT);
+
+    BOOST_CHECK_EQUAL(one.BallKey(1, coordinates_t(SAMPLE_BALL_1)),
+                      two.BallKey(1, coordinates_t(SAMPLE_BALL_1)));
+    BOOST_CHECK_EQUAL(one.HoleKey(2), two.HoleKey(2));
+
+    BOOST_CHECK(one.BallKey(1, coordinates_t(SAMPLE_BALL_1)) !=
+                one.BallKey(2, coordinates_t(SAMPLE_BALL_1)));
+    BOOST_CHECK(one.BallKey(1, coordinates_t(SAMPLE_BALL_1)) !=
+                one.BallKey(1, coordinates_t(SAMPLE_BALL_2)));
+    BOOST_CHECK(one.HoleKey(1) != one.HoleKey(2));
+}
+
+BOOST_AUTO_TEST_CASE( incremental_update )
+{
+    ZobristTable zobrist (SAMPLE_TABLE_SIZE, SAMPLE_BALLS_COUNT);
+
+    std::map <coordinates_t, ball_id_t> balls = { {coordinates_t(SAMPLE_BALL_1), 1},
+                                                  {coordinates_t(SAMPLE_BALL_2), 2} };
+    std::map <coordinates_t, ball_id_t> holes = { {coordinates_t(SAMPLE_HOLE_1), 1},
+                                                  {coordinates_t(SAMPLE_HOLE_2), 2} };
+
+    Movement start (balls, holes, zobrist);
+    BOOST_CHECK_EQUAL(start.GetKey(), zobrist.StateKey(balls, holes));
+
+    // move first ball north and second one into its hole
+    Movement move (Direction::North, start);
+    BOOST_CHECK_EQUAL(move.SetBallPosition(1, coordinates_t(2,1),
+                                           coordinates_t(SAMPLE_BALL_1)), true);
+    BOOST_CHECK_EQUAL(move.SetBallPosition(2, coordinates_t(SAMPLE_HOLE_2),
+                                           coordinates_t(SAMPLE_BALL_2)), true);
+
+    BOOST_CHECK_EQUAL(move.GetKey(),
+                      zobrist.StateKey(move.GetBallsPositions(), move.GetHoles()));
+
+    // moving ball back gives the same state except closed hole
+    Movement back (Direction::South, move);
+    BOOST_CHECK_EQUAL(back.SetBallPosition(1, coordinates_t(SAMPLE_BALL_1),
+                                           coordinates_t(2,1)), true);
+    BOOST_CHECK_EQUAL(back.GetKey(),
+                      start.GetKey() ^ zobrist.BallKey(2, coordinates_t(SAMPLE_BALL_2))
+                                     ^ zobrist.HoleKey(2));
+}